@@ -87,6 +87,9 @@ uniform bool uTerrainHasMaskTex = false;
 uniform sampler2D uTerrainMaskTex;
 uniform vec2 uTerrainMaskOrigin;
 uniform vec2 uTerrainMaskInvSize;
+uniform bool uTerrainHasNormalTex = false;
+uniform sampler2D uTerrainNormalTex;
+uniform float uTerrainCurvatureStrength = 0.0;
 uniform float uTerrainMaskFeatherMeters = 42.0;
 uniform float uTerrainMaskJitterMeters = 18.0;
 uniform float uTerrainMaskEdgeNoise = 0.35;
@@ -183,13 +186,28 @@ void sampleMaskWeights(vec3 vtxColor, vec2 worldPos,
     }
 }
 
+// Baked per-tile normal (xyz) and signed curvature (w, > 0 in hollows): the
+// height Laplacian times 2 m, so w = 1 at 0.5/m whatever the tile's level or
+// texel size. Stored in the same tile frame as the mask.
+vec4 sampleBakedNormal(vec2 worldPos) {
+    vec2 uv = (worldPos - uTerrainMaskOrigin) * uTerrainMaskInvSize;
+    vec4 texel = texture(uTerrainNormalTex, uv);
+    return vec4(normalize(texel.rgb * 2.0 - 1.0), texel.a * 2.0 - 1.0);
+}
+
 void main() {
     vec3 normal = normalize(vNormal);
+    float occlusion = 1.0;
+    if (uTerrainHasNormalTex) {
+        vec4 baked = sampleBakedNormal(vWorldPos.xz);
+        normal = baked.xyz;
+        occlusion = 1.0 - uTerrainCurvatureStrength * clamp(baked.w, 0.0, 1.0);
+    }
     float roughMix = 0.5;
     float slope = 1.0 - dot(normal, vec3(0.0, 1.0, 0.0));
     vec3 lightDir = normalize(uLightDir);
     float diffuse = max(dot(normal, lightDir), 0.0);
-    vec3 lighting = uAmbientColor + uLightColor * diffuse;
+    vec3 lighting = (uAmbientColor + uLightColor * diffuse) * occlusion;
     vec3 baseColor = uUseUniformColor ? uColor : vColor;
     float wWater = 0.0;
     float wUrban = 0.0;
@@ -1,18 +1,40 @@
 #include "aircraft/aircraft.hpp"
 #include "input/input.hpp"
 #include <algorithm>
+#include <iostream>
 
 namespace nuage {
 
-void Aircraft::init(AssetStore& assets, Atmosphere& atmosphere) {
-    m_assets = &assets;
+void Aircraft::init(AssetStore* assets, Atmosphere& atmosphere) {
+    m_assets = assets;
     m_atmosphere = &atmosphere;
 }
 
+void Aircraft::setWorkerThreads(int threads) {
+    m_workers.start(threads);
+    if (m_workers.threads() > 1) {
+        std::cout << "[aircraft] stepping instances on " << m_workers.threads() << " threads" << std::endl;
+    }
+}
+
 void Aircraft::fixedUpdate(float dt) {
+    if (m_workers.threads() <= 1) {
+        for (auto& ac : m_instances) {
+            ac->update(dt);
+        }
+        return;
+    }
+    // A first update loads the JSBSim model, reading files and JSBSim's
+    // process-wide settings, so new instances take it here one at a time.
+    m_stepping.clear();
     for (auto& ac : m_instances) {
-        ac->update(dt);
+        if (ac->stepped()) {
+            m_stepping.push_back(ac.get());
+        } else {
+            ac->update(dt);
+        }
     }
+    m_workers.run(m_stepping.size(), [this, dt](size_t i) { m_stepping[i]->update(dt); });
 }
 
 void Aircraft::applyGroundCollision(const TerrainRenderer& terrain) {
@@ -21,6 +43,18 @@ void Aircraft::applyGroundCollision(const TerrainRenderer& terrain) {
     }
 }
 
+void Aircraft::publishFrames(double tickTime) {
+    for (auto& ac : m_instances) {
+        ac->publishFrame(tickTime);
+    }
+}
+
+void Aircraft::acquireFrames() {
+    for (auto& ac : m_instances) {
+        ac->acquireFrame();
+    }
+}
+
 void Aircraft::render(const Mat4& viewProjection, float alpha, const Vec3& lightDir) {
     for (auto& ac : m_instances) {
         ac->render(viewProjection, alpha, lightDir);
@@ -28,20 +62,31 @@ void Aircraft::render(const Mat4& viewProjection, float alpha, const Vec3& light
 }
 
 void Aircraft::shutdown() {
+    m_workers.stop();
     destroyAll();
 }
 
 Aircraft::Instance* Aircraft::spawnPlayer(const std::string& configPath,
                                           const GeoOrigin* terrainOrigin,
                                           const TerrainRenderer* terrain) {
-    if (!m_assets || !m_atmosphere) return nullptr;
+    Instance* aircraft = spawn(configPath, terrainOrigin, terrain);
+    if (aircraft) {
+        m_player = aircraft;
+    }
+    return aircraft;
+}
+
+Aircraft::Instance* Aircraft::spawn(const std::string& configPath,
+                                    const GeoOrigin* terrainOrigin,
+                                    const TerrainRenderer* terrain) {
+    if (!m_atmosphere) return nullptr;
 
     auto aircraft = std::make_unique<Aircraft::Instance>();
-    aircraft->init(configPath, *m_assets, *m_atmosphere, terrainOrigin, terrain);
-    
-    m_player = aircraft.get();
+    aircraft->init(configPath, m_assets, *m_atmosphere, terrainOrigin, terrain);
+
+    Instance* ptr = aircraft.get();
     m_instances.push_back(std::move(aircraft));
-    return m_player;
+    return ptr;
 }
 
 void Aircraft::destroy(Instance* aircraft) {
@@ -9,6 +9,8 @@
 #include "math/vec3.hpp"
 #include "math/quat.hpp"
 #include "math/mat4.hpp"
+#include "utils/triple_buffer.hpp"
+#include "utils/worker_pool.hpp"
 #include <vector>
 #include <memory>
 #include <string>
@@ -28,14 +30,28 @@ class Aircraft {
 public:
     class Instance {
     public:
-        void init(const std::string& configPath, AssetStore& assets, Atmosphere& atmosphere,
+        // Without assets the instance flies but has no visual (headless runs).
+        void init(const std::string& configPath, AssetStore* assets, Atmosphere& atmosphere,
                   const GeoOrigin* terrainOrigin, const TerrainRenderer* terrain);
         void update(float dt);
+        // False until the first update, which sets up the flight model.
+        bool stepped() const { return m_stepped; }
         void render(const Mat4& viewProjection, float alpha, const Vec3& lightDir);
         void applyGroundCollision(const TerrainRenderer& terrain);
+        // Reads flight controls straight from source (player input on the
+        // global bus by default, or an AI or network peer's bus).
+        void bindControls(PropertyBus& source);
 
         PropertyBus& state() { return m_state; }
         const PropertyBus& state() const { return m_state; }
+        const AircraftState& currentState() const { return m_currentState; }
+
+        // Physics side: hands this tick's states to the renderer.
+        void publishFrame(double tickTime);
+        // Render side: picks up the newest published frame. The interpolated
+        // getters read the frame acquired last.
+        const AircraftStateFrame& acquireFrame() { return m_frames.acquire(); }
+        const AircraftStateFrame& frame() const { return m_frames.front(); }
 
         // Interpolated getters for rendering
         Vec3 interpolatedPosition(float alpha) const;
@@ -64,24 +80,41 @@ public:
         PropertyContext m_properties;
         AircraftState m_currentState;
         AircraftState m_prevState;
+        TripleBuffer<AircraftStateFrame> m_frames;
         std::vector<Vec3> m_groundContactPoints;
         float m_groundPadding = 0.05f;
+        bool m_stepped = false;
         
         std::vector<std::unique_ptr<AircraftComponent>> m_systems;
         AircraftVisual m_visual;
     };
 
-    void init(AssetStore& assets, Atmosphere& atmosphere);
+    void init(AssetStore* assets, Atmosphere& atmosphere);
+    // Spreads fixedUpdate() over threads (counting the caller; 0 = one per
+    // hardware thread). Instances then sample terrain concurrently, so the
+    // terrain must be on its deferred physics tile path.
+    void setWorkerThreads(int threads);
+    int workerThreads() const { return m_workers.threads(); }
+    // Steps every instance and returns once all have finished. Instances do
+    // not affect each other, so with terrain on the deferred path the result
+    // is the same for any thread count.
     void fixedUpdate(float dt);
     void applyGroundCollision(const TerrainRenderer& terrain);
+    void publishFrames(double tickTime);
+    void acquireFrames();
     void render(const Mat4& viewProjection, float alpha, const Vec3& lightDir);
     void shutdown();
 
     Instance* spawnPlayer(const std::string& configPath,
                           const GeoOrigin* terrainOrigin = nullptr,
                           const TerrainRenderer* terrain = nullptr);
+    // Adds an aircraft that is not the player, e.g. traffic.
+    Instance* spawn(const std::string& configPath,
+                    const GeoOrigin* terrainOrigin = nullptr,
+                    const TerrainRenderer* terrain = nullptr);
 
     Instance* player() { return m_player; }
+    const Instance* player() const { return m_player; }
     const std::vector<std::unique_ptr<Instance>>& all() const { return m_instances; }
 
     void destroy(Instance* aircraft);
@@ -92,6 +125,9 @@ private:
     Atmosphere* m_atmosphere = nullptr;
     std::vector<std::unique_ptr<Instance>> m_instances;
     Instance* m_player = nullptr;
+    WorkerPool m_workers;
+    // Instances stepped on the workers this tick.
+    std::vector<Instance*> m_stepping;
 };
 
 }
@@ -29,6 +29,8 @@ namespace ConfigKeys {
     inline constexpr char AIRSPEED[] = "airspeed";
     inline constexpr char HEADING_DEG[] = "headingDeg";
     inline constexpr char SNAP_TO_TERRAIN[] = "snapToTerrain";
+    inline constexpr char AIRPORT[] = "airport";
+    inline constexpr char RUNWAY_OFFSET[] = "runwayOffsetMeters";
 
 } // namespace ConfigKeys
 } // namespace nuage
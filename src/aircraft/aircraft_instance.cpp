@@ -10,16 +10,65 @@
 #include "math/mat4.hpp"
 #include "math/geo.hpp"
 #include "graphics/renderers/terrain_renderer.hpp"
+#include "utils/airport_db.hpp"
 #include "utils/config_loader.hpp"
 #include "aircraft/aircraft_config_keys.hpp"
 
 #include "aircraft/systems/physics/jsbsim_system.hpp"
 #include "aircraft/systems/environment/environment_system.hpp"
+#include <cmath>
 #include <iostream>
 
 namespace nuage {
 
-void Aircraft::Instance::init(const std::string& configPath, AssetStore& assets, Atmosphere& atmosphere,
+namespace {
+// Places the aircraft offsetMeters down the longest open runway of airport
+// ("nearest" picks the airport closest to position), facing along it.
+bool spawnOnRunway(const AirportDatabase& airports, const std::string& airport, float offsetMeters,
+                   Vec3& position, double& headingDeg) {
+    int index = airport == "nearest" ? airports.nearestAirport(position.x, position.z, true)
+                                     : airports.findAirport(airport);
+    if (index < 0) {
+        std::cerr << "[spawn] airport not found: " << airport << std::endl;
+        return false;
+    }
+    const AirportRecord& record = airports.airport(static_cast<size_t>(index));
+    const RunwayRecord* best = nullptr;
+    for (std::uint32_t i = 0; i < record.runwayCount; ++i) {
+        const RunwayRecord& runway = airports.runway(record.firstRunway + i);
+        if (!(runway.flags & RunwayClosed) && (!best || runway.lengthFt > best->lengthFt)) {
+            best = &runway;
+        }
+    }
+    if (!best) {
+        position = Vec3(record.position[0], record.position[1], record.position[2]);
+        std::cout << "[spawn] " << airports.string(record.ident) << " has no open runway, spawning at the airport"
+                  << std::endl;
+        return true;
+    }
+
+    Vec3 le(best->le[0], best->le[1], best->le[2]);
+    Vec3 he(best->he[0], best->he[1], best->he[2]);
+    Vec3 delta = he - le;
+    float length = std::sqrt(delta.x * delta.x + delta.z * delta.z);
+    if (length < 1.0f) {
+        position = le;
+        return true;
+    }
+    float t = std::min(std::max(0.0f, offsetMeters), length * 0.5f) / length;
+    position = le + delta * t;
+    // ENU: x east, z north; heading is clockwise from north.
+    headingDeg = std::atan2(delta.x, delta.z) * 180.0 / 3.141592653589793;
+    if (headingDeg < 0.0) {
+        headingDeg += 360.0;
+    }
+    std::cout << "[spawn] runway " << airports.string(best->leIdent) << " at "
+              << airports.string(record.ident) << std::endl;
+    return true;
+}
+} // namespace
+
+void Aircraft::Instance::init(const std::string& configPath, AssetStore* assets, Atmosphere& atmosphere,
                               const GeoOrigin* terrainOrigin, const TerrainRenderer* terrain) {
     auto jsonOpt = loadJsonConfig(configPath);
     if (!jsonOpt) {
@@ -28,12 +77,17 @@ void Aircraft::Instance::init(const std::string& configPath, AssetStore& assets,
     }
 
     m_properties.bind(PropertyBus::global(), m_state);
+    // Telemetry is read by the UI through snapshots published once per tick.
+    m_state.enableSnapshots();
+    bindControls(PropertyBus::global());
 
     const auto& json = *jsonOpt;
     Vec3 initialPos(0, 100, 0);
     double initialAirspeed = 0.0;
     double initialHeadingDeg = 0.0;
     bool snapToTerrain = true;
+    std::string spawnAirport;
+    float runwayOffsetMeters = 30.0f;
     if (json.contains(ConfigKeys::SPAWN)) {
         const auto& spawn = json[ConfigKeys::SPAWN];
         if (spawn.contains(ConfigKeys::POSITION)) {
@@ -42,6 +96,15 @@ void Aircraft::Instance::init(const std::string& configPath, AssetStore& assets,
         initialAirspeed = spawn.value(ConfigKeys::AIRSPEED, 0.0);
         initialHeadingDeg = spawn.value(ConfigKeys::HEADING_DEG, initialHeadingDeg);
         snapToTerrain = spawn.value(ConfigKeys::SNAP_TO_TERRAIN, snapToTerrain);
+        spawnAirport = spawn.value(ConfigKeys::AIRPORT, spawnAirport);
+        runwayOffsetMeters = spawn.value(ConfigKeys::RUNWAY_OFFSET, runwayOffsetMeters);
+    }
+    if (!spawnAirport.empty()) {
+        if (terrain && terrain->airports()) {
+            spawnOnRunway(*terrain->airports(), spawnAirport, runwayOffsetMeters, initialPos, initialHeadingDeg);
+        } else {
+            std::cerr << "[spawn] no airport database loaded, ignoring airport " << spawnAirport << std::endl;
+        }
     }
     // If terrain is available, snap the spawn altitude to the terrain height to avoid hovering.
     if (terrain && snapToTerrain) {
@@ -80,7 +143,9 @@ void Aircraft::Instance::init(const std::string& configPath, AssetStore& assets,
     }
 
     // Initialize visuals
-    m_visual.init(configPath, assets);
+    if (assets) {
+        m_visual.init(configPath, *assets);
+    }
 
     addSystem<EnvironmentSystem>(atmosphere);
     addSystem<JsbsimSystem>(jsbsimConfig);
@@ -91,37 +156,30 @@ void Aircraft::Instance::init(const std::string& configPath, AssetStore& assets,
     m_currentState.velocity = Vec3(0, 0, static_cast<float>(initialAirspeed));
     
     m_prevState = m_currentState;
+    m_frames.reset(AircraftStateFrame{m_prevState, m_currentState, 0.0});
+    m_state.publish();
 }
 
 void Aircraft::Instance::update(float dt) {
     m_prevState = m_currentState;
 
-    PropertyBus& global = m_properties.global();
-    PropertyBus& local = m_properties.local();
-
-    double elevator = global.get(Properties::Controls::ELEVATOR, 0.0);
-    double aileron = global.get(Properties::Controls::AILERON, 0.0);
-    double rudder = global.get(Properties::Controls::RUDDER, 0.0);
-    double throttle = global.get(Properties::Controls::THROTTLE, 0.0);
-    double flaps = global.get(Properties::Controls::FLAPS, 0.0);
-    double rollTrim = global.get(Properties::Controls::ROLL_TRIM, 0.0);
-    double brakeLeft = global.get(Properties::Controls::BRAKE_LEFT, 0.0);
-    double brakeRight = global.get(Properties::Controls::BRAKE_RIGHT, 0.0);
-    double parkingBrake = global.get(Properties::Controls::PARKING_BRAKE, 0.0);
-
-    local.set(Properties::Controls::ELEVATOR, elevator);
-    local.set(Properties::Controls::AILERON, aileron);
-    local.set(Properties::Controls::RUDDER, rudder);
-    local.set(Properties::Controls::THROTTLE, throttle);
-    local.set(Properties::Controls::FLAPS, flaps);
-    local.set(Properties::Controls::ROLL_TRIM, rollTrim);
-    local.set(Properties::Controls::BRAKE_LEFT, brakeLeft);
-    local.set(Properties::Controls::BRAKE_RIGHT, brakeRight);
-    local.set(Properties::Controls::PARKING_BRAKE, parkingBrake);
-
     for (auto& system : m_systems) {
         system->update(dt);
     }
+    m_state.publish();
+    m_stepped = true;
+}
+
+void Aircraft::Instance::bindControls(PropertyBus& source) {
+    m_state.alias(Properties::Controls::ELEVATOR, source);
+    m_state.alias(Properties::Controls::AILERON, source);
+    m_state.alias(Properties::Controls::RUDDER, source);
+    m_state.alias(Properties::Controls::THROTTLE, source);
+    m_state.alias(Properties::Controls::FLAPS, source);
+    m_state.alias(Properties::Controls::ROLL_TRIM, source);
+    m_state.alias(Properties::Controls::BRAKE_LEFT, source);
+    m_state.alias(Properties::Controls::BRAKE_RIGHT, source);
+    m_state.alias(Properties::Controls::PARKING_BRAKE, source);
 }
 
 void Aircraft::Instance::applyGroundCollision(const TerrainRenderer& terrain) {
@@ -131,7 +189,7 @@ void Aircraft::Instance::applyGroundCollision(const TerrainRenderer& terrain) {
         }
     }
     float groundY = 0.0f;
-    if (!terrain.sampleSurfaceHeight(m_currentState.position.x, m_currentState.position.z, groundY)) {
+    if (!terrain.samplePhysicsHeight(m_currentState.position.x, m_currentState.position.z, groundY)) {
         return;
     }
     if (m_currentState.position.y < groundY) {
@@ -151,12 +209,22 @@ void Aircraft::Instance::render(const Mat4& viewProjection, float alpha, const V
     m_visual.draw(renderPos, renderRot, viewProjection, lightDir);
 }
 
+void Aircraft::Instance::publishFrame(double tickTime) {
+    AircraftStateFrame& frame = m_frames.back();
+    frame.prev = m_prevState;
+    frame.current = m_currentState;
+    frame.tickTime = tickTime;
+    m_frames.publish();
+}
+
 Vec3 Aircraft::Instance::interpolatedPosition(float alpha) const {
-    return m_prevState.position + (m_currentState.position - m_prevState.position) * alpha;
+    const AircraftStateFrame& frame = m_frames.front();
+    return frame.prev.position + (frame.current.position - frame.prev.position) * alpha;
 }
 
 Quat Aircraft::Instance::interpolatedOrientation(float alpha) const {
-    return Quat::slerp(m_prevState.orientation, m_currentState.orientation, alpha);
+    const AircraftStateFrame& frame = m_frames.front();
+    return Quat::slerp(frame.prev.orientation, frame.current.orientation, alpha);
 }
 
 }
@@ -17,4 +17,15 @@ struct AircraftState {
     double airspeed = 0.0;
 };
 
+/**
+ * @brief The two most recent physics states, handed to the renderer together
+ * so it can interpolate between them. tickTime is the steady-clock time, in
+ * seconds, that current belongs to.
+ */
+struct AircraftStateFrame {
+    AircraftState prev;
+    AircraftState current;
+    double tickTime = 0.0;
+};
+
 } // namespace nuage
\ No newline at end of file
@@ -15,6 +15,8 @@
 #include <initialization/FGInitialCondition.h>
 #include <algorithm>
 #include <cmath>
+#include <iostream>
+#include <iterator>
 
 namespace nuage {
 
@@ -29,6 +31,46 @@ float clampInput(double v) {
     return static_cast<float>(std::clamp(v, -1.0, 1.0));
 }
 
+// Indexed by JsbsimSystem::Input. "x" and "x[0]" name the same node, so each
+// engine-0 property appears once.
+constexpr const char* kInputPaths[] = {
+    "propulsion/engine/set-running",
+    "fcs/mixture-cmd-norm",
+    "propulsion/engine[0]/mixture-cmd-norm",
+    "propulsion/magneto_cmd",
+    "propulsion/starter_cmd",
+    "fcs/elevator-cmd-norm",
+    "fcs/aileron-cmd-norm",
+    "fcs/rudder-cmd-norm",
+    "fcs/throttle-cmd-norm",
+    "fcs/flap-cmd-norm",
+    "fcs/roll-trim-cmd-norm",
+    "fcs/left-brake-cmd-norm",
+    "fcs/right-brake-cmd-norm",
+    "fcs/center-brake-cmd-norm",
+    "atmosphere/wind-north-fps",
+    "atmosphere/wind-east-fps",
+    "atmosphere/wind-down-fps",
+};
+
+// Indexed by JsbsimSystem::Output.
+constexpr const char* kOutputPaths[] = {
+    "propulsion/engine[0]/engine-rpm",
+    "position/lat-geod-rad",
+    "position/long-gc-rad",
+    "position/h-sl-ft",
+    "position/h-agl-ft",
+    "velocities/vtrue-fps",
+    "velocities/vg-fps",
+    "velocities/vc-kts",
+    "velocities/v-down-fps",
+    "attitude/theta-deg",
+    "attitude/phi-deg",
+    "attitude/psi-deg",
+    "fcs/flap-pos-deg",
+    "fcs/flap-pos-norm",
+};
+
 Vec3 nedToWorld(const JSBSim::FGColumnVector3& ned) {
     float north = static_cast<float>(ned(1)) * static_cast<float>(kFtToM);
     float east = static_cast<float>(ned(2)) * static_cast<float>(kFtToM);
@@ -108,11 +150,7 @@ public:
         Vec3 enu = llaToEnu(m_origin, latDeg, lonDeg, m_origin.altMeters);
 
         TerrainRenderer::TerrainSample sample;
-        bool hasSample = m_terrain && m_terrain->sampleSurfaceNoLoad(enu.x, enu.z, sample);
-        if (!hasSample && m_terrain) {
-            // Allow a one-off load if the cached ring missed; avoids zero height on tall terrain.
-            hasSample = m_terrain->sampleSurface(enu.x, enu.z, sample);
-        }
+        bool hasSample = m_terrain && m_terrain->samplePhysicsSurface(enu.x, enu.z, sample);
         if (!hasSample) {
             if (m_hasLastHeight) {
                 sample.height = m_lastHeightMeters;
@@ -162,12 +200,13 @@ JsbsimSystem::JsbsimSystem(JsbsimConfig config)
 void JsbsimSystem::init(AircraftState& state, PropertyContext& properties) {
     m_acState = &state;
     m_properties = &properties;
-    m_properties->global().set(Properties::Controls::ROLL_TRIM, m_config.rollTrim);
+    // The local control is aliased to the aircraft's control source, so this
+    // sets the trim there.
     m_properties->local().set(Properties::Controls::ROLL_TRIM, m_config.rollTrim);
 }
 
 void JsbsimSystem::ensureInitialized(float dt) {
-    if (m_initialized) return;
+    if (m_initialized || m_loadFailed) return;
 
     m_fdm = std::make_unique<JSBSim::FGFDMExec>();
     SGPath rootPath(m_config.rootPath);
@@ -191,6 +230,11 @@ void JsbsimSystem::ensureInitialized(float dt) {
     m_fdm->SetPropertyValue("ic/w-fps", -m_acState->velocity.y * kMToFt);  // down
 
     if (!m_fdm->LoadModel(m_config.modelName)) {
+        // Not retried: it would fail again every tick, and later ticks may
+        // run on a worker thread alongside other aircraft.
+        std::cerr << "[jsbsim] failed to load model " << m_config.modelName << std::endl;
+        m_fdm.reset();
+        m_loadFailed = true;
         return;
     }
 
@@ -204,19 +248,47 @@ void JsbsimSystem::ensureInitialized(float dt) {
         m_hasGroundCallback = true;
     }
 
+    resolveNodes();
+
     // Ensure the engine is running and ready for throttle input (useful after landing).
-    m_fdm->SetPropertyValue("propulsion/engine/set-running", 1.0);
-    m_fdm->SetPropertyValue("propulsion/engine[0]/set-running", 1.0);
-    m_fdm->SetPropertyValue("fcs/mixture-cmd-norm", 1.0);
-    m_fdm->SetPropertyValue("fcs/mixture-cmd-norm[0]", 1.0);
-    m_fdm->SetPropertyValue("propulsion/engine[0]/mixture-cmd-norm", 1.0);
-    m_fdm->SetPropertyValue("fcs/left-brake-cmd-norm", 0.0);
-    m_fdm->SetPropertyValue("fcs/right-brake-cmd-norm", 0.0);
+    write(SetRunning, 1.0);
+    write(MixtureCmd, 1.0);
+    write(EngineMixtureCmd, 1.0);
+    write(LeftBrakeCmd, 0.0);
+    write(RightBrakeCmd, 0.0);
 
     m_fdm->RunIC();
     m_initialized = true;
 }
 
+void JsbsimSystem::resolveNodes() {
+    static_assert(std::size(kInputPaths) == InputCount, "one path per input");
+    static_assert(std::size(kOutputPaths) == OutputCount, "one path per output");
+    auto properties = m_fdm->GetPropertyManager();
+    // Inputs are created if the model does not define them, as
+    // SetPropertyValue would. Missing outputs read as 0.
+    for (size_t i = 0; i < InputCount; ++i) {
+        m_inputs[i] = properties->GetNode(kInputPaths[i], true);
+    }
+    for (size_t i = 0; i < OutputCount; ++i) {
+        m_outputs[i] = properties->GetNode(kOutputPaths[i], false);
+    }
+}
+
+void JsbsimSystem::write(Input input, double value) {
+    // Compare against the node rather than the last value written: JSBSim
+    // may have changed it since (an engine that stopped reads set-running 0).
+    SGPropertyNode* node = m_inputs[input];
+    if (node->getDoubleValue() != value) {
+        node->setDoubleValue(value);
+    }
+}
+
+double JsbsimSystem::read(Output output) const {
+    const SGPropertyNode* node = m_outputs[output];
+    return node ? node->getDoubleValue() : 0.0;
+}
+
 void JsbsimSystem::syncInputs() {
     PropertyBus& local = m_properties->local();
     double elevator = local.get(Properties::Controls::ELEVATOR);
@@ -229,38 +301,31 @@ void JsbsimSystem::syncInputs() {
     double rollTrim = local.get(Properties::Controls::ROLL_TRIM, 0.0);
 
     // Keep the engine alive and mixture rich so throttle always makes power after landings.
-    m_fdm->SetPropertyValue("propulsion/engine/set-running", 1.0);
-    m_fdm->SetPropertyValue("propulsion/engine[0]/set-running", 1.0);
-    m_fdm->SetPropertyValue("fcs/mixture-cmd-norm", 1.0);
-    m_fdm->SetPropertyValue("fcs/mixture-cmd-norm[0]", 1.0);
-    m_fdm->SetPropertyValue("propulsion/engine[0]/mixture-cmd-norm", 1.0);
-
-    m_fdm->SetPropertyValue("fcs/elevator-cmd-norm", clampInput(elevator));
-    m_fdm->SetPropertyValue("fcs/aileron-cmd-norm", clampInput(-aileron));
-    m_fdm->SetPropertyValue("fcs/rudder-cmd-norm", clampInput(rudder));
-    m_fdm->SetPropertyValue("fcs/throttle-cmd-norm", clampInput(throttle));
-    m_fdm->SetPropertyValue("fcs/throttle-cmd-norm[0]", clampInput(throttle));
-    m_fdm->SetPropertyValue("fcs/flap-cmd-norm", std::clamp(flaps, 0.0, 1.0));
-    m_fdm->SetPropertyValue("fcs/roll-trim-cmd-norm", clampInput(rollTrim));
-    m_fdm->SetPropertyValue("fcs/left-brake-cmd-norm", std::clamp(brakeLeft, 0.0, 1.0));
-    m_fdm->SetPropertyValue("fcs/right-brake-cmd-norm", std::clamp(brakeRight, 0.0, 1.0));
-    m_fdm->SetPropertyValue("fcs/center-brake-cmd-norm",
-        std::clamp(std::max(brakeLeft, brakeRight), 0.0, 1.0));
+    write(SetRunning, 1.0);
+    write(MixtureCmd, 1.0);
+    write(EngineMixtureCmd, 1.0);
+
+    write(ElevatorCmd, clampInput(elevator));
+    write(AileronCmd, clampInput(-aileron));
+    write(RudderCmd, clampInput(rudder));
+    write(ThrottleCmd, clampInput(throttle));
+    write(FlapCmd, std::clamp(flaps, 0.0, 1.0));
+    write(RollTrimCmd, clampInput(rollTrim));
+    write(LeftBrakeCmd, std::clamp(brakeLeft, 0.0, 1.0));
+    write(RightBrakeCmd, std::clamp(brakeRight, 0.0, 1.0));
+    write(CenterBrakeCmd, std::clamp(std::max(brakeLeft, brakeRight), 0.0, 1.0));
 
     // Keep the piston engine restartable after full-stop landings.
-    m_fdm->SetPropertyValue("propulsion/magneto_cmd", 3.0);
-    double engineRpm = m_fdm->GetPropertyValue("propulsion/engine[0]/engine-rpm");
+    write(MagnetoCmd, 3.0);
+    double engineRpm = read(EngineRpm);
     bool throttleRequested = clampInput(throttle) > 0.05;
     bool needsRestart = throttleRequested && engineRpm < 500.0;
-    m_fdm->SetPropertyValue("propulsion/starter_cmd", needsRestart ? 1.0 : 0.0);
+    write(StarterCmd, needsRestart ? 1.0 : 0.0);
 
     Vec3 wind = local.get(Properties::Atmosphere::WIND_PREFIX);
-    double windNorth = wind.z * kMToFt;
-    double windEast = wind.x * kMToFt;
-    double windDown = -wind.y * kMToFt;
-    m_fdm->SetPropertyValue("atmosphere/wind-north-fps", windNorth);
-    m_fdm->SetPropertyValue("atmosphere/wind-east-fps", windEast);
-    m_fdm->SetPropertyValue("atmosphere/wind-down-fps", windDown);
+    write(WindNorthFps, wind.z * kMToFt);
+    write(WindEastFps, wind.x * kMToFt);
+    write(WindDownFps, -wind.y * kMToFt);
 }
 
 void JsbsimSystem::syncOutputs() {
@@ -311,9 +376,9 @@ void JsbsimSystem::syncOutputs() {
     }
     m_acState->orientation = quatFromMatrix(b2w);
 
-    double latGeodRad = m_fdm->GetPropertyValue("position/lat-geod-rad");
-    double lonRad = m_fdm->GetPropertyValue("position/long-gc-rad");
-    double altFt = m_fdm->GetPropertyValue("position/h-sl-ft");
+    double latGeodRad = read(LatGeodRad);
+    double lonRad = read(LonGcRad);
+    double altFt = read(AltitudeSlFt);
 
     double latDeg = latGeodRad * kRadToDeg;
     double lonDeg = lonRad * kRadToDeg;
@@ -325,10 +390,10 @@ void JsbsimSystem::syncOutputs() {
     origin.altMeters = m_config.originAltMeters;
     m_acState->position = llaToEnu(origin, latDeg, lonDeg, alt);
 
-    double airspeedFps = m_fdm->GetPropertyValue("velocities/vtrue-fps");
-    double groundSpeedFps = m_fdm->GetPropertyValue("velocities/vg-fps");
-    double indicatedAirspeedKts = m_fdm->GetPropertyValue("velocities/vc-kts");
-    double aglFt = m_fdm->GetPropertyValue("position/h-agl-ft");
+    double airspeedFps = read(VtrueFps);
+    double groundSpeedFps = read(VgroundFps);
+    double indicatedAirspeedKts = read(VcalibratedKts);
+    double aglFt = read(AltitudeAglFt);
     m_acState->airspeed = airspeedFps * kFtToM;
 
     // Publish to Property Bus
@@ -341,12 +406,12 @@ void JsbsimSystem::syncOutputs() {
     local.set(Properties::Position::LATITUDE_DEG, latDeg);
     local.set(Properties::Position::LONGITUDE_DEG, lonDeg);
     
-    local.set(Properties::Orientation::PITCH_DEG, m_fdm->GetPropertyValue("attitude/theta-deg"));
-    local.set(Properties::Orientation::ROLL_DEG, m_fdm->GetPropertyValue("attitude/phi-deg"));
-    local.set(Properties::Orientation::HEADING_DEG, m_fdm->GetPropertyValue("attitude/psi-deg"));
-    local.set(Properties::Velocities::VERTICAL_SPEED_FPS, m_fdm->GetPropertyValue("velocities/v-down-fps") * -1.0);
-    local.set(Properties::Surfaces::FLAPS_DEG, m_fdm->GetPropertyValue("fcs/flap-pos-deg"));
-    local.set(Properties::Surfaces::FLAPS_NORM, m_fdm->GetPropertyValue("fcs/flap-pos-norm"));
+    local.set(Properties::Orientation::PITCH_DEG, read(ThetaDeg));
+    local.set(Properties::Orientation::ROLL_DEG, read(PhiDeg));
+    local.set(Properties::Orientation::HEADING_DEG, read(PsiDeg));
+    local.set(Properties::Velocities::VERTICAL_SPEED_FPS, read(VdownFps) * -1.0);
+    local.set(Properties::Surfaces::FLAPS_DEG, read(FlapPosDeg));
+    local.set(Properties::Surfaces::FLAPS_NORM, read(FlapPosNorm));
 }
 
 void JsbsimSystem::update(float dt) {
@@ -357,8 +422,7 @@ void JsbsimSystem::update(float dt) {
 
     m_fdm->Setdt(dt);
     if (m_config.terrain) {
-        const_cast<TerrainRenderer*>(m_config.terrain)
-            ->preloadPhysicsAt(m_acState->position.x, m_acState->position.z, 1);
+        m_config.terrain->requestPhysicsTiles(m_acState->position.x, m_acState->position.z, 1);
     }
     syncInputs();
     m_fdm->Run();
@@ -3,8 +3,10 @@
 #include "aircraft/aircraft_component.hpp"
 #include "math/vec3.hpp"
 #include "math/quat.hpp"
+#include <array>
 #include <cstddef>
 #include <FGFDMExec.h>
+#include <input_output/FGPropertyManager.h>
 #include <memory>
 #include <string>
 
@@ -36,14 +38,63 @@ public:
     bool hasGroundCallback() const { return m_hasGroundCallback; }
 
 private:
+    // JSBSim properties written every tick. Paths are in jsbsim_system.cpp.
+    enum Input {
+        SetRunning,
+        MixtureCmd,
+        EngineMixtureCmd,
+        MagnetoCmd,
+        StarterCmd,
+        ElevatorCmd,
+        AileronCmd,
+        RudderCmd,
+        ThrottleCmd,
+        FlapCmd,
+        RollTrimCmd,
+        LeftBrakeCmd,
+        RightBrakeCmd,
+        CenterBrakeCmd,
+        WindNorthFps,
+        WindEastFps,
+        WindDownFps,
+        InputCount
+    };
+
+    // JSBSim properties read every tick.
+    enum Output {
+        EngineRpm,
+        LatGeodRad,
+        LonGcRad,
+        AltitudeSlFt,
+        AltitudeAglFt,
+        VtrueFps,
+        VgroundFps,
+        VcalibratedKts,
+        VdownFps,
+        ThetaDeg,
+        PhiDeg,
+        PsiDeg,
+        FlapPosDeg,
+        FlapPosNorm,
+        OutputCount
+    };
+
     AircraftState* m_acState = nullptr;
     PropertyContext* m_properties = nullptr;
     JsbsimConfig m_config;
     std::unique_ptr<JSBSim::FGFDMExec> m_fdm;
     bool m_initialized = false;
+    bool m_loadFailed = false;
     bool m_hasGroundCallback = false;
+    // Resolved once after LoadModel; owned by m_fdm's property tree.
+    std::array<SGPropertyNode*, InputCount> m_inputs{};
+    std::array<SGPropertyNode*, OutputCount> m_outputs{};
 
     void ensureInitialized(float dt);
+    void resolveNodes();
+    // Skips the write when the node already holds value.
+    void write(Input input, double value);
+    double read(Output output) const;
     void syncInputs();
     void syncOutputs();
 };
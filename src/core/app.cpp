@@ -21,6 +21,8 @@ namespace nuage {
 
 bool App::init(const AppConfig& config) {
     if (!initWindow(config)) return false;
+    m_physicsThreaded = config.physicsThread;
+    m_physicsWorkers = config.physicsWorkers;
 
     m_assets = std::make_shared<AssetStore>();
     m_subsystems.add(m_assets);
@@ -38,8 +40,18 @@ bool App::init(const AppConfig& config) {
 
     m_subsystems.add(std::make_shared<SimSubsystem>());
 
+    m_recorder = std::make_shared<FlightRecorder>();
+    m_subsystems.add(m_recorder);
+
     m_subsystems.initAll();
 
+    m_toggleCameraSubscription = PropertyBus::global().subscribe(Properties::Sim::TOGGLE_CAMERA,
+        [this](const int&) {
+            if (m_session) {
+                m_session->camera().toggleOrbitMode();
+            }
+        });
+
     FlightConfig flight;
     flight.aircraftPath = "assets/config/aircraft/c172p.json";
     flight.terrainPath = "assets/config/terrain.json";
@@ -62,11 +74,40 @@ bool App::startFlight(const FlightConfig& config) {
     }
 
     m_ui->setAircraft(&m_session->aircraft());
+    if (m_physicsWorkers) {
+        // Aircraft may sample terrain from several threads at once. A count
+        // of 1 takes the same tile path, so it flies the same as any other.
+        m_session->aircraft().setWorkerThreads(*m_physicsWorkers);
+        m_session->terrain().setPhysicsThreaded(true);
+    }
     setPaused(false);
+    if (m_recorder->enabled()) {
+        m_recorder->start(FIXED_DT);
+    }
+    if (m_physicsThreaded) {
+        startPhysicsThread();
+    }
     return true;
 }
 
+void App::startPhysicsThread() {
+    // Aircraft read their controls from the physics thread's own bus; the
+    // frame loop feeds it from the global bus through pushControls().
+    m_session->terrain().setPhysicsThreaded(true);
+    for (const auto& aircraft : m_session->aircraft().all()) {
+        aircraft->bindControls(m_physics.controls());
+    }
+    m_physics.pushControls(PropertyBus::global());
+    m_physics.start(FIXED_DT, [this](double tickTime) {
+        stepPhysics(tickTime, m_physics.controls());
+    });
+}
+
 void App::endFlight() {
+    m_physics.stop();
+    if (m_recorder) {
+        m_recorder->stop();
+    }
     if (m_session) {
         m_session->shutdown();
         m_session.reset();
@@ -96,25 +137,21 @@ void App::run() {
             continue;
         }
 
+        float alpha = 0.0f;
         if (m_session) {
-            if (PropertyBus::global().get("sim/commands/toggle-camera", false)) {
-                m_session->camera().toggleOrbitMode();
-                PropertyBus::global().set("sim/commands/toggle-camera", false);
-            }
-
             updatePhysics();
 
             if (m_session) {
+                m_session->aircraft().acquireFrames();
+                alpha = renderAlpha();
                 m_session->update(m_deltaTime);
-                float alpha = m_physicsAccumulator / FIXED_DT;
                 m_session->camera().update(m_deltaTime, m_session->aircraft().player(), alpha);
                 m_session->camera().clampToGround(m_session->terrain(), 1.5f);
             }
         }
 
         auto renderStart = clock::now();
-        float alpha = m_physicsAccumulator / FIXED_DT;
-        
+
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         if (m_session) {
@@ -143,6 +180,7 @@ void App::run() {
 }
 
 void App::shutdown() {
+    PropertyBus::global().unsubscribe(m_toggleCameraSubscription);
     endFlight();
     m_subsystems.shutdownAll();
     glfwDestroyWindow(m_window);
@@ -187,19 +225,58 @@ bool App::initWindow(const AppConfig& config) {
 void App::setPaused(bool paused) {
     PropertyBus::global().set(Properties::Sim::PAUSED, paused);
     m_physicsAccumulator = 0.0f;
+    m_physics.setPaused(paused);
+    m_physicsPaused = paused;
 }
 
 void App::updatePhysics() {
     bool paused = PropertyBus::global().get(Properties::Sim::PAUSED, false);
+    if (m_physics.running()) {
+        if (paused != m_physicsPaused) {
+            m_physics.setPaused(paused);
+            m_physicsPaused = paused;
+        }
+        if (!paused) {
+            m_physics.pushControls(PropertyBus::global());
+        }
+        m_session->terrain().updatePhysicsTiles();
+        return;
+    }
     if (paused || !m_session) {
         return;
     }
     m_physicsAccumulator += m_deltaTime;
     while (m_physicsAccumulator >= FIXED_DT) {
-        m_session->aircraft().fixedUpdate(FIXED_DT);
-        m_session->aircraft().applyGroundCollision(m_session->terrain());
+        stepPhysics(m_time, PropertyBus::global());
         m_physicsAccumulator -= FIXED_DT;
     }
+    if (m_session->terrain().physicsThreaded()) {
+        m_session->terrain().updatePhysicsTiles();
+    }
+}
+
+void App::stepPhysics(double tickTime, const PropertyBus& controls) {
+    Aircraft& aircraft = m_session->aircraft();
+    aircraft.fixedUpdate(FIXED_DT);
+    aircraft.applyGroundCollision(m_session->terrain());
+    aircraft.publishFrames(tickTime);
+    if (Aircraft::Instance* player = aircraft.player()) {
+        m_recorder->record(player->currentState(), player->state(), controls);
+    }
+}
+
+float App::renderAlpha() const {
+    if (!m_physics.running()) {
+        return m_physicsAccumulator / FIXED_DT;
+    }
+    // The newest tick is shown one tick late, so the frame between its prev
+    // and current states follows the wall clock smoothly.
+    const Aircraft::Instance* player = m_session ? m_session->aircraft().player() : nullptr;
+    if (!player) {
+        return 1.0f;
+    }
+    double alpha = (PhysicsThread::now() - player->frame().tickTime) / FIXED_DT;
+    return static_cast<float>(std::clamp(alpha, 0.0, 1.0));
 }
 
 void App::updateFrameStats(const FrameProfile& profile) {
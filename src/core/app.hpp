@@ -9,8 +9,12 @@
 #include "core/session/flight_config.hpp"
 #include "core/session/flight_session.hpp"
 #include "core/subsystem_manager.hpp"
+#include "core/flight_recorder.hpp"
+#include "core/physics_thread.hpp"
+#include "core/properties/property_bus.hpp"
 #include <cstdint>
 #include <memory>
+#include <optional>
 
 struct GLFWwindow;
 
@@ -21,6 +25,13 @@ struct AppConfig {
     int windowHeight = 720;
     const char* title = "Nuage";
     bool vsync = true;
+    // Step physics on its own thread instead of from the frame loop.
+    bool physicsThread = false;
+    // Threads stepping aircraft each tick, counting the physics thread;
+    // 0 = one per hardware thread. When set, terrain takes the deferred
+    // physics tile path for every count, so the count never changes what
+    // physics sees. Unset steps aircraft inline on the immediate path.
+    std::optional<int> physicsWorkers;
 };
 
 class App {
@@ -77,6 +88,11 @@ private:
     std::shared_ptr<UIManager> m_ui;
     std::shared_ptr<AssetStore> m_assets;
     std::shared_ptr<AudioSubsystem> m_audio;
+    std::shared_ptr<FlightRecorder> m_recorder;
+    PhysicsThread m_physics;
+    bool m_physicsThreaded = false;
+    std::optional<int> m_physicsWorkers;
+    bool m_physicsPaused = false;
     // Active Flight Session
     std::unique_ptr<FlightSession> m_session;
 
@@ -84,6 +100,7 @@ private:
     float m_deltaTime = 0.0f;
     float m_lastFrameTime = 0.0f;
     bool m_shouldQuit = false;
+    PropertySubscription m_toggleCameraSubscription = 0;
 
     float m_physicsAccumulator = 0.0f;
     static constexpr float FIXED_DT = 1.0f / 120.0f;
@@ -91,6 +108,9 @@ private:
     // Helpers
     bool initWindow(const AppConfig& config);
     void updatePhysics();
+    void stepPhysics(double tickTime, const PropertyBus& controls);
+    void startPhysicsThread();
+    float renderAlpha() const;
     void updateFrameStats(const FrameProfile& profile);
     
     float m_lastFps = 0.0f;
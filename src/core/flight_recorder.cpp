@@ -0,0 +1,248 @@
+#include "core/flight_recorder.hpp"
+#include "utils/config_loader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+namespace nuage {
+
+namespace {
+constexpr const char* kRecorderConfigPath = "assets/config/recorder.json";
+constexpr auto kFlushInterval = std::chrono::milliseconds(50);
+
+std::uint64_t nextPowerOfTwo(std::uint64_t value) {
+    std::uint64_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+} // namespace
+
+FlightRecorder::~FlightRecorder() {
+    stop();
+}
+
+void FlightRecorder::init() {
+    m_enabled = loadConfig(kRecorderConfigPath) && m_enabled;
+}
+
+void FlightRecorder::shutdown() {
+    stop();
+}
+
+bool FlightRecorder::loadConfig(const std::string& path) {
+    auto configOpt = loadJsonConfig(path);
+    if (!configOpt) {
+        return false;
+    }
+    const auto& config = *configOpt;
+    m_enabled = config.value("enabled", false);
+    m_directory = config.value("directory", m_directory);
+    m_bufferSeconds = std::max(1.0, config.value("bufferSeconds", m_bufferSeconds));
+
+    m_stateFields.clear();
+    m_channels.clear();
+    m_columns = {"time"};
+    if (config.contains("state")) {
+        for (const auto& entry : config["state"]) {
+            std::string name = entry.get<std::string>();
+            if (name == "position") {
+                m_stateFields.push_back(StateField::Position);
+                m_columns.insert(m_columns.end(), {"state/position-x", "state/position-y", "state/position-z"});
+            } else if (name == "orientation") {
+                m_stateFields.push_back(StateField::Orientation);
+                m_columns.insert(m_columns.end(), {"state/orientation-w", "state/orientation-x",
+                                                   "state/orientation-y", "state/orientation-z"});
+            } else if (name == "velocity") {
+                m_stateFields.push_back(StateField::Velocity);
+                m_columns.insert(m_columns.end(), {"state/velocity-x", "state/velocity-y", "state/velocity-z"});
+            } else if (name == "angularVelocity") {
+                m_stateFields.push_back(StateField::AngularVelocity);
+                m_columns.insert(m_columns.end(), {"state/angular-velocity-p", "state/angular-velocity-q",
+                                                   "state/angular-velocity-r"});
+            } else if (name == "airspeed") {
+                m_stateFields.push_back(StateField::Airspeed);
+                m_columns.push_back("state/airspeed");
+            } else {
+                std::cerr << "[recorder] unknown state field " << name << "\n";
+            }
+        }
+    }
+    if (config.contains("properties")) {
+        for (const auto& entry : config["properties"]) {
+            // Either a path (a double on the aircraft's bus) or
+            // {"path", "type": "double"|"int"|"bool", "bus": "local"|"global"}.
+            std::string propertyPath;
+            std::string type = "double";
+            bool global = false;
+            if (entry.is_string()) {
+                propertyPath = entry.get<std::string>();
+            } else {
+                propertyPath = entry.value("path", std::string());
+                type = entry.value("type", type);
+                global = entry.value("bus", std::string("local")) == "global";
+            }
+            if (propertyPath.empty()) {
+                continue;
+            }
+            if (propertyPath.size() >= sizeof(FlightRecordColumn::name)) {
+                std::cerr << "[recorder] property path longer than " << sizeof(FlightRecordColumn::name) - 1
+                          << " characters, not recorded: " << propertyPath << "\n";
+                continue;
+            }
+            const char* name = propertyPath.c_str();
+            if (type == "double") {
+                m_channels.push_back({TypedProperty<double>(name), global});
+            } else if (type == "int") {
+                m_channels.push_back({TypedProperty<int>(name), global});
+            } else if (type == "bool") {
+                m_channels.push_back({TypedProperty<bool>(name), global});
+            } else {
+                std::cerr << "[recorder] unknown type " << type << " for " << propertyPath << "\n";
+                continue;
+            }
+            m_columns.push_back(propertyPath);
+        }
+    }
+    return true;
+}
+
+bool FlightRecorder::start(double tickSeconds) {
+    stop();
+    if (!m_enabled) {
+        return false;
+    }
+
+    std::time_t now = std::time(nullptr);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    std::string base = (std::filesystem::path(m_directory) / (std::string("flight-") + stamp)).string();
+    m_path = base + ".nfdr";
+    for (int suffix = 2; std::filesystem::exists(m_path, ec); ++suffix) {
+        m_path = base + "-" + std::to_string(suffix) + ".nfdr";
+    }
+
+    FlightRecordSchema schema;
+    schema.columns = m_columns;
+    schema.tickSeconds = tickSeconds;
+    schema.startUnixSeconds = static_cast<std::int64_t>(now);
+    if (!m_writer.open(m_path, schema)) {
+        return false;
+    }
+
+    m_rowDoubles = m_columns.size();
+    m_capacity = nextPowerOfTwo(static_cast<std::uint64_t>(m_bufferSeconds / tickSeconds));
+    m_ring.assign(m_capacity * m_rowDoubles, 0.0);
+    m_head.store(0);
+    m_tail.store(0);
+    m_dropped.store(0);
+    m_tick = 0;
+    m_tickSeconds = tickSeconds;
+    m_stopping = false;
+    m_writerThread = std::thread(&FlightRecorder::writerLoop, this);
+    m_active.store(true, std::memory_order_release);
+    std::cout << "[recorder] recording " << m_columns.size() << " columns to " << m_path << std::endl;
+    return true;
+}
+
+void FlightRecorder::stop() {
+    if (!m_writerThread.joinable()) {
+        return;
+    }
+    m_active.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_writerThread.join();
+    std::uint64_t rows = m_writer.rowCount();
+    m_writer.close();
+    std::cout << "[recorder] wrote " << rows << " rows to " << m_path;
+    if (std::uint64_t dropped = m_dropped.load()) {
+        std::cout << " (" << dropped << " dropped)";
+    }
+    std::cout << std::endl;
+}
+
+void FlightRecorder::record(const AircraftState& state, const PropertyBus& local, const PropertyBus& global) {
+    if (!m_active.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::uint64_t tick = m_tick++;
+    std::uint64_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) >= m_capacity) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    double* out = &m_ring[(head & (m_capacity - 1)) * m_rowDoubles];
+    *out++ = static_cast<double>(tick) * m_tickSeconds;
+    for (StateField field : m_stateFields) {
+        switch (field) {
+            case StateField::Position:
+                *out++ = state.position.x;
+                *out++ = state.position.y;
+                *out++ = state.position.z;
+                break;
+            case StateField::Orientation:
+                *out++ = state.orientation.w;
+                *out++ = state.orientation.x;
+                *out++ = state.orientation.y;
+                *out++ = state.orientation.z;
+                break;
+            case StateField::Velocity:
+                *out++ = state.velocity.x;
+                *out++ = state.velocity.y;
+                *out++ = state.velocity.z;
+                break;
+            case StateField::AngularVelocity:
+                *out++ = state.angularVelocity.x;
+                *out++ = state.angularVelocity.y;
+                *out++ = state.angularVelocity.z;
+                break;
+            case StateField::Airspeed:
+                *out++ = state.airspeed;
+                break;
+        }
+    }
+    for (const Channel& channel : m_channels) {
+        const PropertyBus& bus = channel.global ? global : local;
+        *out++ = std::visit([&bus](const auto& prop) { return static_cast<double>(bus.get(prop)); },
+                            channel.property);
+    }
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+void FlightRecorder::writerLoop() {
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    while (true) {
+        bool stopping = m_wake.wait_for(lock, kFlushInterval, [this] { return m_stopping; });
+        lock.unlock();
+        drain();
+        lock.lock();
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+void FlightRecorder::drain() {
+    std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    std::uint64_t head = m_head.load(std::memory_order_acquire);
+    while (tail < head) {
+        // Contiguous run up to the end of the ring.
+        std::uint64_t index = tail & (m_capacity - 1);
+        std::uint64_t count = std::min(head - tail, m_capacity - index);
+        m_writer.append(&m_ring[index * m_rowDoubles], static_cast<size_t>(count));
+        tail += count;
+        m_tail.store(tail, std::memory_order_release);
+    }
+}
+
+} // namespace nuage
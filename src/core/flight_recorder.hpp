@@ -0,0 +1,99 @@
+#pragma once
+
+#include "core/subsystem.hpp"
+#include "core/properties/property_bus.hpp"
+#include "aircraft/aircraft_state.hpp"
+#include "utils/flight_record.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace nuage {
+
+/**
+ * @brief Records the player's state and a configurable set of properties every
+ * physics tick.
+ *
+ * record() writes one row into a single-producer ring and never blocks; a
+ * background thread drains the ring into a memory-mapped FlightRecordWriter
+ * file. When the writer falls behind by more than the ring, rows are dropped
+ * and counted rather than stalling physics. Configured by
+ * assets/config/recorder.json.
+ *
+ * start() and stop() must not overlap record(); call them from the thread
+ * that records, or while it is idle.
+ */
+class FlightRecorder : public Subsystem {
+public:
+    FlightRecorder() = default;
+    ~FlightRecorder() override;
+
+    void init() override;
+    void update(double) override {}
+    void shutdown() override;
+    std::string getName() const override { return "FlightRecorder"; }
+
+    bool enabled() const { return m_enabled; }
+    // Overrides recorder.json's "enabled"; the columns still come from it.
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool recording() const { return m_writerThread.joinable(); }
+
+    // Opens a new recording in the configured directory and starts the writer.
+    bool start(double tickSeconds);
+    // Flushes the ring and closes the recording.
+    void stop();
+
+    // Captures one physics tick from the producer thread. Channels marked
+    // "global" are read from global, which must be a bus that thread owns.
+    void record(const AircraftState& state, const PropertyBus& local, const PropertyBus& global);
+
+private:
+    enum class StateField {
+        Position,
+        Orientation,
+        Velocity,
+        AngularVelocity,
+        Airspeed,
+    };
+
+    struct Channel {
+        std::variant<TypedProperty<double>, TypedProperty<int>, TypedProperty<bool>> property;
+        bool global = false;
+    };
+
+    bool loadConfig(const std::string& path);
+    void writerLoop();
+    void drain();
+
+    bool m_enabled = false;
+    std::string m_directory = "recordings";
+    double m_bufferSeconds = 10.0;
+    std::vector<StateField> m_stateFields;
+    std::vector<Channel> m_channels;
+    std::vector<std::string> m_columns;
+
+    // Ring of rows; the producer owns m_head and m_tick, the writer m_tail.
+    std::vector<double> m_ring;
+    size_t m_rowDoubles = 0;
+    std::uint64_t m_capacity = 0;
+    alignas(64) std::atomic<std::uint64_t> m_head{0};
+    alignas(64) std::atomic<std::uint64_t> m_tail{0};
+    std::atomic<std::uint64_t> m_dropped{0};
+    std::atomic<bool> m_active{false};
+    std::uint64_t m_tick = 0;
+    double m_tickSeconds = 0.0;
+
+    FlightRecordWriter m_writer;
+    std::string m_path;
+    std::thread m_writerThread;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_stopping = false;
+};
+
+} // namespace nuage
@@ -0,0 +1,260 @@
+#include "core/headless_runner.hpp"
+#include "core/properties/property_paths.hpp"
+#include "core/sim_subsystem.hpp"
+#include "utils/config_loader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace nuage {
+
+namespace {
+constexpr double kFixedDt = 1.0 / 120.0;
+constexpr double kProgressIntervalSeconds = 10.0;
+
+void printUsage() {
+    std::cout << "Usage: nuage --headless [--scenario <file.json>] [--aircraft <config>] [--terrain <config>]\n"
+              << "                        [--duration <seconds>] [--rate <ratio>] [--report <out.json>]\n"
+              << "                        [--workers <count>] [--traffic <count>]\n"
+              << "  --rate     simulated seconds per real second; 0 (default) runs as fast as possible\n"
+              << "  --workers  threads stepping aircraft; 0 = all hardware threads (default 1)\n"
+              << "  --traffic  extra copies of the aircraft flying the same controls\n";
+}
+
+void addControls(const nlohmann::json& controls, double time, HeadlessConfig& config) {
+    for (auto it = controls.begin(); it != controls.end(); ++it) {
+        if (!it.value().is_number()) {
+            std::cerr << "[headless] ignoring non-numeric control " << it.key() << "\n";
+            continue;
+        }
+        config.events.push_back({time, it.key(), it.value().get<double>()});
+    }
+}
+} // namespace
+
+bool loadHeadlessScenario(const std::string& path, HeadlessConfig& config) {
+    auto scenarioOpt = loadJsonConfig(path);
+    if (!scenarioOpt) {
+        return false;
+    }
+    const auto& scenario = *scenarioOpt;
+    config.aircraftPath = scenario.value("aircraft", config.aircraftPath);
+    config.terrainPath = scenario.value("terrain", config.terrainPath);
+    config.durationSeconds = scenario.value("duration", config.durationSeconds);
+    config.rate = scenario.value("rate", config.rate);
+    config.workers = scenario.value("workers", config.workers);
+    config.traffic = scenario.value("traffic", config.traffic);
+
+    config.events.clear();
+    if (scenario.contains("controls") && scenario["controls"].is_object()) {
+        addControls(scenario["controls"], 0.0, config);
+    }
+    if (scenario.contains("events") && scenario["events"].is_array()) {
+        for (const auto& event : scenario["events"]) {
+            if (!event.contains("controls") || !event["controls"].is_object()) {
+                continue;
+            }
+            addControls(event["controls"], event.value("time", 0.0), config);
+        }
+    }
+    std::stable_sort(config.events.begin(), config.events.end(),
+                     [](const auto& a, const auto& b) { return a.time < b.time; });
+    return true;
+}
+
+bool parseHeadlessArgs(int argc, char** argv, HeadlessConfig& config) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--scenario" && !loadHeadlessScenario(argv[i + 1], config)) {
+            return false;
+        }
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            continue;
+        }
+        bool known = arg == "--scenario" || arg == "--aircraft" || arg == "--terrain" ||
+                     arg == "--duration" || arg == "--rate" || arg == "--report" ||
+                     arg == "--workers" || arg == "--traffic";
+        if (!known || i + 1 >= argc) {
+            std::cerr << (known ? "Missing value for " : "Unknown arg: ") << arg << "\n";
+            printUsage();
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--aircraft") {
+            config.aircraftPath = value;
+        } else if (arg == "--terrain") {
+            config.terrainPath = value;
+        } else if (arg == "--duration") {
+            config.durationSeconds = std::atof(value.c_str());
+        } else if (arg == "--rate") {
+            config.rate = std::max(0.0, std::atof(value.c_str()));
+        } else if (arg == "--report") {
+            config.reportPath = value;
+        } else if (arg == "--workers") {
+            config.workers = std::max(0, std::atoi(value.c_str()));
+        } else if (arg == "--traffic") {
+            config.traffic = std::max(0, std::atoi(value.c_str()));
+        }
+    }
+    if (config.durationSeconds <= 0.0) {
+        std::cerr << "[headless] duration must be positive\n";
+        printUsage();
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessRunner::init(const HeadlessConfig& config) {
+    m_config = config;
+    m_nextEvent = 0;
+
+    m_subsystems.add(std::make_shared<SimSubsystem>());
+    m_recorder = std::make_shared<FlightRecorder>();
+    m_subsystems.add(m_recorder);
+    m_subsystems.initAll();
+
+    m_atmosphere.init();
+    m_terrain.setupHeightsOnly(m_config.terrainPath);
+    m_aircraft.init(nullptr, m_atmosphere);
+    GeoOrigin origin;
+    const GeoOrigin* originPtr = nullptr;
+    if (m_terrain.hasCompiledOrigin()) {
+        origin = m_terrain.compiledOrigin();
+        originPtr = &origin;
+    }
+    m_aircraft.spawnPlayer(m_config.aircraftPath, originPtr, &m_terrain);
+    if (!m_aircraft.player()) {
+        std::cerr << "[headless] failed to spawn " << m_config.aircraftPath << std::endl;
+        return false;
+    }
+    for (int i = 0; i < m_config.traffic; ++i) {
+        m_aircraft.spawn(m_config.aircraftPath, originPtr, &m_terrain);
+    }
+    // Heights-only terrain already takes the deferred physics tile path, so
+    // instances can sample it from any worker.
+    m_aircraft.setWorkerThreads(m_config.workers);
+    if (m_recorder->enabled()) {
+        m_recorder->start(kFixedDt);
+    }
+    return true;
+}
+
+bool HeadlessRunner::run() {
+    using Clock = std::chrono::steady_clock;
+
+    Aircraft::Instance* player = m_aircraft.player();
+    if (!player) {
+        return false;
+    }
+    auto ticks = static_cast<std::uint64_t>(std::llround(m_config.durationSeconds / kFixedDt));
+    std::cout << "[headless] flying " << m_aircraft.all().size() << " x " << m_config.aircraftPath << " for "
+              << m_config.durationSeconds << " s";
+    if (m_config.rate > 0.0) {
+        std::cout << " at " << m_config.rate << "x real time";
+    }
+    std::cout << std::endl;
+
+    auto start = Clock::now();
+    double nextProgress = kProgressIntervalSeconds;
+    for (std::uint64_t tick = 0; tick < ticks; ++tick) {
+        double simTime = static_cast<double>(tick) * kFixedDt;
+        applyEvents(simTime);
+        m_subsystems.updateAll(kFixedDt);
+        m_aircraft.fixedUpdate(static_cast<float>(kFixedDt));
+        m_aircraft.applyGroundCollision(m_terrain);
+        m_terrain.updatePhysicsTiles();
+        m_recorder->record(player->currentState(), player->state(), PropertyBus::global());
+
+        double elapsed = simTime + kFixedDt;
+        if (elapsed >= nextProgress && tick + 1 < ticks) {
+            logProgress(elapsed);
+            nextProgress += kProgressIntervalSeconds;
+        }
+        if (m_config.rate > 0.0) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(elapsed / m_config.rate)));
+        }
+    }
+
+    double simSeconds = static_cast<double>(ticks) * kFixedDt;
+    double wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "[headless] " << ticks << " ticks, " << simSeconds << " s simulated in " << wallSeconds
+              << " s (" << simSeconds / std::max(wallSeconds, 1e-9) << "x real time)" << std::endl;
+    logProgress(simSeconds);
+    return m_config.reportPath.empty() || writeReport(ticks, simSeconds, wallSeconds);
+}
+
+void HeadlessRunner::shutdown() {
+    if (m_recorder) {
+        m_recorder->stop();
+    }
+    m_aircraft.shutdown();
+    m_terrain.shutdown();
+    m_subsystems.shutdownAll();
+}
+
+void HeadlessRunner::applyEvents(double simTime) {
+    // Half a tick of slack so an event at t lands on the tick at t despite
+    // rounding in tick * dt.
+    while (m_nextEvent < m_config.events.size() &&
+           m_config.events[m_nextEvent].time <= simTime + 0.5 * kFixedDt) {
+        const auto& event = m_config.events[m_nextEvent++];
+        PropertyBus::global().set(TypedProperty<double>(event.path.c_str()), event.value);
+    }
+}
+
+void HeadlessRunner::logProgress(double simTime) const {
+    const Aircraft::Instance* player = m_aircraft.player();
+    if (!player) {
+        return;
+    }
+    const PropertyBus& bus = player->state();
+    std::cout << "[headless] t=" << simTime << "s"
+              << " alt=" << bus.get(Properties::Position::ALTITUDE_FT, 0.0) << "ft"
+              << " agl=" << bus.get(Properties::Position::ALTITUDE_AGL_FT, 0.0) << "ft"
+              << " ias=" << bus.get(Properties::Velocities::AIRSPEED_IAS_KT, 0.0) << "kt"
+              << " hdg=" << bus.get(Properties::Orientation::HEADING_DEG, 0.0) << std::endl;
+}
+
+bool HeadlessRunner::writeReport(std::uint64_t ticks, double simSeconds, double wallSeconds) const {
+    const Aircraft::Instance* player = m_aircraft.player();
+    const PropertyBus& bus = player->state();
+    const AircraftState& state = player->currentState();
+
+    nlohmann::json report;
+    report["aircraft"] = m_config.aircraftPath;
+    report["terrain"] = m_config.terrainPath;
+    report["instances"] = m_aircraft.all().size();
+    report["workers"] = m_aircraft.workerThreads();
+    report["ticks"] = ticks;
+    report["simSeconds"] = simSeconds;
+    report["wallSeconds"] = wallSeconds;
+    report["realTimeFactor"] = simSeconds / std::max(wallSeconds, 1e-9);
+    report["final"] = {
+        {"position", {state.position.x, state.position.y, state.position.z}},
+        {"altitudeFt", bus.get(Properties::Position::ALTITUDE_FT, 0.0)},
+        {"altitudeAglFt", bus.get(Properties::Position::ALTITUDE_AGL_FT, 0.0)},
+        {"airspeedIasKt", bus.get(Properties::Velocities::AIRSPEED_IAS_KT, 0.0)},
+        {"groundSpeedKt", bus.get(Properties::Velocities::GROUND_SPEED_KT, 0.0)},
+        {"headingDeg", bus.get(Properties::Orientation::HEADING_DEG, 0.0)},
+        {"pitchDeg", bus.get(Properties::Orientation::PITCH_DEG, 0.0)},
+        {"rollDeg", bus.get(Properties::Orientation::ROLL_DEG, 0.0)},
+    };
+
+    std::ofstream out(m_config.reportPath);
+    out << report.dump(2) << "\n";
+    if (!out) {
+        std::cerr << "[headless] failed to write " << m_config.reportPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace nuage
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "aircraft/aircraft.hpp"
+#include "core/flight_recorder.hpp"
+#include "core/subsystem_manager.hpp"
+#include "environment/atmosphere.hpp"
+#include "graphics/renderers/terrain_renderer.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nuage {
+
+/**
+ * @brief What a headless run flies, from a scenario file and the command line.
+ *
+ * A scenario is a JSON file:
+ *   {
+ *     "aircraft": "assets/config/aircraft/c172p.json",
+ *     "terrain": "assets/config/terrain.json",
+ *     "duration": 120.0,
+ *     "rate": 0.0,
+ *     "workers": 1,
+ *     "traffic": 0,
+ *     "controls": { "controls/engines/current/throttle": 0.8 },
+ *     "events": [ { "time": 30.0, "controls": { "controls/flight/elevator": -0.1 } } ]
+ *   }
+ * "controls" is applied before the first tick and each event before the
+ * tick nearest its time; values are doubles written to the global bus.
+ * "traffic" adds that many more copies of the aircraft, flying the same
+ * controls, and "workers" is the thread count stepping them (0 = one per
+ * hardware thread).
+ */
+struct HeadlessConfig {
+    struct ControlEvent {
+        double time = 0.0;
+        std::string path;
+        double value = 0.0;
+    };
+
+    std::string aircraftPath = "assets/config/aircraft/c172p.json";
+    std::string terrainPath = "assets/config/terrain.json";
+    double durationSeconds = 60.0;
+    // Simulated seconds per wall-clock second; 0 runs as fast as possible.
+    double rate = 0.0;
+    int workers = 1;
+    int traffic = 0;
+    std::vector<ControlEvent> events;
+    // Optional JSON summary of the run, for scripts comparing runs.
+    std::string reportPath;
+};
+
+// Fills config from --scenario <file> and then the other flags, which
+// override the scenario. Returns false on a bad or missing argument.
+bool parseHeadlessArgs(int argc, char** argv, HeadlessConfig& config);
+bool loadHeadlessScenario(const std::string& path, HeadlessConfig& config);
+
+/**
+ * @brief Flies a scenario without a window, GL context, UI or audio.
+ *
+ * Terrain is set up heights-only, so ground contact and runways behave as in
+ * the app while nothing is drawn. Physics steps at the app's 1/120 s tick,
+ * on the calling thread or spread over workers, and a scenario replays tick
+ * for tick whatever the worker count.
+ */
+class HeadlessRunner {
+public:
+    bool init(const HeadlessConfig& config);
+    bool run();
+    void shutdown();
+
+private:
+    void applyEvents(double simTime);
+    void logProgress(double simTime) const;
+    bool writeReport(std::uint64_t ticks, double simSeconds, double wallSeconds) const;
+
+    HeadlessConfig m_config;
+    size_t m_nextEvent = 0;
+
+    SubsystemManager m_subsystems;
+    std::shared_ptr<FlightRecorder> m_recorder;
+    Atmosphere m_atmosphere;
+    TerrainRenderer m_terrain;
+    Aircraft m_aircraft;
+};
+
+} // namespace nuage
@@ -1,9 +1,29 @@
 #include "core/app.hpp"
+#include "core/headless_runner.hpp"
 #include "utils/config_loader.hpp"
 #include <iostream>
 #include <string>
 
-int main() {
+namespace {
+int runHeadless(int argc, char** argv) {
+    nuage::HeadlessConfig config;
+    if (!nuage::parseHeadlessArgs(argc, argv, config)) {
+        return 1;
+    }
+    nuage::HeadlessRunner runner;
+    bool ok = runner.init(config) && runner.run();
+    runner.shutdown();
+    return ok ? 0 : 1;
+}
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--headless") {
+            return runHeadless(argc, argv);
+        }
+    }
+
     auto configJson = nuage::loadJsonConfig("assets/config/simulator.json");
     
     nuage::AppConfig config;
@@ -17,6 +37,13 @@ int main() {
             windowTitle = win.value("title", "Nuage");
             config.vsync = win.value("vsync", true);
         }
+        if (configJson->contains("simulation")) {
+            const auto& sim = (*configJson)["simulation"];
+            config.physicsThread = sim.value("physicsThread", false);
+            if (sim.contains("physicsWorkers")) {
+                config.physicsWorkers = sim["physicsWorkers"].get<int>();
+            }
+        }
     }
     config.title = windowTitle.c_str();
 
@@ -0,0 +1,134 @@
+#include "core/physics_thread.hpp"
+#include "core/properties/property_paths.hpp"
+#include <iostream>
+#include <iterator>
+
+namespace nuage {
+
+namespace {
+// Queue room for several render frames of input if physics stalls.
+constexpr size_t kControlQueueFrames = 64;
+// Behind by more than this many ticks, the backlog is dropped.
+constexpr int kMaxCatchUpTicks = 4;
+
+const TypedProperty<double>* const kControlProperties[] = {
+    &Properties::Controls::ELEVATOR,
+    &Properties::Controls::AILERON,
+    &Properties::Controls::RUDDER,
+    &Properties::Controls::THROTTLE,
+    &Properties::Controls::FLAPS,
+    &Properties::Controls::ROLL_TRIM,
+    &Properties::Controls::BRAKE_LEFT,
+    &Properties::Controls::BRAKE_RIGHT,
+    &Properties::Controls::PARKING_BRAKE,
+};
+} // namespace
+
+PhysicsThread::PhysicsThread()
+    : m_controlQueue(kControlQueueFrames) {
+    static_assert(std::tuple_size<ControlFrame>::value == std::size(kControlProperties),
+                  "one frame value per control property");
+}
+
+PhysicsThread::~PhysicsThread() {
+    stop();
+}
+
+double PhysicsThread::now() {
+    return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+bool PhysicsThread::start(double dt, TickFn tick) {
+    stop();
+    if (dt <= 0.0 || !tick) {
+        return false;
+    }
+    m_dt = std::chrono::duration<double>(dt);
+    m_tick = std::move(tick);
+    m_stopping = false;
+    m_ticks.store(0);
+    m_droppedTicks.store(0);
+    m_thread = std::thread(&PhysicsThread::run, this);
+    std::cout << "[physics] stepping at " << 1.0 / dt << " Hz on a dedicated thread" << std::endl;
+    return true;
+}
+
+void PhysicsThread::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    m_tick = nullptr;
+    if (std::uint64_t dropped = m_droppedTicks.load()) {
+        std::cout << "[physics] dropped " << dropped << " ticks of " << m_ticks.load()
+                  << " to keep up with real time" << std::endl;
+    }
+}
+
+void PhysicsThread::setPaused(bool paused) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = paused;
+    }
+    m_wake.notify_one();
+}
+
+void PhysicsThread::pushControls(const PropertyBus& source) {
+    ControlFrame frame;
+    for (size_t i = 0; i < frame.size(); ++i) {
+        frame[i] = source.get(*kControlProperties[i]);
+    }
+    // A full queue means physics is stalled; it picks up newer input later.
+    m_controlQueue.push(frame);
+}
+
+void PhysicsThread::applyControls() {
+    ControlFrame frame;
+    bool any = false;
+    while (m_controlQueue.pop(frame)) {
+        any = true;
+    }
+    if (!any) {
+        return;
+    }
+    for (size_t i = 0; i < frame.size(); ++i) {
+        m_controls.set(*kControlProperties[i], frame[i]);
+    }
+}
+
+void PhysicsThread::run() {
+    auto dt = std::chrono::duration_cast<Clock::duration>(m_dt);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Clock::time_point next = Clock::now();
+    while (!m_stopping) {
+        if (m_paused) {
+            m_wake.wait(lock, [this] { return m_stopping || !m_paused; });
+            next = Clock::now();
+            continue;
+        }
+        if (m_wake.wait_until(lock, next, [this] { return m_stopping || m_paused; })) {
+            continue;
+        }
+        lock.unlock();
+
+        applyControls();
+        m_tick(std::chrono::duration<double>(next.time_since_epoch()).count());
+        m_ticks.fetch_add(1, std::memory_order_relaxed);
+
+        next += dt;
+        Clock::time_point now = Clock::now();
+        if (now - next > dt * kMaxCatchUpTicks) {
+            auto behind = (now - next) / dt;
+            m_droppedTicks.fetch_add(static_cast<std::uint64_t>(behind), std::memory_order_relaxed);
+            next += dt * behind;
+        }
+        lock.lock();
+    }
+}
+
+} // namespace nuage
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "core/properties/property_bus.hpp"
+#include "utils/spsc_queue.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace nuage {
+
+/**
+ * @brief Steps physics on its own thread at a fixed rate, paced to real time.
+ *
+ * Tick n runs no earlier than start + n * dt; when the thread falls more than
+ * a few ticks behind it drops the backlog instead of spiralling. The render
+ * thread never blocks on it: control inputs arrive through a lock-free queue
+ * and are applied to controls(), a bus only the physics thread touches once
+ * started, so aircraft bound to it read them without racing the UI.
+ *
+ * start(), stop() and anything that rebinds aircraft to controls() belong on
+ * the render thread while the physics thread is stopped.
+ */
+class PhysicsThread {
+public:
+    // Receives the steady-clock time, in seconds, the tick is scheduled for.
+    using TickFn = std::function<void(double tickTime)>;
+
+    PhysicsThread();
+    ~PhysicsThread();
+
+    PhysicsThread(const PhysicsThread&) = delete;
+    PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+    PropertyBus& controls() { return m_controls; }
+
+    bool start(double dt, TickFn tick);
+    void stop();
+    bool running() const { return m_thread.joinable(); }
+
+    void setPaused(bool paused);
+    // Render thread: queues source's control inputs for the next tick.
+    void pushControls(const PropertyBus& source);
+
+    double dt() const { return m_dt.count(); }
+    std::uint64_t ticks() const { return m_ticks.load(std::memory_order_relaxed); }
+    // Ticks whose time was dropped because the thread could not keep up.
+    std::uint64_t droppedTicks() const { return m_droppedTicks.load(std::memory_order_relaxed); }
+
+    static double now();
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using ControlFrame = std::array<double, 9>;
+
+    void run();
+    void applyControls();
+
+    PropertyBus m_controls;
+    SpscQueue<ControlFrame> m_controlQueue;
+    TickFn m_tick;
+    std::chrono::duration<double> m_dt{0.0};
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping = false;
+    bool m_paused = false;
+    std::atomic<std::uint64_t> m_ticks{0};
+    std::atomic<std::uint64_t> m_droppedTicks{0};
+};
+
+} // namespace nuage
@@ -1,4 +1,5 @@
 #include "core/properties/property_bus.hpp"
+#include <algorithm>
 
 namespace nuage {
 
@@ -7,7 +8,7 @@ PropertyId PropertyBus::getID(const std::string& key) {
 }
 
 bool PropertyBus::has(PropertyId id) const {
-    return m_data.find(id) != m_data.end();
+    return m_values.presentAny(id);
 }
 
 bool PropertyBus::has(const std::string& key) const {
@@ -15,16 +16,142 @@ bool PropertyBus::has(const std::string& key) const {
 }
 
 void PropertyBus::increment(PropertyId id, double delta) {
-    auto it = m_data.find(id);
-    if (it != m_data.end() && std::holds_alternative<double>(it->second)) {
-        std::get<double>(it->second) += delta;
-    } else {
-        m_data[id] = delta;
-    }
+    PropertySlot slot = PropertyRegistry::instance().slot<double>(id);
+    store<double>(slot, load<double>(slot, 0.0) + delta);
 }
 
 void PropertyBus::increment(const std::string& key, double delta) {
     increment(getID(key), delta);
 }
 
+void PropertyBus::trigger(const TypedProperty<int>& command) {
+    store<int>(command.slot, load<int>(command.slot, 0) + 1);
+}
+
+PropertySubscription PropertyBus::addSubscriber(PropertyType type, PropertySlot slot,
+                                                std::function<void(const PropertyValues&)> notify) {
+    Subscriber subscriber;
+    subscriber.id = m_nextSubscription++;
+    subscriber.type = type;
+    subscriber.slot = slot;
+    subscriber.notify = std::move(notify);
+    m_subscribers.push_back(std::move(subscriber));
+    m_values.setWatched(type, slot, true);
+    return m_subscribers.back().id;
+}
+
+void PropertyBus::unsubscribe(PropertySubscription subscription) {
+    auto it = std::find_if(m_subscribers.begin(), m_subscribers.end(),
+                           [subscription](const Subscriber& s) { return s.id == subscription; });
+    if (it == m_subscribers.end() || !it->notify) {
+        return;
+    }
+    PropertyType type = it->type;
+    PropertySlot slot = it->slot;
+    if (m_notifyDepth > 0) {
+        // A callback is running; leave the entry in place and sweep it later.
+        it->notify = nullptr;
+    } else {
+        m_subscribers.erase(it);
+    }
+    bool watched = std::any_of(m_subscribers.begin(), m_subscribers.end(), [&](const Subscriber& s) {
+        return s.notify && s.type == type && s.slot == slot;
+    });
+    m_values.setWatched(type, slot, watched);
+}
+
+void PropertyBus::notifySubscribers(PropertyType type, PropertySlot slot) {
+    ++m_notifyDepth;
+    // Index loop: callbacks may subscribe or write other properties.
+    for (size_t i = 0; i < m_subscribers.size(); ++i) {
+        if (m_subscribers[i].type == type && m_subscribers[i].slot == slot && m_subscribers[i].notify) {
+            auto notify = m_subscribers[i].notify;
+            notify(m_values);
+        }
+    }
+    if (--m_notifyDepth == 0) {
+        m_subscribers.erase(std::remove_if(m_subscribers.begin(), m_subscribers.end(),
+                                           [](const Subscriber& s) { return !s.notify; }),
+                            m_subscribers.end());
+    }
+}
+
+bool PropertyBus::addAlias(PropertyType type, PropertySlot slot, PropertyBus& source, PropertySlot sourceSlot) {
+    // Walk the source's chain; reaching this slot again would loop forever.
+    const PropertyBus* bus = &source;
+    PropertySlot current = sourceSlot;
+    while (true) {
+        if (bus == this && current == slot) {
+            return false;
+        }
+        auto next = std::find_if(bus->m_aliases.begin(), bus->m_aliases.end(),
+                                 [&](const Alias& a) { return a.type == type && a.slot == current; });
+        if (next == bus->m_aliases.end()) {
+            break;
+        }
+        bus = next->source;
+        current = next->sourceSlot;
+    }
+
+    removeAlias(type, slot);
+    Alias alias;
+    alias.type = type;
+    alias.slot = slot;
+    alias.source = &source;
+    alias.sourceSlot = sourceSlot;
+    m_aliases.push_back(alias);
+    m_values.setAlias(type, slot, static_cast<std::uint16_t>(m_aliases.size()));
+    return true;
+}
+
+void PropertyBus::removeAlias(PropertyType type, PropertySlot slot) {
+    auto it = std::find_if(m_aliases.begin(), m_aliases.end(),
+                           [&](const Alias& a) { return a.type == type && a.slot == slot; });
+    if (it == m_aliases.end()) {
+        return;
+    }
+    m_values.setAlias(type, slot, 0);
+    it = m_aliases.erase(it);
+    // Entries after the removed one moved down by one.
+    for (; it != m_aliases.end(); ++it) {
+        m_values.setAlias(it->type, it->slot, static_cast<std::uint16_t>(it - m_aliases.begin() + 1));
+    }
+}
+
+void PropertyBus::resolveAliases(PropertyValues& values) const {
+    for (const Alias& alias : m_aliases) {
+        switch (alias.type) {
+            case PropertyType::Double: mirrorAlias<double>(values, alias.slot); break;
+            case PropertyType::Vector: mirrorAlias<Vec3>(values, alias.slot); break;
+            case PropertyType::Rotation: mirrorAlias<Quat>(values, alias.slot); break;
+            case PropertyType::Int: mirrorAlias<int>(values, alias.slot); break;
+            case PropertyType::Bool: mirrorAlias<bool>(values, alias.slot); break;
+            case PropertyType::Count: break;
+        }
+    }
+}
+
+void PropertyBus::enableSnapshots() {
+    if (!m_snapshots) {
+        m_snapshots = std::make_unique<PropertySnapshotBuffers>(m_values);
+    }
+}
+
+bool PropertyBus::publish() {
+    if (!m_snapshots) {
+        return false;
+    }
+    if (m_aliases.empty()) {
+        return m_snapshots->publish(m_values);
+    }
+    return m_snapshots->publish(m_values, [this](PropertyValues& values) { resolveAliases(values); });
+}
+
+PropertySnapshot PropertyBus::snapshot() const {
+    if (m_snapshots) {
+        return m_snapshots->acquire();
+    }
+    return PropertySnapshot(&m_values, nullptr);
+}
+
 }
\ No newline at end of file
@@ -3,41 +3,66 @@
 #include "math/vec3.hpp"
 #include "math/quat.hpp"
 #include "core/properties/property_id.hpp"
+#include "core/properties/property_registry.hpp"
+#include "core/properties/property_snapshot.hpp"
+#include "core/properties/property_values.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
-#include <unordered_map>
-#include <variant>
-#include <optional>
+#include <vector>
 
 namespace nuage {
 
-using PropertyValue = std::variant<double, Vec3, Quat, int, bool>;
+using PropertySubscription = std::uint32_t;
 
+/**
+ * @brief Typed property storage keyed by registry slot.
+ *
+ * TypedProperty access is an indexed load or store. Ids and strings are
+ * resolved through the registry first, which hashes and locks, so keep those
+ * off per-tick paths. A key holds one value per type; reading it as a type it
+ * was never written with returns the fallback.
+ *
+ * The bus itself belongs to one thread. Other threads read it through
+ * snapshots: after enableSnapshots() the owner calls publish() at a defined
+ * point, such as the end of a physics tick, and snapshot() hands out the most
+ * recently published values without locking.
+ *
+ * Every slot carries a version that bumps only when a write changes its
+ * value, so consumers can compare versions to skip unchanged properties.
+ * Subscribers are called on the writing thread right after such a write;
+ * commands are int counters bumped by trigger() and delivered this way.
+ *
+ * A slot can be aliased to a slot on another bus. Reads, writes and versions
+ * then go straight to the source, so nothing is copied per tick, and
+ * publish() fills snapshots from the source. Subscribe on the source bus to
+ * hear about its changes.
+ */
 class PropertyBus {
 public:
     static PropertyId getID(const std::string& key);
 
     template<typename T>
     void set(PropertyId id, const T& value) {
-        m_data[id] = value;
+        store<T>(PropertyRegistry::instance().slot<T>(id), value);
     }
 
     template<typename T>
     T get(PropertyId id, const T& fallback = T()) const {
-        auto it = m_data.find(id);
-        if (it != m_data.end() && std::holds_alternative<T>(it->second)) {
-            return std::get<T>(it->second);
-        }
-        return fallback;
+        return load<T>(PropertyRegistry::instance().find<T>(id), fallback);
     }
 
+    // The value is converted to the property's type, so e.g. a float can be
+    // written to a double property.
     template<typename T>
-    void set(const TypedProperty<T>& prop, const T& value) {
-        set<T>(prop.id, value);
+    void set(const TypedProperty<T>& prop, const typename TypedProperty<T>::value_type& value) {
+        store<T>(prop.slot, value);
     }
 
     template<typename T>
-    T get(const TypedProperty<T>& prop, const T& fallback = T()) const {
-        return get<T>(prop.id, fallback);
+    T get(const TypedProperty<T>& prop, const typename TypedProperty<T>::value_type& fallback = T()) const {
+        return load<T>(prop.slot, fallback);
     }
 
     template<typename T>
@@ -50,19 +75,177 @@ public:
         return get<T>(getID(key), fallback);
     }
 
+    template<typename T>
+    bool has(const TypedProperty<T>& prop) const {
+        return present<T>(prop.slot);
+    }
+
     bool has(PropertyId id) const;
     bool has(const std::string& key) const;
 
     void increment(PropertyId id, double delta);
     void increment(const std::string& key, double delta);
 
+    template<typename T>
+    std::uint32_t version(const TypedProperty<T>& prop) const {
+        return version<T>(prop.slot);
+    }
+
+    // Calls callback with the new value whenever a write changes the property.
+    template<typename T>
+    PropertySubscription subscribe(const TypedProperty<T>& prop,
+                                   std::function<void(const typename TypedProperty<T>::value_type&)> callback) {
+        PropertySlot slot = prop.slot;
+        return addSubscriber(PropertyTypeOf<T>::value, slot,
+            [slot, callback = std::move(callback)](const PropertyValues& values) {
+                callback(values.load<T>(slot, defaultPropertyValue<T>()));
+            });
+    }
+
+    void unsubscribe(PropertySubscription subscription);
+
+    // Routes prop on this bus to sourceProp on source, which must outlive the
+    // alias. Aliasing an aliased slot again replaces its source. Returns false
+    // if the alias would lead back to prop itself.
+    template<typename T>
+    bool alias(const TypedProperty<T>& prop, PropertyBus& source, const TypedProperty<T>& sourceProp) {
+        return addAlias(PropertyTypeOf<T>::value, prop.slot, source, sourceProp.slot);
+    }
+
+    template<typename T>
+    bool alias(const TypedProperty<T>& prop, PropertyBus& source) {
+        return alias(prop, source, prop);
+    }
+
+    // Detaches prop from its source; it reads as unset until written again.
+    template<typename T>
+    void unalias(const TypedProperty<T>& prop) {
+        removeAlias(PropertyTypeOf<T>::value, prop.slot);
+    }
+
+    template<typename T>
+    bool aliased(const TypedProperty<T>& prop) const {
+        return !m_aliases.empty() && m_values.alias<T>(prop.slot) != 0;
+    }
+
+    // Bumps a command counter, notifying its subscribers.
+    void trigger(const TypedProperty<int>& command);
+
+    void enableSnapshots();
+    bool snapshotsEnabled() const { return m_snapshots != nullptr; }
+    // Publishes the current values to snapshot readers. Returns false if
+    // snapshots are disabled or every back buffer is still held.
+    bool publish();
+    // Latest published values, or a view of the live values when snapshots
+    // are disabled (owner thread only).
+    PropertySnapshot snapshot() const;
+
     static PropertyBus& global() {
         static PropertyBus instance;
         return instance;
     }
-    
+
 private:
-    std::unordered_map<PropertyId, PropertyValue> m_data;
+    struct Subscriber {
+        PropertySubscription id = 0;
+        PropertyType type = PropertyType::Double;
+        PropertySlot slot = kInvalidPropertySlot;
+        std::function<void(const PropertyValues&)> notify;
+    };
+
+    struct Alias {
+        PropertyType type = PropertyType::Double;
+        PropertySlot slot = kInvalidPropertySlot;
+        PropertyBus* source = nullptr;
+        PropertySlot sourceSlot = kInvalidPropertySlot;
+    };
+
+    // Source of an aliased slot, or null. Buses without aliases skip the lookup.
+    template<typename T>
+    const Alias* aliasOf(PropertySlot slot) const {
+        if (m_aliases.empty()) {
+            return nullptr;
+        }
+        std::uint16_t index = m_values.alias<T>(slot);
+        return index ? &m_aliases[index - 1] : nullptr;
+    }
+
+    // The alias check rides on the slot lookup both calls already make.
+    template<typename T>
+    void store(PropertySlot slot, const T& value) {
+        std::uint16_t alias = 0;
+        if (m_values.store<T>(slot, value, alias)) {
+            notifySubscribers(PropertyTypeOf<T>::value, slot);
+        } else if (alias) {
+            storeAliased<T>(m_aliases[alias - 1], value);
+        }
+    }
+
+    template<typename T>
+    T load(PropertySlot slot, const T& fallback) const {
+        std::uint16_t alias = 0;
+        T value = m_values.load<T>(slot, fallback, alias);
+        if (alias) {
+            return loadAliased<T>(m_aliases[alias - 1], fallback);
+        }
+        return value;
+    }
+
+    // Separate functions so the recursion does not stop store() and load()
+    // from inlining.
+    template<typename T>
+    static void storeAliased(const Alias& alias, const T& value) {
+        alias.source->store<T>(alias.sourceSlot, value);
+    }
+
+    template<typename T>
+    static T loadAliased(const Alias& alias, const T& fallback) {
+        return alias.source->load<T>(alias.sourceSlot, fallback);
+    }
+
+    template<typename T>
+    bool present(PropertySlot slot) const {
+        if (const Alias* alias = aliasOf<T>(slot)) {
+            return alias->source->present<T>(alias->sourceSlot);
+        }
+        return m_values.present<T>(slot);
+    }
+
+    template<typename T>
+    std::uint32_t version(PropertySlot slot) const {
+        if (const Alias* alias = aliasOf<T>(slot)) {
+            return alias->source->version<T>(alias->sourceSlot);
+        }
+        return m_values.version<T>(slot);
+    }
+
+    bool addAlias(PropertyType type, PropertySlot slot, PropertyBus& source, PropertySlot sourceSlot);
+    void removeAlias(PropertyType type, PropertySlot slot);
+    // Copies the value behind an aliased slot, following chains to the end.
+    template<typename T>
+    void mirrorAlias(PropertyValues& values, PropertySlot slot) const {
+        const PropertyBus* bus = this;
+        PropertySlot source = slot;
+        while (const Alias* alias = bus->aliasOf<T>(source)) {
+            bus = alias->source;
+            source = alias->sourceSlot;
+        }
+        values.mirror<T>(slot, bus->m_values, source);
+    }
+
+    // Writes the current source values of aliased slots into a published copy.
+    void resolveAliases(PropertyValues& values) const;
+
+    PropertySubscription addSubscriber(PropertyType type, PropertySlot slot,
+                                       std::function<void(const PropertyValues&)> notify);
+    void notifySubscribers(PropertyType type, PropertySlot slot);
+
+    PropertyValues m_values;
+    std::unique_ptr<PropertySnapshotBuffers> m_snapshots;
+    std::vector<Subscriber> m_subscribers;
+    std::vector<Alias> m_aliases;
+    PropertySubscription m_nextSubscription = 1;
+    int m_notifyDepth = 0;
 };
 
 }
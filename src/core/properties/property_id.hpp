@@ -26,16 +26,4 @@ constexpr PropertyId operator"" _id(const char* str, size_t n) {
     return hashString(str, n);
 }
 
-/**
- * @brief A property key that carries its type information for safe and clean API usage.
- */
-template<typename T>
-struct TypedProperty {
-    PropertyId id;
-
-    constexpr TypedProperty(const char* name) : id(hashString(name)) {}
-
-    constexpr operator PropertyId() const { return id; }
-};
-
 }
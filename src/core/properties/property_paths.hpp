@@ -1,63 +1,63 @@
 #pragma once
 
-#include "core/properties/property_id.hpp"
-#include "math/vec3.hpp"
-#include "math/quat.hpp"
+#include "core/properties/property_registry.hpp"
 
 namespace nuage {
 namespace Properties {
 
 namespace Controls {
-    inline constexpr TypedProperty<double> ELEVATOR("controls/flight/elevator");
-    inline constexpr TypedProperty<double> AILERON("controls/flight/aileron");
-    inline constexpr TypedProperty<double> RUDDER("controls/flight/rudder");
-    inline constexpr TypedProperty<double> THROTTLE("controls/engines/current/throttle");
-    inline constexpr TypedProperty<double> FLAPS("controls/flight/flaps");
-    inline constexpr TypedProperty<double> ROLL_TRIM("controls/flight/roll-trim");
-    inline constexpr TypedProperty<double> BRAKE_LEFT("controls/gear/brake-left");
-    inline constexpr TypedProperty<double> BRAKE_RIGHT("controls/gear/brake-right");
-    inline constexpr TypedProperty<double> PARKING_BRAKE("controls/gear/parking-brake");
+    inline const TypedProperty<double> ELEVATOR("controls/flight/elevator");
+    inline const TypedProperty<double> AILERON("controls/flight/aileron");
+    inline const TypedProperty<double> RUDDER("controls/flight/rudder");
+    inline const TypedProperty<double> THROTTLE("controls/engines/current/throttle");
+    inline const TypedProperty<double> FLAPS("controls/flight/flaps");
+    inline const TypedProperty<double> ROLL_TRIM("controls/flight/roll-trim");
+    inline const TypedProperty<double> BRAKE_LEFT("controls/gear/brake-left");
+    inline const TypedProperty<double> BRAKE_RIGHT("controls/gear/brake-right");
+    inline const TypedProperty<double> PARKING_BRAKE("controls/gear/parking-brake");
 }
 
 namespace Atmosphere {
-    inline constexpr TypedProperty<double> DENSITY("atmosphere/density");
-    inline constexpr TypedProperty<Vec3> WIND_PREFIX("atmosphere/wind");
+    inline const TypedProperty<double> DENSITY("atmosphere/density");
+    inline const TypedProperty<Vec3> WIND_PREFIX("atmosphere/wind");
 }
 
 namespace Velocities {
-    inline constexpr TypedProperty<double> AIRSPEED_KT("velocities/airspeed-kt");
-    inline constexpr TypedProperty<double> AIRSPEED_IAS_KT("velocities/airspeed-ias-kt");
-    inline constexpr TypedProperty<double> GROUND_SPEED_KT("velocities/groundspeed-kt");
-    inline constexpr TypedProperty<double> VERTICAL_SPEED_FPS("velocities/vertical-speed-fps");
+    inline const TypedProperty<double> AIRSPEED_KT("velocities/airspeed-kt");
+    inline const TypedProperty<double> AIRSPEED_IAS_KT("velocities/airspeed-ias-kt");
+    inline const TypedProperty<double> GROUND_SPEED_KT("velocities/groundspeed-kt");
+    inline const TypedProperty<double> VERTICAL_SPEED_FPS("velocities/vertical-speed-fps");
 }
 
 namespace Position {
-    inline constexpr TypedProperty<double> ALTITUDE_FT("position/altitude-ft");
-    inline constexpr TypedProperty<double> ALTITUDE_AGL_FT("position/altitude-agl-ft");
-    inline constexpr TypedProperty<double> LATITUDE_DEG("position/latitude-deg");
-    inline constexpr TypedProperty<double> LONGITUDE_DEG("position/longitude-deg");
+    inline const TypedProperty<double> ALTITUDE_FT("position/altitude-ft");
+    inline const TypedProperty<double> ALTITUDE_AGL_FT("position/altitude-agl-ft");
+    inline const TypedProperty<double> LATITUDE_DEG("position/latitude-deg");
+    inline const TypedProperty<double> LONGITUDE_DEG("position/longitude-deg");
 }
 
 namespace Orientation {
-    inline constexpr TypedProperty<double> PITCH_DEG("orientation/pitch-deg");
-    inline constexpr TypedProperty<double> ROLL_DEG("orientation/roll-deg");
-    inline constexpr TypedProperty<double> HEADING_DEG("orientation/heading-deg");
+    inline const TypedProperty<double> PITCH_DEG("orientation/pitch-deg");
+    inline const TypedProperty<double> ROLL_DEG("orientation/roll-deg");
+    inline const TypedProperty<double> HEADING_DEG("orientation/heading-deg");
 }
 
 namespace Surfaces {
-    inline constexpr TypedProperty<double> FLAPS_DEG("surfaces/flaps/position-deg");
-    inline constexpr TypedProperty<double> FLAPS_NORM("surfaces/flaps/position-norm");
+    inline const TypedProperty<double> FLAPS_DEG("surfaces/flaps/position-deg");
+    inline const TypedProperty<double> FLAPS_NORM("surfaces/flaps/position-norm");
 }
 
 namespace Sim {
-    inline constexpr TypedProperty<bool> PAUSED("sim/paused");
-    inline constexpr TypedProperty<bool> QUIT_REQUESTED("sim/quit-requested");
-    inline constexpr TypedProperty<double> TIME("sim/time");
-    inline constexpr TypedProperty<bool> DEBUG_VISIBLE("sim/debug-visible");
+    inline const TypedProperty<bool> PAUSED("sim/paused");
+    inline const TypedProperty<bool> QUIT_REQUESTED("sim/quit-requested");
+    inline const TypedProperty<double> TIME("sim/time");
+    inline const TypedProperty<bool> DEBUG_VISIBLE("sim/debug-visible");
+    // Commands: counters bumped by PropertyBus::trigger().
+    inline const TypedProperty<int> TOGGLE_CAMERA("sim/commands/toggle-camera");
 }
 
 namespace Audio {
-    inline constexpr TypedProperty<bool> MUTED("audio/muted");
+    inline const TypedProperty<bool> MUTED("audio/muted");
 }
 
 } // namespace Properties
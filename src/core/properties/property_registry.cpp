@@ -0,0 +1,51 @@
+#include "core/properties/property_registry.hpp"
+
+namespace nuage {
+
+namespace {
+
+std::array<PropertySlot, kPropertyTypeCount> emptySlots() {
+    std::array<PropertySlot, kPropertyTypeCount> slots;
+    slots.fill(kInvalidPropertySlot);
+    return slots;
+}
+
+}
+
+PropertyRegistry& PropertyRegistry::instance() {
+    static PropertyRegistry registry;
+    return registry;
+}
+
+PropertySlot PropertyRegistry::slot(PropertyId id, PropertyType type) {
+    size_t index = static_cast<size_t>(type);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_slots.find(id);
+    if (it == m_slots.end()) {
+        it = m_slots.emplace(id, emptySlots()).first;
+    }
+    PropertySlot& slot = it->second[index];
+    if (slot == kInvalidPropertySlot) {
+        slot = m_counts[index]++;
+    }
+    return slot;
+}
+
+PropertySlot PropertyRegistry::find(PropertyId id, PropertyType type) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_slots.find(id);
+    return it != m_slots.end() ? it->second[static_cast<size_t>(type)] : kInvalidPropertySlot;
+}
+
+std::array<PropertySlot, kPropertyTypeCount> PropertyRegistry::slots(PropertyId id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_slots.find(id);
+    return it != m_slots.end() ? it->second : emptySlots();
+}
+
+size_t PropertyRegistry::slotCount(PropertyType type) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_counts[static_cast<size_t>(type)];
+}
+
+}
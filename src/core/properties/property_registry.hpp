@@ -0,0 +1,86 @@
+#pragma once
+
+#include "core/properties/property_id.hpp"
+#include "math/vec3.hpp"
+#include "math/quat.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace nuage {
+
+enum class PropertyType : std::uint8_t {
+    Double = 0,
+    Vector,
+    Rotation,
+    Int,
+    Bool,
+    Count,
+};
+
+constexpr size_t kPropertyTypeCount = static_cast<size_t>(PropertyType::Count);
+
+template<typename T> struct PropertyTypeOf;
+template<> struct PropertyTypeOf<double> { static constexpr PropertyType value = PropertyType::Double; };
+template<> struct PropertyTypeOf<Vec3> { static constexpr PropertyType value = PropertyType::Vector; };
+template<> struct PropertyTypeOf<Quat> { static constexpr PropertyType value = PropertyType::Rotation; };
+template<> struct PropertyTypeOf<int> { static constexpr PropertyType value = PropertyType::Int; };
+template<> struct PropertyTypeOf<bool> { static constexpr PropertyType value = PropertyType::Bool; };
+
+using PropertySlot = std::uint32_t;
+constexpr PropertySlot kInvalidPropertySlot = std::numeric_limits<PropertySlot>::max();
+
+/**
+ * @brief Process-wide mapping from property ids to dense per-type slot indices.
+ *
+ * Every bus lays its values out by these slots, so a slot resolved once is
+ * valid on all buses. Slots are never released.
+ */
+class PropertyRegistry {
+public:
+    static PropertyRegistry& instance();
+
+    // Returns the id's slot for this type, assigning the next free one if needed.
+    PropertySlot slot(PropertyId id, PropertyType type);
+    // Returns the id's slot for this type, or kInvalidPropertySlot if it has none.
+    PropertySlot find(PropertyId id, PropertyType type) const;
+    // Every slot registered for the id, kInvalidPropertySlot for unused types.
+    std::array<PropertySlot, kPropertyTypeCount> slots(PropertyId id) const;
+    size_t slotCount(PropertyType type) const;
+
+    template<typename T>
+    PropertySlot slot(PropertyId id) { return slot(id, PropertyTypeOf<T>::value); }
+
+    template<typename T>
+    PropertySlot find(PropertyId id) const { return find(id, PropertyTypeOf<T>::value); }
+
+private:
+    PropertyRegistry() = default;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<PropertyId, std::array<PropertySlot, kPropertyTypeCount>> m_slots;
+    std::array<PropertySlot, kPropertyTypeCount> m_counts{};
+};
+
+/**
+ * @brief A property key that carries its type information for safe and clean API usage.
+ *
+ * The slot is resolved through the registry on construction, so declare these
+ * once (see property_paths.hpp) and reuse them on hot paths.
+ */
+template<typename T>
+struct TypedProperty {
+    using value_type = T;
+
+    PropertyId id;
+    PropertySlot slot;
+
+    explicit TypedProperty(const char* name)
+        : id(hashString(name)), slot(PropertyRegistry::instance().slot<T>(id)) {}
+
+    explicit operator PropertyId() const { return id; }
+};
+
+}
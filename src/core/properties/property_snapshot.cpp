@@ -0,0 +1,39 @@
+#include "core/properties/property_snapshot.hpp"
+
+namespace nuage {
+
+PropertySnapshotBuffers::PropertySnapshotBuffers(const PropertyValues& initial) {
+    m_buffers[0] = initial;
+}
+
+bool PropertySnapshotBuffers::publish(const PropertyValues& values,
+                                      const std::function<void(PropertyValues&)>& finish) {
+    std::uint32_t front = m_front.load(std::memory_order_relaxed);
+    for (std::uint32_t i = 0; i < kBufferCount; ++i) {
+        if (i == front || m_readers[i].load() != 0) {
+            continue;
+        }
+        // A reader that bumps this count after the check above rechecks the
+        // front, sees it is not i and backs off without reading.
+        m_buffers[i] = values;
+        if (finish) {
+            finish(m_buffers[i]);
+        }
+        m_front.store(i);
+        return true;
+    }
+    return false;
+}
+
+PropertySnapshot PropertySnapshotBuffers::acquire() {
+    while (true) {
+        std::uint32_t front = m_front.load();
+        m_readers[front].fetch_add(1);
+        if (m_front.load() == front) {
+            return PropertySnapshot(&m_buffers[front], &m_readers[front]);
+        }
+        m_readers[front].fetch_sub(1);
+    }
+}
+
+}
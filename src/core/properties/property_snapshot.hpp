@@ -0,0 +1,118 @@
+#pragma once
+
+#include "core/properties/property_values.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace nuage {
+
+/**
+ * @brief Read handle on a published set of property values.
+ *
+ * The values it points at are not rewritten while the handle is alive, so
+ * every read through it, Vec3 and Quat included, comes from the same
+ * publish. Hold one for a frame or a tick, not indefinitely: a pinned buffer
+ * cannot be reused by the publisher.
+ */
+class PropertySnapshot {
+public:
+    PropertySnapshot() = default;
+    ~PropertySnapshot() { release(); }
+    PropertySnapshot(const PropertySnapshot&) = delete;
+    PropertySnapshot& operator=(const PropertySnapshot&) = delete;
+    PropertySnapshot(PropertySnapshot&& other) noexcept
+        : m_values(other.m_values), m_readers(other.m_readers) {
+        other.m_values = nullptr;
+        other.m_readers = nullptr;
+    }
+    PropertySnapshot& operator=(PropertySnapshot&& other) noexcept {
+        if (this != &other) {
+            release();
+            m_values = other.m_values;
+            m_readers = other.m_readers;
+            other.m_values = nullptr;
+            other.m_readers = nullptr;
+        }
+        return *this;
+    }
+
+    bool valid() const { return m_values != nullptr; }
+
+    template<typename T>
+    T get(const TypedProperty<T>& prop, const typename TypedProperty<T>::value_type& fallback = T()) const {
+        return m_values ? m_values->load<T>(prop.slot, fallback) : fallback;
+    }
+
+    template<typename T>
+    T get(PropertyId id, const T& fallback = T()) const {
+        return m_values ? m_values->load<T>(PropertyRegistry::instance().find<T>(id), fallback) : fallback;
+    }
+
+    template<typename T>
+    T get(const std::string& key, const T& fallback = T()) const {
+        return get<T>(hashString(key.c_str(), key.length()), fallback);
+    }
+
+    template<typename T>
+    bool has(const TypedProperty<T>& prop) const {
+        return m_values && m_values->present<T>(prop.slot);
+    }
+
+    template<typename T>
+    std::uint32_t version(const TypedProperty<T>& prop) const {
+        return m_values ? m_values->version<T>(prop.slot) : 0;
+    }
+
+private:
+    friend class PropertyBus;
+    friend class PropertySnapshotBuffers;
+
+    // readers is null for a view of a bus's live values.
+    PropertySnapshot(const PropertyValues* values, std::atomic<std::uint32_t>* readers)
+        : m_values(values), m_readers(readers) {}
+
+    void release() {
+        if (m_readers) {
+            m_readers->fetch_sub(1, std::memory_order_release);
+        }
+        m_values = nullptr;
+        m_readers = nullptr;
+    }
+
+    const PropertyValues* m_values = nullptr;
+    std::atomic<std::uint32_t>* m_readers = nullptr;
+};
+
+/**
+ * @brief Lock-free publication of property values from one writer thread to
+ * any number of reader threads.
+ *
+ * publish() copies into a buffer that is neither the front nor held by a
+ * reader, then makes it the front. acquire() pins the front by bumping its
+ * reader count and rechecking that it is still the front, so the writer never
+ * copies into a buffer a reader can see. With four buffers the writer always
+ * finds a free one while at most two snapshots are held at once.
+ */
+class PropertySnapshotBuffers {
+public:
+    static constexpr size_t kBufferCount = 4;
+
+    explicit PropertySnapshotBuffers(const PropertyValues& initial);
+
+    // Single writer. finish, if set, adjusts the copy before readers can see
+    // it. Returns false, leaving the front unchanged, if every back buffer is
+    // still pinned by readers.
+    bool publish(const PropertyValues& values,
+                 const std::function<void(PropertyValues&)>& finish = nullptr);
+    PropertySnapshot acquire();
+
+private:
+    std::array<PropertyValues, kBufferCount> m_buffers;
+    std::array<std::atomic<std::uint32_t>, kBufferCount> m_readers{};
+    std::atomic<std::uint32_t> m_front{0};
+};
+
+}
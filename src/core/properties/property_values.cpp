@@ -0,0 +1,36 @@
+#include "core/properties/property_values.hpp"
+
+namespace nuage {
+
+bool PropertyValues::presentAny(PropertyId id) const {
+    auto registered = PropertyRegistry::instance().slots(id);
+    return present<double>(registered[static_cast<size_t>(PropertyType::Double)])
+        || present<Vec3>(registered[static_cast<size_t>(PropertyType::Vector)])
+        || present<Quat>(registered[static_cast<size_t>(PropertyType::Rotation)])
+        || present<int>(registered[static_cast<size_t>(PropertyType::Int)])
+        || present<bool>(registered[static_cast<size_t>(PropertyType::Bool)]);
+}
+
+void PropertyValues::setWatched(PropertyType type, PropertySlot slot, bool watched) {
+    switch (type) {
+        case PropertyType::Double: ensure<double>(slot).watched = watched; break;
+        case PropertyType::Vector: ensure<Vec3>(slot).watched = watched; break;
+        case PropertyType::Rotation: ensure<Quat>(slot).watched = watched; break;
+        case PropertyType::Int: ensure<int>(slot).watched = watched; break;
+        case PropertyType::Bool: ensure<bool>(slot).watched = watched; break;
+        case PropertyType::Count: break;
+    }
+}
+
+void PropertyValues::setAlias(PropertyType type, PropertySlot slot, std::uint16_t alias) {
+    switch (type) {
+        case PropertyType::Double: setAlias<double>(slot, alias); break;
+        case PropertyType::Vector: setAlias<Vec3>(slot, alias); break;
+        case PropertyType::Rotation: setAlias<Quat>(slot, alias); break;
+        case PropertyType::Int: setAlias<int>(slot, alias); break;
+        case PropertyType::Bool: setAlias<bool>(slot, alias); break;
+        case PropertyType::Count: break;
+    }
+}
+
+}
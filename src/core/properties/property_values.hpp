@@ -0,0 +1,176 @@
+#pragma once
+
+#include "math/vec3.hpp"
+#include "math/quat.hpp"
+#include "core/properties/property_registry.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace nuage {
+
+// Value held by a slot that was never written (Quat has no default constructor).
+template<typename T>
+T defaultPropertyValue() {
+    return T();
+}
+
+template<>
+inline Quat defaultPropertyValue<Quat>() {
+    return Quat::identity();
+}
+
+template<typename T>
+bool samePropertyValue(const T& a, const T& b) {
+    return a == b;
+}
+
+inline bool samePropertyValue(const Vec3& a, const Vec3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+inline bool samePropertyValue(const Quat& a, const Quat& b) {
+    return a.w == b.w && a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+/**
+ * @brief Property values laid out by registry slot, one contiguous array per type.
+ *
+ * Shared by PropertyBus and its published snapshots, so copying one into the
+ * other is a handful of flat array copies.
+ */
+class PropertyValues {
+public:
+    // Writes the value, bumping the slot's version if it changed. Returns true
+    // when a changed value has subscribers to notify. An aliased slot is left
+    // alone and its alias index is returned through alias.
+    template<typename T>
+    bool store(PropertySlot slot, const T& value, std::uint16_t& alias) {
+        Slot<T>& entry = ensure<T>(slot);
+        if (entry.alias) {
+            alias = entry.alias;
+            return false;
+        }
+        if (entry.present && samePropertyValue(entry.value, value)) {
+            return false;
+        }
+        entry.value = value;
+        entry.present = true;
+        ++entry.version;
+        return entry.watched;
+    }
+
+    template<typename T>
+    T load(PropertySlot slot, const T& fallback) const {
+        const Slots<T>& values = slots<T>();
+        if (slot < values.size() && values[slot].present) {
+            return values[slot].value;
+        }
+        return fallback;
+    }
+
+    // Like load(), but reports an aliased slot's index through alias.
+    template<typename T>
+    T load(PropertySlot slot, const T& fallback, std::uint16_t& alias) const {
+        const Slots<T>& values = slots<T>();
+        if (slot < values.size()) {
+            const Slot<T>& entry = values[slot];
+            if (entry.present) {
+                return entry.value;
+            }
+            alias = entry.alias;
+        }
+        return fallback;
+    }
+
+    template<typename T>
+    bool present(PropertySlot slot) const {
+        const Slots<T>& values = slots<T>();
+        return slot < values.size() && values[slot].present;
+    }
+
+    // Number of changes written to the slot; 0 until it is first set.
+    template<typename T>
+    std::uint32_t version(PropertySlot slot) const {
+        const Slots<T>& values = slots<T>();
+        return slot < values.size() ? values[slot].version : 0;
+    }
+
+    // 1-based index into the owning bus's alias table, 0 if not aliased.
+    template<typename T>
+    std::uint16_t alias(PropertySlot slot) const {
+        const Slots<T>& values = slots<T>();
+        return slot < values.size() ? values[slot].alias : 0;
+    }
+
+    // Points a slot at the owning bus's alias table (0 detaches it). An
+    // aliased slot holds no value of its own.
+    void setAlias(PropertyType type, PropertySlot slot, std::uint16_t alias);
+
+    // Copies value, version and presence from another set's slot, leaving
+    // this slot's subscription and alias marks alone.
+    template<typename T>
+    void mirror(PropertySlot slot, const PropertyValues& source, PropertySlot sourceSlot) {
+        Slot<T>& entry = ensure<T>(slot);
+        const Slots<T>& values = source.slots<T>();
+        if (sourceSlot < values.size()) {
+            entry.value = values[sourceSlot].value;
+            entry.version = values[sourceSlot].version;
+            entry.present = values[sourceSlot].present;
+        } else {
+            entry.value = defaultPropertyValue<T>();
+            entry.version = 0;
+            entry.present = false;
+        }
+    }
+
+    // True if the id holds a value of any type.
+    bool presentAny(PropertyId id) const;
+    // Marks a slot as having subscribers, so store() reports its changes.
+    void setWatched(PropertyType type, PropertySlot slot, bool watched);
+
+private:
+    template<typename T>
+    struct Slot {
+        T value = defaultPropertyValue<T>();
+        std::uint32_t version = 0;
+        bool present = false;
+        bool watched = false;
+        std::uint16_t alias = 0;
+    };
+
+    template<typename T>
+    using Slots = std::vector<Slot<T>>;
+
+    template<typename T>
+    Slots<T>& slots() { return std::get<Slots<T>>(m_slots); }
+
+    template<typename T>
+    const Slots<T>& slots() const { return std::get<Slots<T>>(m_slots); }
+
+    template<typename T>
+    void setAlias(PropertySlot slot, std::uint16_t alias) {
+        Slot<T>& entry = ensure<T>(slot);
+        entry.alias = alias;
+        if (alias) {
+            entry.value = defaultPropertyValue<T>();
+            entry.present = false;
+        }
+    }
+
+    template<typename T>
+    Slot<T>& ensure(PropertySlot slot) {
+        Slots<T>& values = slots<T>();
+        if (slot >= values.size()) {
+            // Size to every slot registered so far so the array grows rarely.
+            size_t registered = PropertyRegistry::instance().slotCount(PropertyTypeOf<T>::value);
+            values.resize(std::max<size_t>(registered, static_cast<size_t>(slot) + 1));
+        }
+        return values[slot];
+    }
+
+    std::tuple<Slots<double>, Slots<Vec3>, Slots<Quat>, Slots<int>, Slots<bool>> m_slots;
+};
+
+}
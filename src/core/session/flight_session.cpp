@@ -22,7 +22,7 @@ bool FlightSession::init() {
     m_atmosphere.init();
     m_atmosphere.setTimeOfDay(m_config.timeOfDay);
     
-    m_aircraft.init(*assets, m_atmosphere);
+    m_aircraft.init(assets.get(), m_atmosphere);
     m_camera.init(m_app->input());
     m_skybox.init(*assets);
     m_terrain.init(*assets);
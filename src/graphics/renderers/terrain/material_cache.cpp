@@ -0,0 +1,248 @@
+#include "graphics/renderers/terrain/material_cache.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace nuage {
+namespace {
+
+constexpr char kMagic[4] = {'N', 'M', 'C', '1'};
+constexpr std::uint32_t kVersion = 1;
+
+class Writer {
+public:
+    template<typename T>
+    void pod(const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    void str(const std::string& value) {
+        pod(static_cast<std::uint32_t>(value.size()));
+        m_buffer.insert(m_buffer.end(), value.begin(), value.end());
+    }
+
+    void strings(const std::vector<std::string>& values) {
+        pod(static_cast<std::uint32_t>(values.size()));
+        for (const auto& value : values) {
+            str(value);
+        }
+    }
+
+    const std::vector<char>& buffer() const { return m_buffer; }
+
+private:
+    std::vector<char> m_buffer;
+};
+
+class Reader {
+public:
+    explicit Reader(const std::vector<char>& buffer) : m_buffer(buffer) {}
+
+    template<typename T>
+    bool pod(T& out) {
+        if (m_buffer.size() - m_pos < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&out, m_buffer.data() + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool str(std::string& out) {
+        std::uint32_t len = 0;
+        if (!pod(len) || m_buffer.size() - m_pos < len) {
+            return false;
+        }
+        out.assign(m_buffer.data() + m_pos, len);
+        m_pos += len;
+        return true;
+    }
+
+    // Reads an element count, rejecting one the rest of the file cannot hold
+    // so a corrupt cache is a miss rather than a huge allocation.
+    bool count(std::uint32_t& out, size_t minElementBytes) {
+        return pod(out) && out <= (m_buffer.size() - m_pos) / minElementBytes;
+    }
+
+    bool strings(std::vector<std::string>& out) {
+        std::uint32_t count = 0;
+        if (!this->count(count, sizeof(std::uint32_t))) {
+            return false;
+        }
+        out.resize(count);
+        for (auto& value : out) {
+            if (!str(value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool atEnd() const { return m_pos == m_buffer.size(); }
+
+private:
+    const std::vector<char>& m_buffer;
+    size_t m_pos = 0;
+};
+
+} // namespace
+
+MaterialSourceStamp stamp_material_source(const std::string& path) {
+    MaterialSourceStamp stamp;
+    stamp.path = path;
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return stamp;
+    }
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return stamp;
+    }
+    stamp.mtime = static_cast<std::int64_t>(time.time_since_epoch().count());
+    stamp.size = static_cast<std::int64_t>(size);
+    return stamp;
+}
+
+bool load_material_cache(const std::string& path, const std::string& root, MaterialCacheData& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::vector<char> buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    Reader reader(buffer);
+
+    char magic[4] = {};
+    std::uint32_t version = 0;
+    if (!reader.pod(magic) || std::memcmp(magic, kMagic, 4) != 0) {
+        return false;
+    }
+    if (!reader.pod(version) || version != kVersion) {
+        return false;
+    }
+    if (!reader.str(out.root) || out.root != root) {
+        return false;
+    }
+
+    // Smallest encodings: an empty string is its 4-byte length.
+    constexpr size_t kSourceBytes = 4 + sizeof(MaterialSourceStamp::mtime) + sizeof(MaterialSourceStamp::size);
+    constexpr size_t kMaterialBytes = 4 * 5 + sizeof(Material::xsize) + sizeof(Material::ysize);
+    constexpr size_t kLandclassBytes = sizeof(std::int32_t) + 4 + 2;
+
+    std::uint32_t sourceCount = 0;
+    if (!reader.count(sourceCount, kSourceBytes)) {
+        return false;
+    }
+    out.sources.resize(sourceCount);
+    for (auto& source : out.sources) {
+        if (!reader.str(source.path) || !reader.pod(source.mtime) || !reader.pod(source.size)) {
+            return false;
+        }
+        MaterialSourceStamp current = stamp_material_source(source.path);
+        if (current.mtime != source.mtime || current.size != source.size) {
+            return false;
+        }
+    }
+
+    std::uint32_t materialCount = 0;
+    if (!reader.count(materialCount, kMaterialBytes)) {
+        return false;
+    }
+    out.materialsByName.clear();
+    out.materialsByName.reserve(materialCount);
+    for (std::uint32_t i = 0; i < materialCount; ++i) {
+        std::string key;
+        Material material;
+        if (!reader.str(key) || !reader.str(material.canonicalName) ||
+            !reader.strings(material.names) || !reader.strings(material.textures) ||
+            !reader.str(material.effect) || !reader.pod(material.xsize) || !reader.pod(material.ysize)) {
+            return false;
+        }
+        out.materialsByName.emplace(std::move(key), std::move(material));
+    }
+
+    std::uint32_t landclassCount = 0;
+    if (!reader.count(landclassCount, kLandclassBytes)) {
+        return false;
+    }
+    out.landclassEntries.resize(landclassCount);
+    for (auto& entry : out.landclassEntries) {
+        std::int32_t id = 0;
+        std::uint8_t water = 0;
+        std::uint8_t sea = 0;
+        if (!reader.pod(id) || !reader.str(entry.materialName) || !reader.pod(water) || !reader.pod(sea)) {
+            return false;
+        }
+        entry.id = id;
+        entry.water = water != 0;
+        entry.sea = sea != 0;
+    }
+
+    if (!reader.pod(out.landclassFlags)) {
+        return false;
+    }
+    return reader.atEnd();
+}
+
+bool write_material_cache(const std::string& path, const MaterialCacheData& data) {
+    Writer writer;
+    writer.pod(kMagic);
+    writer.pod(kVersion);
+    writer.str(data.root);
+
+    writer.pod(static_cast<std::uint32_t>(data.sources.size()));
+    for (const auto& source : data.sources) {
+        writer.str(source.path);
+        writer.pod(source.mtime);
+        writer.pod(source.size);
+    }
+
+    writer.pod(static_cast<std::uint32_t>(data.materialsByName.size()));
+    for (const auto& pair : data.materialsByName) {
+        const Material& material = pair.second;
+        writer.str(pair.first);
+        writer.str(material.canonicalName);
+        writer.strings(material.names);
+        writer.strings(material.textures);
+        writer.str(material.effect);
+        writer.pod(material.xsize);
+        writer.pod(material.ysize);
+    }
+
+    writer.pod(static_cast<std::uint32_t>(data.landclassEntries.size()));
+    for (const auto& entry : data.landclassEntries) {
+        writer.pod(static_cast<std::int32_t>(entry.id));
+        writer.str(entry.materialName);
+        writer.pod(static_cast<std::uint8_t>(entry.water ? 1 : 0));
+        writer.pod(static_cast<std::uint8_t>(entry.sea ? 1 : 0));
+    }
+
+    writer.pod(data.landclassFlags);
+
+    // Write to a sibling file and rename so a concurrent reader never sees a partial cache.
+    std::filesystem::path finalPath(path);
+    std::filesystem::path tmpPath = finalPath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        const auto& buffer = writer.buffer();
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!out) {
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, finalPath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace nuage
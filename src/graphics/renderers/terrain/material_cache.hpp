@@ -0,0 +1,27 @@
+#pragma once
+
+#include "graphics/renderers/terrain/material_library.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nuage {
+
+struct MaterialCacheData {
+    std::string root;
+    std::vector<MaterialSourceStamp> sources;
+    std::unordered_map<std::string, Material> materialsByName;
+    std::vector<LandclassEntry> landclassEntries;
+    std::array<std::uint8_t, 256> landclassFlags{};
+};
+
+MaterialSourceStamp stamp_material_source(const std::string& path);
+
+// Returns false if the cache is missing, malformed, built for another root,
+// or any recorded source file changed since it was written.
+bool load_material_cache(const std::string& path, const std::string& root, MaterialCacheData& out);
+bool write_material_cache(const std::string& path, const MaterialCacheData& data);
+
+} // namespace nuage
@@ -0,0 +1,69 @@
+#include "graphics/renderers/terrain/material_fields.hpp"
+
+namespace nuage {
+namespace {
+
+bool parseFloat(std::string_view text, float& out) {
+    try {
+        out = std::stof(std::string(text));
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+void applyMaterialField(std::string_view name, std::string_view text, Material& material) {
+    if (name == "name") {
+        if (!text.empty()) {
+            material.names.emplace_back(text);
+        }
+    } else if (name == "texture") {
+        if (!text.empty()) {
+            material.textures.emplace_back(text);
+        }
+    } else if (name == "effect") {
+        if (!text.empty()) {
+            material.effect = std::string(text);
+        }
+    } else if (name == "xsize") {
+        float value = 0.0f;
+        if (parseFloat(text, value)) {
+            material.xsize = value;
+        }
+    } else if (name == "ysize") {
+        float value = 0.0f;
+        if (parseFloat(text, value)) {
+            material.ysize = value;
+        }
+    }
+}
+
+} // namespace
+
+void collect_material_fields(XmlElement element, Material& material) {
+    applyMaterialField(element.name(), element.text(), material);
+    for (XmlElement child : element.children()) {
+        collect_material_fields(child, material);
+    }
+}
+
+void MaterialFieldCollector::startElement(std::string_view name, const XmlAttributeView*, size_t) {
+    // Entries above m_depth are kept, so their strings' buffers are reused.
+    if (m_depth == m_open.size()) {
+        m_open.emplace_back();
+    }
+    OpenElement& element = m_open[m_depth++];
+    element.name = name;
+    element.text.clear();
+}
+
+void MaterialFieldCollector::text(std::string_view text) {
+    m_open[m_depth - 1].text.append(text);
+}
+
+void MaterialFieldCollector::endElement(std::string_view) {
+    const OpenElement& element = m_open[--m_depth];
+    applyMaterialField(element.name, element.text, m_material);
+}
+
+} // namespace nuage
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "graphics/renderers/terrain/material_library.hpp"
+#include "utils/xml.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nuage {
+
+// Applies the name, texture, effect, xsize and ysize fields found in element
+// and everything below it to material.
+void collect_material_fields(XmlElement element, Material& material);
+
+// Streams the same fields out of a file without building a tree. An
+// element's text segments are joined before the field is applied, as
+// XmlDocument joins them, so text split by a comment or CDATA section
+// reads the same either way.
+class MaterialFieldCollector : public XmlSaxHandler {
+public:
+    explicit MaterialFieldCollector(Material& material) : m_material(material) {}
+
+    void startElement(std::string_view name, const XmlAttributeView* attributes, size_t count) override;
+    void text(std::string_view text) override;
+    void endElement(std::string_view name) override;
+
+private:
+    struct OpenElement {
+        std::string_view name;
+        std::string text;
+    };
+
+    Material& m_material;
+    std::vector<OpenElement> m_open;
+    size_t m_depth = 0;
+};
+
+} // namespace nuage
@@ -1,76 +1,57 @@
 #include "graphics/renderers/terrain/material_library.hpp"
+#include "graphics/renderers/terrain/material_cache.hpp"
+#include "graphics/renderers/terrain/material_fields.hpp"
+#include <algorithm>
 #include <cctype>
 #include <iostream>
 
 namespace nuage {
 namespace {
 
-bool parseFloat(const std::string& text, float& out) {
-    try {
-        out = std::stof(text);
-        return true;
-    } catch (...) {
-        return false;
-    }
+bool isTrue(std::string_view text) {
+    return text == "true" || text == "1";
 }
 
-void collectMaterialFields(const XmlNode& node, Material& material) {
-    if (node.name == "name") {
-        if (!node.text.empty()) {
-            material.names.push_back(node.text);
-        }
-    } else if (node.name == "texture") {
-        if (!node.text.empty()) {
-            material.textures.push_back(node.text);
-        }
-    } else if (node.name == "effect") {
-        if (!node.text.empty()) {
-            material.effect = node.text;
-        }
-    } else if (node.name == "xsize") {
-        float value = 0.0f;
-        if (parseFloat(node.text, value)) {
-            material.xsize = value;
-        }
-    } else if (node.name == "ysize") {
-        float value = 0.0f;
-        if (parseFloat(node.text, value)) {
-            material.ysize = value;
-        }
-    }
-    for (const auto& child : node.children) {
-        collectMaterialFields(child, material);
-    }
-}
-
-void collectLandclassFields(const XmlNode& node, LandclassEntry& entry) {
-    if (node.name == "landclass") {
-        if (!node.text.empty()) {
+void collectLandclassFields(XmlElement element, LandclassEntry& entry) {
+    std::string_view name = element.name();
+    std::string_view text = element.text();
+    if (name == "landclass") {
+        if (!text.empty()) {
             try {
-                entry.id = std::stoi(node.text);
+                entry.id = std::stoi(std::string(text));
             } catch (...) {
                 entry.id = 0;
             }
         }
-    } else if (node.name == "material-name") {
-        entry.materialName = node.text;
-    } else if (node.name == "water") {
-        entry.water = (node.text == "true" || node.text == "1");
-    } else if (node.name == "sea") {
-        entry.sea = (node.text == "true" || node.text == "1");
-    }
-    for (const auto& child : node.children) {
+    } else if (name == "material-name") {
+        entry.materialName = std::string(text);
+    } else if (name == "water") {
+        entry.water = isTrue(text);
+    } else if (name == "sea") {
+        entry.sea = isTrue(text);
+    }
+    for (XmlElement child : element.children()) {
         collectLandclassFields(child, entry);
     }
 }
 
 } // namespace
 
-bool MaterialLibrary::loadFromRoot(const std::string& rootPath) {
+bool MaterialLibrary::loadFromRoot(const std::string& rootPath, const std::string& cachePath) {
     m_root = std::filesystem::path(rootPath);
     m_materialsByName.clear();
     m_landclassEntries.clear();
     m_landclassFlags.fill(0);
+    m_sources.clear();
+    m_loadedFromCache = false;
+
+    std::filesystem::path cacheFile = cachePath.empty()
+        ? m_root / "Materials" / "materials.cache"
+        : std::filesystem::path(cachePath);
+    if (loadCache(cacheFile)) {
+        m_loadedFromCache = true;
+        return !m_materialsByName.empty();
+    }
 
     std::filesystem::path materialsPath = m_root / "Materials" / "default" / "materials.xml";
     collectFromFile(materialsPath);
@@ -93,66 +74,109 @@ bool MaterialLibrary::loadFromRoot(const std::string& rootPath) {
         m_landclassFlags[static_cast<size_t>(entry.id)] = flags;
     }
 
+    if (!m_materialsByName.empty()) {
+        writeCache(cacheFile);
+    }
     return !m_materialsByName.empty();
 }
 
+void MaterialLibrary::trackSource(const std::filesystem::path& path) {
+    std::string pathStr = path.string();
+    bool tracked = std::any_of(m_sources.begin(), m_sources.end(),
+        [&](const MaterialSourceStamp& stamp) { return stamp.path == pathStr; });
+    if (!tracked) {
+        m_sources.push_back(stamp_material_source(pathStr));
+    }
+}
+
+bool MaterialLibrary::loadTrackedXml(const std::filesystem::path& path, XmlDocument& doc) {
+    trackSource(path);
+    return doc.load(path.string());
+}
+
+bool MaterialLibrary::streamTrackedXml(const std::filesystem::path& path, XmlSaxHandler& handler) {
+    trackSource(path);
+    return loadXmlFileSax(path.string(), handler);
+}
+
+bool MaterialLibrary::loadCache(const std::filesystem::path& cachePath) {
+    MaterialCacheData data;
+    if (!load_material_cache(cachePath.string(), m_root.string(), data)) {
+        return false;
+    }
+    m_sources = std::move(data.sources);
+    m_materialsByName = std::move(data.materialsByName);
+    m_landclassEntries = std::move(data.landclassEntries);
+    m_landclassFlags = data.landclassFlags;
+    return true;
+}
+
+void MaterialLibrary::writeCache(const std::filesystem::path& cachePath) const {
+    MaterialCacheData data;
+    data.root = m_root.string();
+    data.sources = m_sources;
+    data.materialsByName = m_materialsByName;
+    data.landclassEntries = m_landclassEntries;
+    data.landclassFlags = m_landclassFlags;
+    if (!write_material_cache(cachePath.string(), data)) {
+        std::cerr << "[material] failed to write cache: " << cachePath << "\n";
+    }
+}
+
 void MaterialLibrary::collectFromFile(const std::filesystem::path& path) {
-    auto rootOpt = loadXmlFile(path.string());
-    if (!rootOpt) {
+    XmlDocument doc;
+    if (!loadTrackedXml(path, doc)) {
         std::cerr << "[material] failed to parse XML: " << path << "\n";
         return;
     }
-    collectFromNode(*rootOpt, path.parent_path());
+    collectFromNode(doc.root(), path.parent_path());
 }
 
-void MaterialLibrary::collectFromNode(const XmlNode& node, const std::filesystem::path& baseDir) {
-    auto includeIt = node.attributes.find("include");
-    if (includeIt != node.attributes.end()) {
-        std::filesystem::path includePath = includeIt->second;
+void MaterialLibrary::collectFromNode(XmlElement node, const std::filesystem::path& baseDir) {
+    std::string_view name = node.name();
+    if (auto include = node.attribute("include")) {
+        std::filesystem::path includePath{std::string(*include)};
         if (includePath.is_relative()) {
             includePath = m_root / includePath;
         }
-        auto includeRoot = loadXmlFile(includePath.string());
-        if (includeRoot) {
-            collectFromNode(*includeRoot, includePath.parent_path());
+        XmlDocument includeDoc;
+        if (loadTrackedXml(includePath, includeDoc)) {
+            collectFromNode(includeDoc.root(), includePath.parent_path());
         } else {
             std::cerr << "[material] failed to load include: " << includePath << "\n";
         }
-        if (node.name == "material") {
+        if (name == "material") {
             parseMaterialNode(node, baseDir);
-        } else if (node.name == "landclass-mapping") {
+        } else if (name == "landclass-mapping") {
             parseLandclassNode(node, baseDir);
         }
         return;
     }
 
-    if (node.name == "material") {
+    if (name == "material") {
         parseMaterialNode(node, baseDir);
-    } else if (node.name == "landclass-mapping") {
+    } else if (name == "landclass-mapping") {
         parseLandclassNode(node, baseDir);
     }
 
-    for (const auto& child : node.children) {
+    for (XmlElement child : node.children()) {
         collectFromNode(child, baseDir);
     }
 }
 
-void MaterialLibrary::parseMaterialNode(const XmlNode& node, const std::filesystem::path& baseDir) {
+void MaterialLibrary::parseMaterialNode(XmlElement node, const std::filesystem::path& baseDir) {
     (void)baseDir;
     Material material;
-    auto includeIt = node.attributes.find("include");
-    if (includeIt != node.attributes.end()) {
-        std::filesystem::path includePath = includeIt->second;
+    if (auto include = node.attribute("include")) {
+        std::filesystem::path includePath{std::string(*include)};
         if (includePath.is_relative()) {
             includePath = m_root / includePath;
         }
-        auto includeRoot = loadXmlFile(includePath.string());
-        if (includeRoot) {
-            collectMaterialFields(*includeRoot, material);
-        }
+        MaterialFieldCollector collector(material);
+        streamTrackedXml(includePath, collector);
     }
 
-    collectMaterialFields(node, material);
+    collect_material_fields(node, material);
     if (material.names.empty()) {
         return;
     }
@@ -165,21 +189,20 @@ void MaterialLibrary::parseMaterialNode(const XmlNode& node, const std::filesyst
     }
 }
 
-void MaterialLibrary::parseLandclassNode(const XmlNode& node, const std::filesystem::path& baseDir) {
+void MaterialLibrary::parseLandclassNode(XmlElement node, const std::filesystem::path& baseDir) {
     (void)baseDir;
-    auto includeIt = node.attributes.find("include");
-    if (includeIt != node.attributes.end()) {
-        std::filesystem::path includePath = includeIt->second;
+    if (auto include = node.attribute("include")) {
+        std::filesystem::path includePath{std::string(*include)};
         if (includePath.is_relative()) {
             includePath = m_root / includePath;
         }
-        auto includeRoot = loadXmlFile(includePath.string());
-        if (includeRoot) {
-            parseLandclassNode(*includeRoot, includePath.parent_path());
+        XmlDocument includeDoc;
+        if (loadTrackedXml(includePath, includeDoc)) {
+            parseLandclassNode(includeDoc.root(), includePath.parent_path());
         }
     }
 
-    if (node.name == "map") {
+    if (node.name() == "map") {
         LandclassEntry entry;
         collectLandclassFields(node, entry);
         if (!entry.materialName.empty()) {
@@ -187,7 +210,7 @@ void MaterialLibrary::parseLandclassNode(const XmlNode& node, const std::filesys
         }
     }
 
-    for (const auto& child : node.children) {
+    for (XmlElement child : node.children()) {
         parseLandclassNode(child, baseDir);
     }
 }
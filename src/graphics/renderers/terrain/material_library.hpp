@@ -2,6 +2,7 @@
 
 #include "utils/xml.hpp"
 #include <array>
+#include <cstdint>
 #include <filesystem>
 #include <string>
 #include <unordered_map>
@@ -25,9 +26,19 @@ struct LandclassEntry {
     bool sea = false;
 };
 
+// An XML file read while resolving the material tree, with the stamp it had at parse time.
+struct MaterialSourceStamp {
+    std::string path;
+    std::int64_t mtime = -1;
+    std::int64_t size = -1;
+};
+
 class MaterialLibrary {
 public:
-    bool loadFromRoot(const std::string& rootPath);
+    // Resolved results are cached in a binary file next to the material tree
+    // (or at cachePath) and reused while none of the parsed XML files change.
+    bool loadFromRoot(const std::string& rootPath, const std::string& cachePath = {});
+    bool loadedFromCache() const { return m_loadedFromCache; }
 
     const std::unordered_map<std::string, Material>& materialsByName() const {
         return m_materialsByName;
@@ -36,10 +47,15 @@ public:
     const std::array<std::uint8_t, 256>& landclassFlags() const { return m_landclassFlags; }
 
 private:
+    void trackSource(const std::filesystem::path& path);
+    bool loadTrackedXml(const std::filesystem::path& path, XmlDocument& doc);
+    bool streamTrackedXml(const std::filesystem::path& path, XmlSaxHandler& handler);
+    bool loadCache(const std::filesystem::path& cachePath);
+    void writeCache(const std::filesystem::path& cachePath) const;
     void collectFromFile(const std::filesystem::path& path);
-    void collectFromNode(const XmlNode& node, const std::filesystem::path& baseDir);
-    void parseMaterialNode(const XmlNode& node, const std::filesystem::path& baseDir);
-    void parseLandclassNode(const XmlNode& node, const std::filesystem::path& baseDir);
+    void collectFromNode(XmlElement node, const std::filesystem::path& baseDir);
+    void parseMaterialNode(XmlElement node, const std::filesystem::path& baseDir);
+    void parseLandclassNode(XmlElement node, const std::filesystem::path& baseDir);
 
     static bool isUrbanName(const std::string& name);
     static bool isForestName(const std::string& name);
@@ -49,6 +65,8 @@ private:
     std::unordered_map<std::string, Material> m_materialsByName;
     std::vector<LandclassEntry> m_landclassEntries;
     std::array<std::uint8_t, 256> m_landclassFlags{};
+    std::vector<MaterialSourceStamp> m_sources;
+    bool m_loadedFromCache = false;
 };
 
 } // namespace nuage
\ No newline at end of file
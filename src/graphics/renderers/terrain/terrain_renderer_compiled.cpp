@@ -15,7 +15,9 @@
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
@@ -24,6 +26,8 @@ namespace nuage {
 
 namespace {
 constexpr float kSqMetersPerSqKm = 1000000.0f;
+// Frames a tile stays resident after physics last asked for it.
+constexpr int kPhysicsKeepFrames = 120;
 
 float rand01(std::uint32_t& state) {
     state = state * 1664525u + 1013904223u;
@@ -46,6 +50,11 @@ std::uint32_t hashTileSeed(int x, int y, int seed) {
     return h;
 }
 
+std::string compiledTileKey(int level, int x, int y) {
+    std::string prefix = level == 0 ? "C" : "C" + std::to_string(level);
+    return prefix + "_x" + std::to_string(x) + "_y" + std::to_string(y);
+}
+
 std::string stripTexturesPrefix(const std::string& path) {
     const std::string prefix = "Textures/";
     if (path.rfind(prefix, 0) == 0) {
@@ -279,6 +288,67 @@ bool buildGridVerticesFromTriList(const std::vector<float>& triVerts, int gridRe
     return true;
 }
 
+// Adaptive meshes only share the grid's corner points, so each grid sample is
+// interpolated from the triangle covering it.
+bool buildGridVerticesFromIndexedMesh(const std::vector<float>& verts, const std::vector<std::uint32_t>& indices,
+                                      int gridResolution, float tileMinX, float tileMinZ, float tileSize,
+                                      std::vector<float>& outVerts) {
+    if (gridResolution < 1 || tileSize <= 0.0f) {
+        return false;
+    }
+    int res = gridResolution + 1;
+    int stride = 9;
+    size_t gridCount = static_cast<size_t>(res * res);
+    outVerts.assign(gridCount * stride, 0.0f);
+    std::vector<bool> filled(gridCount, false);
+
+    float scale = static_cast<float>(gridResolution) / tileSize;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const float* a = &verts[static_cast<size_t>(indices[t]) * stride];
+        const float* b = &verts[static_cast<size_t>(indices[t + 1]) * stride];
+        const float* c = &verts[static_cast<size_t>(indices[t + 2]) * stride];
+        float ax = (a[0] - tileMinX) * scale;
+        float az = (a[2] - tileMinZ) * scale;
+        float bx = (b[0] - tileMinX) * scale;
+        float bz = (b[2] - tileMinZ) * scale;
+        float cx = (c[0] - tileMinX) * scale;
+        float cz = (c[2] - tileMinZ) * scale;
+        float area = (bx - ax) * (cz - az) - (bz - az) * (cx - ax);
+        if (std::abs(area) < 1e-6f) {
+            continue;
+        }
+        int x0 = std::max(0, static_cast<int>(std::floor(std::min({ax, bx, cx}) + 1e-3f)));
+        int x1 = std::min(res - 1, static_cast<int>(std::ceil(std::max({ax, bx, cx}) - 1e-3f)));
+        int z0 = std::max(0, static_cast<int>(std::floor(std::min({az, bz, cz}) + 1e-3f)));
+        int z1 = std::min(res - 1, static_cast<int>(std::ceil(std::max({az, bz, cz}) - 1e-3f)));
+        for (int z = z0; z <= z1; ++z) {
+            for (int x = x0; x <= x1; ++x) {
+                float px = static_cast<float>(x);
+                float pz = static_cast<float>(z);
+                float wa = ((bx - px) * (cz - pz) - (bz - pz) * (cx - px)) / area;
+                float wb = ((cx - px) * (az - pz) - (cz - pz) * (ax - px)) / area;
+                float wc = 1.0f - wa - wb;
+                if (wa < -1e-4f || wb < -1e-4f || wc < -1e-4f) {
+                    continue;
+                }
+                size_t idx = static_cast<size_t>(z * res + x);
+                float* dst = &outVerts[idx * stride];
+                for (int k = 0; k < stride; ++k) {
+                    dst[k] = wa * a[k] + wb * b[k] + wc * c[k];
+                }
+                filled[idx] = true;
+            }
+        }
+    }
+
+    for (bool ok : filled) {
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void buildGridIndices(int resX, int resZ, std::vector<std::uint32_t>& outIndices) {
     outIndices.clear();
     if (resX < 2 || resZ < 2) {
@@ -326,28 +396,10 @@ void buildLodIndices(int resX, int resZ, int step, std::vector<std::uint32_t>& o
     buildGridIndices(lodResX, lodResZ, outIndices);
 }
 
-void addSkirt(std::vector<float>& verts, std::vector<std::uint32_t>& indices,
-              int resX, int resZ, float depth) {
-    if (resX < 2 || resZ < 2 || depth <= 0.0f) {
-        return;
-    }
+// Hangs a vertical strip of depth below the closed border loop.
+void appendSkirt(std::vector<float>& verts, std::vector<std::uint32_t>& indices,
+                 const std::vector<std::uint32_t>& border, float depth) {
     int stride = 9;
-    std::vector<std::uint32_t> border;
-    border.reserve(static_cast<size_t>((resX + resZ) * 2 - 4));
-
-    for (int x = 0; x < resX; ++x) {
-        border.push_back(static_cast<std::uint32_t>(x));
-    }
-    for (int z = 1; z < resZ; ++z) {
-        border.push_back(static_cast<std::uint32_t>(z * resX + (resX - 1)));
-    }
-    for (int x = resX - 2; x >= 0; --x) {
-        border.push_back(static_cast<std::uint32_t>((resZ - 1) * resX + x));
-    }
-    for (int z = resZ - 2; z >= 1; --z) {
-        border.push_back(static_cast<std::uint32_t>(z * resX));
-    }
-
     std::vector<std::uint32_t> skirt;
     skirt.reserve(border.size());
     for (std::uint32_t idx : border) {
@@ -379,6 +431,72 @@ void addSkirt(std::vector<float>& verts, std::vector<std::uint32_t>& indices,
         indices.push_back(s0);
     }
 }
+
+// Adaptive tiles keep every border sample, so the loop is recovered by walking
+// the perimeter in the same order as the uniform grid's border.
+void addAdaptiveSkirt(std::vector<float>& verts, std::vector<std::uint32_t>& indices, int gridResolution,
+                      float tileMinX, float tileMinZ, float tileSize, float depth) {
+    if (gridResolution < 1 || tileSize <= 0.0f || depth <= 0.0f) {
+        return;
+    }
+    int stride = 9;
+    int n = gridResolution;
+    std::vector<std::pair<int, std::uint32_t>> perimeter;
+    size_t vertexCount = verts.size() / stride;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        int gx = static_cast<int>(std::lround((verts[i * stride + 0] - tileMinX) / tileSize * n));
+        int gz = static_cast<int>(std::lround((verts[i * stride + 2] - tileMinZ) / tileSize * n));
+        int position = -1;
+        if (gz == 0) {
+            position = gx;
+        } else if (gx == n) {
+            position = n + gz;
+        } else if (gz == n) {
+            position = 3 * n - gx;
+        } else if (gx == 0) {
+            position = 4 * n - gz;
+        }
+        if (position >= 0) {
+            perimeter.emplace_back(position, static_cast<std::uint32_t>(i));
+        }
+    }
+    std::sort(perimeter.begin(), perimeter.end());
+    perimeter.erase(std::unique(perimeter.begin(), perimeter.end(),
+                                [](const auto& a, const auto& b) { return a.first == b.first; }),
+                    perimeter.end());
+    if (perimeter.size() < 3) {
+        return;
+    }
+    std::vector<std::uint32_t> border;
+    border.reserve(perimeter.size());
+    for (const auto& entry : perimeter) {
+        border.push_back(entry.second);
+    }
+    appendSkirt(verts, indices, border, depth);
+}
+
+void addSkirt(std::vector<float>& verts, std::vector<std::uint32_t>& indices,
+              int resX, int resZ, float depth) {
+    if (resX < 2 || resZ < 2 || depth <= 0.0f) {
+        return;
+    }
+    std::vector<std::uint32_t> border;
+    border.reserve(static_cast<size_t>((resX + resZ) * 2 - 4));
+
+    for (int x = 0; x < resX; ++x) {
+        border.push_back(static_cast<std::uint32_t>(x));
+    }
+    for (int z = 1; z < resZ; ++z) {
+        border.push_back(static_cast<std::uint32_t>(z * resX + (resX - 1)));
+    }
+    for (int x = resX - 2; x >= 0; --x) {
+        border.push_back(static_cast<std::uint32_t>((resZ - 1) * resX + x));
+    }
+    for (int z = resZ - 2; z >= 1; --z) {
+        border.push_back(static_cast<std::uint32_t>(z * resX));
+    }
+    appendSkirt(verts, indices, border, depth);
+}
 } // namespace
 
 void TerrainRenderer::setupCompiled(const std::string& configPath) {
@@ -412,6 +530,7 @@ void TerrainRenderer::setupCompiled(const std::string& configPath) {
     m_compiledTileSizeMeters = manifest.value("tileSizeMeters", 2000.0f);
     m_compiledGridResolution = manifest.value("gridResolution", 129);
     m_compiledMaskResolution = manifest.value("maskResolution", 0);
+    m_compiledNormalMapResolution = manifest.value("normalMapResolution", 0);
     std::string maskType = manifest.value("maskType", "landuse");
     m_compiledMaskIsLandclass = (maskType == "landclass");
     m_compiledOriginValid = false;
@@ -474,6 +593,39 @@ void TerrainRenderer::setupCompiled(const std::string& configPath) {
         return;
     }
 
+    m_compiledLodLevels.clear();
+    m_compiledLodRadius = std::max(1, config.value("compiledLodRadius", 2));
+    const auto& lodOrigin = manifest.contains("lodOriginTile") ? manifest["lodOriginTile"] : nlohmann::json();
+    if (lodOrigin.is_array() && lodOrigin.size() == 2 &&
+        manifest.contains("lodLevels") && manifest["lodLevels"].is_array()) {
+        m_compiledLodOriginX = lodOrigin[0].get<int>();
+        m_compiledLodOriginY = lodOrigin[1].get<int>();
+        for (const auto& entry : manifest["lodLevels"]) {
+            int level = entry.value("level", 0);
+            if (level != static_cast<int>(m_compiledLodLevels.size()) + 1) {
+                std::cerr << "[terrain] ignoring lod levels from " << level << ": levels must be consecutive\n";
+                break;
+            }
+            CompiledLodLevel lod;
+            lod.tileSizeMeters = entry.value("tileSizeMeters", m_compiledTileSizeMeters * static_cast<float>(1 << level));
+            lod.path = entry.value("path", "tiles/lod" + std::to_string(level));
+            if (entry.contains("tileIndex") && entry["tileIndex"].is_array()) {
+                for (const auto& tile : entry["tileIndex"]) {
+                    if (tile.is_array() && tile.size() == 2) {
+                        lod.tiles.insert(packedTileKey(tile[0].get<int>(), tile[1].get<int>()));
+                    }
+                }
+            }
+            if (lod.tiles.empty()) {
+                break;
+            }
+            m_compiledLodLevels.push_back(std::move(lod));
+        }
+        if (m_compiledDebugLog && !m_compiledLodLevels.empty()) {
+            std::cout << "[terrain] compiled lod levels: " << m_compiledLodLevels.size() << "\n";
+        }
+    }
+
     m_visuals.applyConfig(config);
     m_visuals.clamp();
     applyTextureConfig(config, configPath);
@@ -518,6 +670,10 @@ void TerrainRenderer::setupLandclassMaterials(const nlohmann::json& config, cons
         return;
     }
     m_landclassFlags = lib.landclassFlags();
+    if (m_heightsOnly) {
+        // The flags classify sampled terrain; the rest is for drawing.
+        return;
+    }
 
     std::unordered_map<std::string, int> texIndices;
     std::vector<std::string> texturePaths;
@@ -653,13 +809,13 @@ bool TerrainRenderer::sampleCompiledSurface(int tx, int ty, float worldX, float
         return false;
     }
     auto* tile = const_cast<TerrainRenderer*>(this)->ensureCompiledTileLoaded(tx, ty, forceLoad);
-    if (!tile || !tile->hasGrid || tile->gridVerts.empty() || tile->gridRes <= 1) {
+    if (!tile || !tile->hasGrid || !tile->gridVerts || tile->gridRes <= 1) {
         return false;
     }
 
     float tileMinX = static_cast<float>(tx) * m_compiledTileSizeMeters;
     float tileMinZ = static_cast<float>(ty) * m_compiledTileSizeMeters;
-    return sampleGrid(tile->gridVerts, tile->gridRes, tileMinX, tileMinZ, m_compiledTileSizeMeters,
+    return sampleGrid(*tile->gridVerts, tile->gridRes, tileMinX, tileMinZ, m_compiledTileSizeMeters,
                       worldX, worldZ, outSample.height, outSample.normal,
                       outSample.water, outSample.urban, outSample.forest);
 }
@@ -669,36 +825,135 @@ bool TerrainRenderer::sampleCompiledSurfaceCached(int tx, int ty, float worldX,
     if (m_compiledTiles.find(packedTileKey(tx, ty)) == m_compiledTiles.end()) {
         return false;
     }
-    std::string key = "C_x" + std::to_string(tx) + "_y" + std::to_string(ty);
-    auto it = m_tileCache.find(key);
+    auto it = m_tileCache.find(compiledTileKey(0, tx, ty));
     if (it == m_tileCache.end()) {
         return false;
     }
     const TileResource& tile = it->second;
-    if (!tile.hasGrid || tile.gridVerts.empty() || tile.gridRes <= 1) {
+    if (!tile.hasGrid || !tile.gridVerts || tile.gridRes <= 1) {
+        return false;
+    }
+
+    float tileMinX = static_cast<float>(tx) * m_compiledTileSizeMeters;
+    float tileMinZ = static_cast<float>(ty) * m_compiledTileSizeMeters;
+    return sampleGrid(*tile.gridVerts, tile.gridRes, tileMinX, tileMinZ, m_compiledTileSizeMeters,
+                      worldX, worldZ, outSample.height, outSample.normal,
+                      outSample.water, outSample.urban, outSample.forest);
+}
+
+bool TerrainRenderer::samplePhysicsSurface(float worldX, float worldZ, TerrainSample& outSample) const {
+    if (!m_physicsThreaded) {
+        // Allow a one-off load if the cached ring missed; avoids zero height on tall terrain.
+        return sampleSurfaceNoLoad(worldX, worldZ, outSample) || sampleSurface(worldX, worldZ, outSample);
+    }
+
+    outSample = TerrainSample{};
+    if (sampleRunway(worldX, worldZ, outSample)) {
+        return true;
+    }
+    if (!m_compiled) {
         return false;
     }
 
+    int tx = static_cast<int>(std::floor(worldX / m_compiledTileSizeMeters));
+    int ty = static_cast<int>(std::floor(worldZ / m_compiledTileSizeMeters));
+    PhysicsGrid grid;
+    {
+        std::lock_guard<std::mutex> lock(m_physicsMutex);
+        auto it = m_physicsGrids.find(packedTileKey(tx, ty));
+        if (it == m_physicsGrids.end()) {
+            return false;
+        }
+        grid = it->second;
+    }
     float tileMinX = static_cast<float>(tx) * m_compiledTileSizeMeters;
     float tileMinZ = static_cast<float>(ty) * m_compiledTileSizeMeters;
-    return sampleGrid(tile.gridVerts, tile.gridRes, tileMinX, tileMinZ, m_compiledTileSizeMeters,
+    return sampleGrid(*grid.verts, grid.res, tileMinX, tileMinZ, m_compiledTileSizeMeters,
                       worldX, worldZ, outSample.height, outSample.normal,
                       outSample.water, outSample.urban, outSample.forest);
 }
 
+void TerrainRenderer::requestPhysicsTiles(float worldX, float worldZ, int radius) const {
+    if (!m_compiled) {
+        return;
+    }
+    if (!m_physicsThreaded) {
+        const_cast<TerrainRenderer*>(this)->preloadPhysicsAt(worldX, worldZ, radius);
+        return;
+    }
+    int cx = static_cast<int>(std::floor(worldX / m_compiledTileSizeMeters));
+    int cy = static_cast<int>(std::floor(worldZ / m_compiledTileSizeMeters));
+    std::lock_guard<std::mutex> lock(m_physicsMutex);
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            m_physicsRequests.insert(packedTileKey(cx + dx, cy + dy));
+        }
+    }
+}
+
+void TerrainRenderer::updatePhysicsTiles() {
+    std::unordered_set<std::int64_t> requests;
+    {
+        std::lock_guard<std::mutex> lock(m_physicsMutex);
+        requests.swap(m_physicsRequests);
+    }
+    for (auto it = m_physicsKeep.begin(); it != m_physicsKeep.end();) {
+        it = --it->second <= 0 ? m_physicsKeep.erase(it) : std::next(it);
+    }
+    for (std::int64_t key : requests) {
+        m_physicsKeep[key] = kPhysicsKeepFrames;
+        int x = static_cast<int>(key >> 32);
+        int y = static_cast<int>(static_cast<std::uint32_t>(key));
+        ensureCompiledTileLoaded(x, y, true);
+    }
+    if (!m_heightsOnly) {
+        return;
+    }
+    // Without a render pass this is the only place tiles are evicted.
+    for (auto it = m_tileCache.begin(); it != m_tileCache.end();) {
+        const TileResource& tile = it->second;
+        if (tile.level == 0 && m_physicsKeep.find(packedTileKey(tile.x, tile.y)) == m_physicsKeep.end()) {
+            withdrawPhysicsGrid(tile.x, tile.y);
+            it = m_tileCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TerrainRenderer::publishPhysicsGrid(const TileResource& tile) {
+    if (tile.level != 0 || !tile.hasGrid || !tile.gridVerts || tile.gridRes <= 1) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_physicsMutex);
+    m_physicsGrids[packedTileKey(tile.x, tile.y)] = PhysicsGrid{tile.gridVerts, tile.gridRes};
+}
+
+void TerrainRenderer::withdrawPhysicsGrid(int x, int y) {
+    std::lock_guard<std::mutex> lock(m_physicsMutex);
+    m_physicsGrids.erase(packedTileKey(x, y));
+}
+
+void TerrainRenderer::clearPhysicsGrids() {
+    std::lock_guard<std::mutex> lock(m_physicsMutex);
+    m_physicsGrids.clear();
+    m_physicsRequests.clear();
+    m_physicsKeep.clear();
+}
+
 std::int64_t TerrainRenderer::packedTileKey(int x, int y) const {
     return (static_cast<std::int64_t>(x) << 32) ^ (static_cast<std::uint32_t>(y));
 }
 
 TerrainRenderer::TileResource* TerrainRenderer::ensureCompiledTileLoaded(int x, int y, bool force) {
-    if (!m_assets) {
+    if (!m_assets && !m_heightsOnly) {
         return nullptr;
     }
     if (m_compiledTiles.find(packedTileKey(x, y)) == m_compiledTiles.end()) {
         return nullptr;
     }
 
-    std::string key = "C_x" + std::to_string(x) + "_y" + std::to_string(y);
+    std::string key = compiledTileKey(0, x, y);
     auto found = m_tileCache.find(key);
     if (found != m_tileCache.end()) {
         return &found->second;
@@ -711,7 +966,8 @@ TerrainRenderer::TileResource* TerrainRenderer::ensureCompiledTileLoaded(int x,
         / "tiles" / ("tile_" + std::to_string(x) + "_" + std::to_string(y) + ".mesh");
 
     std::vector<float> verts;
-    if (!load_compiled_mesh(meshPath.string(), verts)) {
+    std::vector<std::uint32_t> meshIndices;
+    if (!load_compiled_mesh(meshPath.string(), verts, &meshIndices)) {
         if (m_compiledDebugLog) {
             std::cout << "[terrain] missing compiled tile " << x << "," << y << "\n";
         }
@@ -736,13 +992,25 @@ TerrainRenderer::TileResource* TerrainRenderer::ensureCompiledTileLoaded(int x,
         }
     }
 
-    auto mesh = std::make_unique<Mesh>();
+    std::unique_ptr<Mesh> mesh = m_heightsOnly ? nullptr : std::make_unique<Mesh>();
     std::vector<float> gridVerts;
     std::vector<std::uint32_t> indices;
-    bool builtGrid = buildGridVerticesFromTriList(verts, m_compiledGridResolution,
-                                                  tileMinX, tileMinZ, m_compiledTileSizeMeters,
-                                                  gridVerts);
-    if (builtGrid) {
+    bool adaptive = !meshIndices.empty();
+    bool builtGrid = adaptive
+        ? buildGridVerticesFromIndexedMesh(verts, meshIndices, m_compiledGridResolution,
+                                           tileMinX, tileMinZ, m_compiledTileSizeMeters, gridVerts)
+        : buildGridVerticesFromTriList(verts, m_compiledGridResolution,
+                                       tileMinX, tileMinZ, m_compiledTileSizeMeters,
+                                       gridVerts);
+    if (m_heightsOnly) {
+        // Sampling reads the grid; nothing is uploaded.
+    } else if (adaptive) {
+        // Already decimated, so it is drawn as stored and gets no LOD1 mesh;
+        // the interpolated grid is only kept for sampling and trees.
+        addAdaptiveSkirt(verts, meshIndices, m_compiledGridResolution,
+                         tileMinX, tileMinZ, m_compiledTileSizeMeters, m_compiledSkirtDepth);
+        mesh->initIndexed(verts, meshIndices);
+    } else if (builtGrid) {
         int res = m_compiledGridResolution + 1;
         buildGridIndices(res, res, indices);
         addSkirt(gridVerts, indices, res, res, m_compiledSkirtDepth);
@@ -766,6 +1034,7 @@ TerrainRenderer::TileResource* TerrainRenderer::ensureCompiledTileLoaded(int x,
     resource.radius = m_compiledTileSizeMeters * 0.5f;
     resource.tileMinX = tileMinX;
     resource.tileMinZ = tileMinZ;
+    resource.tileSize = m_compiledTileSizeMeters;
     resource.level = 0;
     resource.x = x;
     resource.y = y;
@@ -774,21 +1043,34 @@ TerrainRenderer::TileResource* TerrainRenderer::ensureCompiledTileLoaded(int x,
     resource.compiled = true;
     resource.hasGrid = builtGrid;
     if (builtGrid) {
-        resource.gridVerts = std::move(gridVerts);
+        resource.gridVerts = std::make_shared<const std::vector<float>>(std::move(gridVerts));
     }
-    if (!maskData.empty()) {
+    if (!maskData.empty() && !m_heightsOnly) {
         auto tex = std::make_unique<Texture>();
         if (tex->loadFromData(maskData.data(), m_compiledMaskResolution, m_compiledMaskResolution, 1, false)) {
             resource.maskTexture = tex.get();
             resource.ownedMaskTexture = std::move(tex);
         }
     }
+    std::vector<std::uint8_t> normalData;
+    if (m_compiledNormalMapResolution > 0 && !m_heightsOnly) {
+        std::filesystem::path normalPath = std::filesystem::path(m_compiledManifestDir)
+            / "tiles" / ("tile_" + std::to_string(x) + "_" + std::to_string(y) + ".nrm");
+        if (load_compiled_normal_map(normalPath.string(), m_compiledNormalMapResolution, normalData)) {
+            auto tex = std::make_unique<Texture>();
+            if (tex->loadFromData(normalData.data(), m_compiledNormalMapResolution,
+                                  m_compiledNormalMapResolution, 4, false)) {
+                resource.normalTexture = tex.get();
+                resource.ownedNormalTexture = std::move(tex);
+            }
+        }
+    }
 
-    if (builtGrid && m_compiledGridResolution >= 2) {
+    if (builtGrid && !adaptive && m_compiledGridResolution >= 2 && !m_heightsOnly) {
         int res = m_compiledGridResolution + 1;
         std::vector<float> lodVerts;
         std::vector<std::uint32_t> lodIndices;
-        buildLodVertices(resource.gridVerts.empty() ? gridVerts : resource.gridVerts, res, res, 2, lodVerts);
+        buildLodVertices(resource.gridVerts ? *resource.gridVerts : gridVerts, res, res, 2, lodVerts);
         buildLodIndices(res, res, 2, lodIndices);
         addSkirt(lodVerts, lodIndices, (res - 1) / 2 + 1, (res - 1) / 2 + 1, m_compiledSkirtDepth);
         if (!lodVerts.empty() && !lodIndices.empty()) {
@@ -799,12 +1081,12 @@ TerrainRenderer::TileResource* TerrainRenderer::ensureCompiledTileLoaded(int x,
         }
     }
 
-    if (builtGrid && m_treesEnabled) {
+    if (builtGrid && m_treesEnabled && !m_heightsOnly) {
         int res = m_compiledGridResolution + 1;
         bool useWaterMask = m_compiledMaskResolution > 0;
         bool allowRoadAvoid = m_treesAvoidRoads && !m_compiledMaskIsLandclass;
         const std::vector<std::uint8_t>* roadMask = maskData.empty() ? nullptr : &maskData;
-        resource.ownedTreeMesh = buildTreeMeshForTile(resource.gridVerts.empty() ? gridVerts : resource.gridVerts,
+        resource.ownedTreeMesh = buildTreeMeshForTile(resource.gridVerts ? *resource.gridVerts : gridVerts,
                                                       res, x, y,
                                                       tileMinX, tileMinZ,
                                                       m_compiledTileSizeMeters, useWaterMask,
@@ -817,6 +1099,7 @@ TerrainRenderer::TileResource* TerrainRenderer::ensureCompiledTileLoaded(int x,
     }
 
     auto inserted = m_tileCache.emplace(key, std::move(resource));
+    publishPhysicsGrid(inserted.first->second);
     if (m_compiledDebugLog) {
         int& count = m_compiledTileCreateCounts[key];
         count += 1;
@@ -830,6 +1113,102 @@ TerrainRenderer::TileResource* TerrainRenderer::ensureCompiledTileLoaded(int x,
     return &inserted.first->second;
 }
 
+// Coarse pyramid tiles only need a drawable mesh and mask: they are never
+// sampled for physics and get no trees or LOD1 mesh.
+TerrainRenderer::TileResource* TerrainRenderer::ensureCompiledLodTileLoaded(int level, int x, int y) {
+    if (!m_assets || level < 1 || level > static_cast<int>(m_compiledLodLevels.size())) {
+        return nullptr;
+    }
+    const CompiledLodLevel& lod = m_compiledLodLevels[static_cast<size_t>(level - 1)];
+    if (lod.tiles.find(packedTileKey(x, y)) == lod.tiles.end()) {
+        return nullptr;
+    }
+
+    std::string key = compiledTileKey(level, x, y);
+    auto found = m_tileCache.find(key);
+    if (found != m_tileCache.end()) {
+        return &found->second;
+    }
+    if (m_compiledTilesLoadedThisFrame >= m_compiledLoadsPerFrame) {
+        return nullptr;
+    }
+
+    std::string tileName = "tile_" + std::to_string(x) + "_" + std::to_string(y);
+    std::filesystem::path tileDir = std::filesystem::path(m_compiledManifestDir) / lod.path;
+    std::vector<float> verts;
+    std::vector<std::uint32_t> meshIndices;
+    if (!load_compiled_mesh((tileDir / (tileName + ".mesh")).string(), verts, &meshIndices)) {
+        if (m_compiledDebugLog) {
+            std::cout << "[terrain] missing compiled lod" << level << " tile " << x << "," << y << "\n";
+        }
+        return nullptr;
+    }
+
+    int span = 1 << level;
+    float tileSize = lod.tileSizeMeters;
+    float tileMinX = static_cast<float>(m_compiledLodOriginX + x * span) * m_compiledTileSizeMeters;
+    float tileMinZ = static_cast<float>(m_compiledLodOriginY + y * span) * m_compiledTileSizeMeters;
+    std::vector<std::uint8_t> maskData;
+    if (m_compiledMaskResolution > 0 &&
+        load_compiled_mask((tileDir / (tileName + ".mask")).string(), m_compiledMaskResolution, maskData)) {
+        apply_mask_to_verts(verts, maskData, m_compiledMaskResolution, tileSize, tileMinX, tileMinZ,
+                            m_compiledMaskIsLandclass ? &m_landclassFlags : nullptr);
+    }
+
+    auto mesh = std::make_unique<Mesh>();
+    std::vector<float> gridVerts;
+    if (!meshIndices.empty()) {
+        addAdaptiveSkirt(verts, meshIndices, m_compiledGridResolution, tileMinX, tileMinZ, tileSize,
+                         m_compiledSkirtDepth * static_cast<float>(span));
+        mesh->initIndexed(verts, meshIndices);
+    } else if (buildGridVerticesFromTriList(verts, m_compiledGridResolution, tileMinX, tileMinZ, tileSize, gridVerts)) {
+        int res = m_compiledGridResolution + 1;
+        std::vector<std::uint32_t> indices;
+        buildGridIndices(res, res, indices);
+        addSkirt(gridVerts, indices, res, res, m_compiledSkirtDepth * static_cast<float>(span));
+        mesh->initIndexed(gridVerts, indices);
+    } else {
+        mesh->init(verts);
+    }
+    m_compiledTilesLoadedThisFrame += 1;
+
+    TileResource resource;
+    resource.ownedMesh = std::move(mesh);
+    resource.mesh = resource.ownedMesh.get();
+    resource.center = Vec3(tileMinX + tileSize * 0.5f, 0.0f, tileMinZ + tileSize * 0.5f);
+    resource.radius = tileSize * 0.5f;
+    resource.tileMinX = tileMinX;
+    resource.tileMinZ = tileMinZ;
+    resource.tileSize = tileSize;
+    resource.level = level;
+    resource.x = x;
+    resource.y = y;
+    resource.compiled = true;
+    if (!maskData.empty()) {
+        auto tex = std::make_unique<Texture>();
+        if (tex->loadFromData(maskData.data(), m_compiledMaskResolution, m_compiledMaskResolution, 1, false)) {
+            resource.maskTexture = tex.get();
+            resource.ownedMaskTexture = std::move(tex);
+        }
+    }
+    std::vector<std::uint8_t> normalData;
+    if (m_compiledNormalMapResolution > 0 &&
+        load_compiled_normal_map((tileDir / (tileName + ".nrm")).string(), m_compiledNormalMapResolution, normalData)) {
+        auto tex = std::make_unique<Texture>();
+        if (tex->loadFromData(normalData.data(), m_compiledNormalMapResolution, m_compiledNormalMapResolution, 4, false)) {
+            resource.normalTexture = tex.get();
+            resource.ownedNormalTexture = std::move(tex);
+        }
+    }
+
+    auto inserted = m_tileCache.emplace(key, std::move(resource));
+    publishPhysicsGrid(inserted.first->second);
+    if (m_compiledDebugLog) {
+        std::cout << "[terrain] loaded compiled lod" << level << " tile " << x << "," << y << "\n";
+    }
+    return &inserted.first->second;
+}
+
 void TerrainRenderer::renderCompiled(const Mat4& vp, const Vec3& sunDir, const Vec3& cameraPos) {
     if (!m_shader) {
         m_shader = m_assets ? m_assets->getShader("basic") : nullptr;
@@ -860,30 +1239,109 @@ void TerrainRenderer::renderCompiled(const Mat4& vp, const Vec3& sunDir, const V
     std::vector<VisibleTile> visibleTiles;
     visibleTiles.reserve(desiredKeys.size());
 
-    for (int dy = -m_compiledVisibleRadius; dy <= m_compiledVisibleRadius; ++dy) {
-        for (int dx = -m_compiledVisibleRadius; dx <= m_compiledVisibleRadius; ++dx) {
-            int tx = centerX + dx;
-            int ty = centerY + dy;
-            if (m_compiledTiles.find(packedTileKey(tx, ty)) == m_compiledTiles.end()) {
-                continue;
+    auto addBaseTile = [&](int tx, int ty) {
+        if (m_compiledTiles.find(packedTileKey(tx, ty)) == m_compiledTiles.end()) {
+            return;
+        }
+        desiredKeys.insert(compiledTileKey(0, tx, ty));
+
+        TileResource* tile = ensureCompiledTileLoaded(tx, ty);
+        if (!tile || !tile->mesh) {
+            return;
+        }
+
+        float distX = tile->center.x - cameraPos.x;
+        float distZ = tile->center.z - cameraPos.z;
+        float distSq = distX * distX + distZ * distZ;
+        std::int64_t tileKey = packedTileKey(tx, ty);
+        bool wants = tile->meshLod1 && m_compiledLod1DistanceSq > 0.0f
+            && distSq >= m_compiledLod1DistanceSq;
+        wantsLod1[tileKey] = wants;
+        visibleTiles.push_back({tile, tileKey, distSq});
+    };
+
+    if (m_compiledLodLevels.empty()) {
+        for (int dy = -m_compiledVisibleRadius; dy <= m_compiledVisibleRadius; ++dy) {
+            for (int dx = -m_compiledVisibleRadius; dx <= m_compiledVisibleRadius; ++dx) {
+                addBaseTile(centerX + dx, centerY + dy);
             }
+        }
+    } else {
+        // Quadtree over the pyramid: a tile splits into its children once the
+        // camera is within the visible radius measured in child tiles and every
+        // child is loaded; until then the coarse tile keeps covering the area.
+        float originX = static_cast<float>(m_compiledLodOriginX) * m_compiledTileSizeMeters;
+        float originZ = static_cast<float>(m_compiledLodOriginY) * m_compiledTileSizeMeters;
+        float refineTiles = static_cast<float>(std::max(1, m_compiledVisibleRadius));
+        auto childExists = [&](int level, int x, int y) {
+            if (level == 0) {
+                return m_compiledTiles.count(packedTileKey(m_compiledLodOriginX + x, m_compiledLodOriginY + y)) != 0;
+            }
+            return m_compiledLodLevels[static_cast<size_t>(level - 1)].tiles.count(packedTileKey(x, y)) != 0;
+        };
+        auto childLoaded = [&](int level, int x, int y) {
+            TileResource* tile = level == 0
+                ? ensureCompiledTileLoaded(m_compiledLodOriginX + x, m_compiledLodOriginY + y)
+                : ensureCompiledLodTileLoaded(level, x, y);
+            return tile != nullptr;
+        };
 
-            std::string key = "C_x" + std::to_string(tx) + "_y" + std::to_string(ty);
-            desiredKeys.insert(key);
+        std::function<void(int, int, int)> visit = [&](int level, int x, int y) {
+            if (level == 0) {
+                addBaseTile(m_compiledLodOriginX + x, m_compiledLodOriginY + y);
+                return;
+            }
+            if (!childExists(level, x, y)) {
+                return;
+            }
+            float size = m_compiledLodLevels[static_cast<size_t>(level - 1)].tileSizeMeters;
+            float minX = originX + static_cast<float>(x) * size;
+            float minZ = originZ + static_cast<float>(y) * size;
+            float gapX = std::max({minX - cameraPos.x, cameraPos.x - (minX + size), 0.0f});
+            float gapZ = std::max({minZ - cameraPos.z, cameraPos.z - (minZ + size), 0.0f});
+            if (std::max(gapX, gapZ) <= size * 0.5f * refineTiles) {
+                bool ready = true;
+                for (int cy = y * 2; cy <= y * 2 + 1; ++cy) {
+                    for (int cx = x * 2; cx <= x * 2 + 1; ++cx) {
+                        if (childExists(level - 1, cx, cy) && !childLoaded(level - 1, cx, cy)) {
+                            ready = false;
+                        }
+                    }
+                }
+                for (int cy = y * 2; cy <= y * 2 + 1; ++cy) {
+                    for (int cx = x * 2; cx <= x * 2 + 1; ++cx) {
+                        if (ready) {
+                            visit(level - 1, cx, cy);
+                        } else if (childExists(level - 1, cx, cy)) {
+                            desiredKeys.insert(level - 1 == 0
+                                ? compiledTileKey(0, m_compiledLodOriginX + cx, m_compiledLodOriginY + cy)
+                                : compiledTileKey(level - 1, cx, cy));
+                        }
+                    }
+                }
+                if (ready) {
+                    return;
+                }
+            }
 
-            TileResource* tile = ensureCompiledTileLoaded(tx, ty);
+            desiredKeys.insert(compiledTileKey(level, x, y));
+            TileResource* tile = ensureCompiledLodTileLoaded(level, x, y);
             if (!tile || !tile->mesh) {
-                continue;
+                return;
             }
-
             float distX = tile->center.x - cameraPos.x;
             float distZ = tile->center.z - cameraPos.z;
-            float distSq = distX * distX + distZ * distZ;
-            std::int64_t tileKey = packedTileKey(tx, ty);
-            bool wants = tile->meshLod1 && m_compiledLod1DistanceSq > 0.0f
-                && distSq >= m_compiledLod1DistanceSq;
-            wantsLod1[tileKey] = wants;
-            visibleTiles.push_back({tile, tileKey, distSq});
+            visibleTiles.push_back({tile, packedTileKey(x, y), distX * distX + distZ * distZ});
+        };
+
+        int top = static_cast<int>(m_compiledLodLevels.size());
+        float topSize = m_compiledLodLevels.back().tileSizeMeters;
+        int topX = static_cast<int>(std::floor((cameraPos.x - originX) / topSize));
+        int topY = static_cast<int>(std::floor((cameraPos.z - originZ) / topSize));
+        for (int dy = -m_compiledLodRadius; dy <= m_compiledLodRadius; ++dy) {
+            for (int dx = -m_compiledLodRadius; dx <= m_compiledLodRadius; ++dx) {
+                visit(top, topX + dx, topY + dy);
+            }
         }
     }
 
@@ -919,12 +1377,21 @@ void TerrainRenderer::renderCompiled(const Mat4& vp, const Vec3& sunDir, const V
             bindTerrainTextures(activeShader, useMask);
         }
         bool hasMask = (tile->maskTexture != nullptr);
+        bool hasNormals = (tile->normalTexture != nullptr);
         activeShader->setBool("uTerrainHasMaskTex", hasMask);
+        activeShader->setBool("uTerrainHasNormalTex", hasNormals);
         if (hasMask) {
             tile->maskTexture->bind(5);
             activeShader->setInt("uTerrainMaskTex", 5);
+        }
+        if (hasNormals) {
+            tile->normalTexture->bind(17);
+            activeShader->setInt("uTerrainNormalTex", 17);
+        }
+        if (hasMask || hasNormals) {
+            // The baked normal map shares the mask's tile frame.
             activeShader->setVec2("uTerrainMaskOrigin", Vec2(tile->tileMinX, tile->tileMinZ));
-            float invSize = 1.0f / m_compiledTileSizeMeters;
+            float invSize = 1.0f / tile->tileSize;
             activeShader->setVec2("uTerrainMaskInvSize", Vec2(invSize, invSize));
         }
         Mesh* meshToDraw = useLod1 ? tile->meshLod1 : tile->mesh;
@@ -938,6 +1405,7 @@ void TerrainRenderer::renderCompiled(const Mat4& vp, const Vec3& sunDir, const V
                 activeShader->setMat4("uMVP", vp);
                 applyDirectionalLighting(activeShader, sunDir);
                 activeShader->setBool("uTerrainShading", false);
+                activeShader->setBool("uTerrainHasNormalTex", false);
                 activeShader->setBool("uTerrainUseTextures", false);
                 activeShader->setBool("uTerrainUseMasks", false);
                 activeShader->setBool("uUseUniformColor", false);
@@ -946,6 +1414,10 @@ void TerrainRenderer::renderCompiled(const Mat4& vp, const Vec3& sunDir, const V
         }
     }
 
+    // The runway pass can share this shader; keep it on vertex normals.
+    activeShader->use();
+    activeShader->setBool("uTerrainHasNormalTex", false);
+
     if (!m_tileCache.empty()) {
         std::vector<std::string> toRemove;
         toRemove.reserve(m_tileCache.size());
@@ -953,7 +1425,9 @@ void TerrainRenderer::renderCompiled(const Mat4& vp, const Vec3& sunDir, const V
             if (!pair.second.compiled) {
                 continue;
             }
-            if (desiredKeys.find(pair.first) == desiredKeys.end()) {
+            if (desiredKeys.find(pair.first) == desiredKeys.end()
+                && (pair.second.level != 0
+                    || m_physicsKeep.find(packedTileKey(pair.second.x, pair.second.y)) == m_physicsKeep.end())) {
                 toRemove.push_back(pair.first);
             }
         }
@@ -963,7 +1437,14 @@ void TerrainRenderer::renderCompiled(const Mat4& vp, const Vec3& sunDir, const V
                 continue;
             }
             if (m_compiledDebugLog) {
-                std::cout << "[terrain] unloaded compiled tile " << it->second.x << "," << it->second.y << "\n";
+                std::cout << "[terrain] unloaded compiled tile " << it->second.x << "," << it->second.y;
+                if (it->second.level > 0) {
+                    std::cout << " (lod" << it->second.level << ")";
+                }
+                std::cout << "\n";
+            }
+            if (it->second.level == 0) {
+                withdrawPhysicsGrid(it->second.x, it->second.y);
             }
             m_tileCache.erase(it);
         }
@@ -9,11 +9,13 @@
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
+#include <optional>
 
 namespace nuage {
 
 namespace {
 constexpr double kFtToM = 0.3048;
+constexpr float kRunwayGridCellMeters = 2000.0f;
 
 bool parseNumber(const nlohmann::json& value, double& out) {
     if (value.is_number_float() || value.is_number_integer() || value.is_number_unsigned()) {
@@ -35,8 +37,11 @@ void TerrainRenderer::loadRunways(const nlohmann::json& config, const std::strin
     m_runwayMesh.reset();
     m_runwaysEnabled = false;
     m_runwayColliders.clear();
+    m_runwayGrid = SpatialGrid();
     m_runwayTexture = nullptr;
     m_runwayLayers.clear();
+    m_airports = AirportDatabase();
+    m_airportsLoaded = false;
 
     if (!config.contains("runways") || !config["runways"].is_object()) {
         return;
@@ -91,17 +96,38 @@ void TerrainRenderer::loadRunways(const nlohmann::json& config, const std::strin
         m_runwayTexture = loadTexture("runway_tex_base", runwayTexPath, true);
     }
 
-    std::string runwaysPath = resolve(runwaysConfig.value("json", ""));
+    // The binary airport database replaces the runways JSON when present.
+    std::string databasePath = resolve(runwaysConfig.value("database", ""));
+    if (!databasePath.empty() && std::filesystem::exists(databasePath)) {
+        m_airportsLoaded = m_airports.load(databasePath);
+        // Records are in ENU, so a database built for another origin is stale.
+        if (m_airportsLoaded && m_compiledOriginValid &&
+            (std::abs(m_airports.originLatDeg() - m_compiledOrigin.latDeg) > 1e-7 ||
+             std::abs(m_airports.originLonDeg() - m_compiledOrigin.lonDeg) > 1e-7 ||
+             std::abs(m_airports.originAltMeters() - m_compiledOrigin.altMeters) > 1e-3)) {
+            std::cerr << "[runways] airport database origin does not match the terrain, ignoring: "
+                      << databasePath << "\n";
+            m_airports = AirportDatabase();
+            m_airportsLoaded = false;
+        }
+        if (m_airportsLoaded) {
+            std::cout << "[runways] airport database: " << m_airports.airportCount() << " airports, "
+                      << m_airports.runwayCount() << " runways\n";
+        }
+    }
+    std::string runwaysPath = m_airportsLoaded ? databasePath : resolve(runwaysConfig.value("json", ""));
     if (runwaysPath.empty()) {
         return;
     }
 
-    auto runwaysOpt = loadJsonConfig(runwaysPath);
-    if (!runwaysOpt) {
-        std::cerr << "Failed to load runways JSON: " << runwaysPath << "\n";
-        return;
+    std::optional<nlohmann::json> runwaysOpt;
+    if (!m_airportsLoaded) {
+        runwaysOpt = loadJsonConfig(runwaysPath);
+        if (!runwaysOpt) {
+            std::cerr << "Failed to load runways JSON: " << runwaysPath << "\n";
+            return;
+        }
     }
-    const auto& runways = *runwaysOpt;
 
     if (runwaysConfig.contains("color") && runwaysConfig["color"].is_array()
         && runwaysConfig["color"].size() == 3) {
@@ -172,8 +198,154 @@ void TerrainRenderer::loadRunways(const nlohmann::json& config, const std::strin
         push(buffer, p2, uv2);
         push(buffer, p3, uv3);
     };
-    if (runways.contains("runways") && runways["runways"].is_array()) {
-        for (const auto& runway : runways["runways"]) {
+    auto addRunway = [&](Vec3 lePos, Vec3 hePos, float widthMeters) {
+        if (snapToTerrain) {
+            float groundY = 0.0f;
+            if (sampleTerrainHeight(lePos.x, lePos.z, groundY)) {
+                lePos.y = groundY;
+            }
+            if (sampleTerrainHeight(hePos.x, hePos.z, groundY)) {
+                hePos.y = groundY;
+            }
+        }
+
+        float dx = hePos.x - lePos.x;
+        float dz = hePos.z - lePos.z;
+        float length = std::sqrt(dx * dx + dz * dz);
+        if (length < 1.0f) {
+            return;
+        }
+        Vec3 dir(dx / length, 0.0f, dz / length);
+        Vec3 perp(-dir.z, 0.0f, dir.x);
+        float halfWidth = widthMeters * 0.5f;
+        float halfLength = length * 0.5f;
+
+        RunwayCollider collider;
+        collider.center = (lePos + hePos) * 0.5f;
+        collider.dir = dir;
+        collider.perp = perp;
+        collider.halfLength = halfLength;
+        collider.halfWidth = halfWidth;
+        collider.h0 = lePos.y;
+        collider.h1 = hePos.y;
+        m_runwayColliders.push_back(collider);
+
+        Vec3 leOffset = perp * halfWidth;
+        Vec3 heOffset = perp * halfWidth;
+
+        Vec3 p0(lePos.x + leOffset.x, lePos.y + m_runwayHeightOffset, lePos.z + leOffset.z);
+        Vec3 p1(lePos.x - leOffset.x, lePos.y + m_runwayHeightOffset, lePos.z - leOffset.z);
+        Vec3 p2(hePos.x - heOffset.x, hePos.y + m_runwayHeightOffset, hePos.z - heOffset.z);
+        Vec3 p3(hePos.x + heOffset.x, hePos.y + m_runwayHeightOffset, hePos.z + heOffset.z);
+        float uvU0 = (widthMeters * 0.5f) / std::max(0.1f, runwayTexScaleU);
+        float uvU1 = -uvU0;
+        float uvV0 = 0.0f;
+        float uvV1 = length / std::max(0.1f, runwayTexScaleV);
+
+        push(verts, p0, Vec2(uvU0, uvV0));
+        push(verts, p1, Vec2(uvU1, uvV0));
+        push(verts, p2, Vec2(uvU1, uvV1));
+
+        push(verts, p0, Vec2(uvU0, uvV0));
+        push(verts, p2, Vec2(uvU1, uvV1));
+        push(verts, p3, Vec2(uvU0, uvV1));
+
+        if (markingsEnabled) {
+            auto lerpY = [&](float t) {
+                return lePos.y + (hePos.y - lePos.y) * t;
+            };
+            float safeInset = std::min(centerlineInsetMeters, length * 0.4f);
+            float centerlineLength = length - 2.0f * safeInset;
+            if (centerlineTex && centerlineLength > 1.0f) {
+                Vec3 start = lePos + dir * safeInset;
+                Vec3 end = hePos - dir * safeInset;
+                start.y = lerpY(safeInset / length) + markingsHeightOffset;
+                end.y = lerpY(1.0f - safeInset / length) + markingsHeightOffset;
+                float halfCenterline = centerlineWidthMeters * 0.5f;
+                Vec3 clOffset = perp * halfCenterline;
+                Vec3 c0(start.x + clOffset.x, start.y, start.z + clOffset.z);
+                Vec3 c1(start.x - clOffset.x, start.y, start.z - clOffset.z);
+                Vec3 c2(end.x - clOffset.x, end.y, end.z - clOffset.z);
+                Vec3 c3(end.x + clOffset.x, end.y, end.z + clOffset.z);
+                float uvV = centerlineLength / centerlineRepeatMeters;
+                pushQuad(centerlineVerts, c0, c1, c2, c3,
+                         Vec2(0.0f, 0.0f), Vec2(1.0f, 0.0f),
+                         Vec2(1.0f, uvV), Vec2(0.0f, uvV));
+            }
+
+            float thresholdWidth = std::max(1.0f, widthMeters - 2.0f * edgeInsetMeters);
+            float thresholdHalfWidth = thresholdWidth * 0.5f;
+            float thresholdEnd = thresholdInsetMeters + thresholdDepthMeters;
+            if (thresholdTex && thresholdEnd < length * 0.45f) {
+                auto addThreshold = [&](const Vec3& base, float t0, float t1) {
+                    Vec3 a = base + dir * t0;
+                    Vec3 b = base + dir * t1;
+                    a.y = lerpY(t0 / length) + markingsHeightOffset;
+                    b.y = lerpY(t1 / length) + markingsHeightOffset;
+                    Vec3 offset = perp * thresholdHalfWidth;
+                    Vec3 q0(a.x + offset.x, a.y, a.z + offset.z);
+                    Vec3 q1(a.x - offset.x, a.y, a.z - offset.z);
+                    Vec3 q2(b.x - offset.x, b.y, b.z - offset.z);
+                    Vec3 q3(b.x + offset.x, b.y, b.z + offset.z);
+                    pushQuad(thresholdVerts, q0, q1, q2, q3,
+                             Vec2(0.0f, 0.0f), Vec2(1.0f, 0.0f),
+                             Vec2(1.0f, 1.0f), Vec2(0.0f, 1.0f));
+                };
+                addThreshold(lePos, thresholdInsetMeters, thresholdEnd);
+                float t1 = length - thresholdInsetMeters;
+                float t0 = length - thresholdEnd;
+                addThreshold(lePos, t0, t1);
+            }
+
+            float aimWidth = aimWidthMeters;
+            if (aimWidth <= 0.1f) {
+                aimWidth = std::max(6.0f, widthMeters * 0.2f);
+            }
+            aimWidth = std::min(aimWidth, widthMeters - 2.0f * edgeInsetMeters);
+            aimWidth = std::max(0.1f, aimWidth);
+            float aimHalfWidth = aimWidth * 0.5f;
+            float aimHalfDepth = aimDepthMeters * 0.5f;
+            if (aimTex && aimOffsetMeters + aimHalfDepth < length * 0.5f) {
+                auto addAim = [&](float centerDist) {
+                    float t0 = centerDist - aimHalfDepth;
+                    float t1 = centerDist + aimHalfDepth;
+                    Vec3 a = lePos + dir * t0;
+                    Vec3 b = lePos + dir * t1;
+                    a.y = lerpY(t0 / length) + markingsHeightOffset;
+                    b.y = lerpY(t1 / length) + markingsHeightOffset;
+                    Vec3 offset = perp * aimHalfWidth;
+                    Vec3 q0(a.x + offset.x, a.y, a.z + offset.z);
+                    Vec3 q1(a.x - offset.x, a.y, a.z - offset.z);
+                    Vec3 q2(b.x - offset.x, b.y, b.z - offset.z);
+                    Vec3 q3(b.x + offset.x, b.y, b.z + offset.z);
+                    pushQuad(aimVerts, q0, q1, q2, q3,
+                             Vec2(0.0f, 0.0f), Vec2(1.0f, 0.0f),
+                             Vec2(1.0f, 1.0f), Vec2(0.0f, 1.0f));
+                };
+                if (aimOffsetMeters + aimHalfDepth < length) {
+                    addAim(aimOffsetMeters);
+                }
+                if (length - aimOffsetMeters - aimHalfDepth > 0.0f) {
+                    addAim(length - aimOffsetMeters);
+                }
+            }
+        }
+    };
+
+    if (m_airportsLoaded) {
+        for (const auto& runway : m_airports.runways()) {
+            if (runway.flags & RunwayClosed) {
+                continue;
+            }
+            float widthMeters = static_cast<float>(runway.widthFt * kFtToM);
+            if (widthMeters <= 0.1f) {
+                continue;
+            }
+            addRunway(Vec3(runway.le[0], runway.le[1], runway.le[2]),
+                      Vec3(runway.he[0], runway.he[1], runway.he[2]), widthMeters);
+        }
+    } else if (runwaysOpt->contains("runways") && (*runwaysOpt)["runways"].is_array()) {
+        for (const auto& runway : (*runwaysOpt)["runways"]) {
             if (!runway.is_object()) {
                 continue;
             }
@@ -199,142 +371,25 @@ void TerrainRenderer::loadRunways(const nlohmann::json& config, const std::strin
                 continue;
             }
 
-            Vec3 lePos(le[0].get<float>(), le[1].get<float>(), le[2].get<float>());
-            Vec3 hePos(he[0].get<float>(), he[1].get<float>(), he[2].get<float>());
-            if (snapToTerrain) {
-                float groundY = 0.0f;
-                if (sampleTerrainHeight(lePos.x, lePos.z, groundY)) {
-                    lePos.y = groundY;
-                }
-                if (sampleTerrainHeight(hePos.x, hePos.z, groundY)) {
-                    hePos.y = groundY;
-                }
-            }
-
-            float dx = hePos.x - lePos.x;
-            float dz = hePos.z - lePos.z;
-            float length = std::sqrt(dx * dx + dz * dz);
-            if (length < 1.0f) {
-                continue;
-            }
-            Vec3 dir(dx / length, 0.0f, dz / length);
-            Vec3 perp(-dir.z, 0.0f, dir.x);
-            float halfWidth = widthMeters * 0.5f;
-            float halfLength = length * 0.5f;
-
-            RunwayCollider collider;
-            collider.center = (lePos + hePos) * 0.5f;
-            collider.dir = dir;
-            collider.perp = perp;
-            collider.halfLength = halfLength;
-            collider.halfWidth = halfWidth;
-            collider.h0 = lePos.y;
-            collider.h1 = hePos.y;
-            m_runwayColliders.push_back(collider);
-
-            Vec3 leOffset = perp * halfWidth;
-            Vec3 heOffset = perp * halfWidth;
-
-            Vec3 p0(lePos.x + leOffset.x, lePos.y + m_runwayHeightOffset, lePos.z + leOffset.z);
-            Vec3 p1(lePos.x - leOffset.x, lePos.y + m_runwayHeightOffset, lePos.z - leOffset.z);
-            Vec3 p2(hePos.x - heOffset.x, hePos.y + m_runwayHeightOffset, hePos.z - heOffset.z);
-            Vec3 p3(hePos.x + heOffset.x, hePos.y + m_runwayHeightOffset, hePos.z + heOffset.z);
-            float uvU0 = (widthMeters * 0.5f) / std::max(0.1f, runwayTexScaleU);
-            float uvU1 = -uvU0;
-            float uvV0 = 0.0f;
-            float uvV1 = length / std::max(0.1f, runwayTexScaleV);
-
-            push(verts, p0, Vec2(uvU0, uvV0));
-            push(verts, p1, Vec2(uvU1, uvV0));
-            push(verts, p2, Vec2(uvU1, uvV1));
-
-            push(verts, p0, Vec2(uvU0, uvV0));
-            push(verts, p2, Vec2(uvU1, uvV1));
-            push(verts, p3, Vec2(uvU0, uvV1));
-
-            if (markingsEnabled) {
-                auto lerpY = [&](float t) {
-                    return lePos.y + (hePos.y - lePos.y) * t;
-                };
-                float safeInset = std::min(centerlineInsetMeters, length * 0.4f);
-                float centerlineLength = length - 2.0f * safeInset;
-                if (centerlineTex && centerlineLength > 1.0f) {
-                    Vec3 start = lePos + dir * safeInset;
-                    Vec3 end = hePos - dir * safeInset;
-                    start.y = lerpY(safeInset / length) + markingsHeightOffset;
-                    end.y = lerpY(1.0f - safeInset / length) + markingsHeightOffset;
-                    float halfCenterline = centerlineWidthMeters * 0.5f;
-                    Vec3 clOffset = perp * halfCenterline;
-                    Vec3 c0(start.x + clOffset.x, start.y, start.z + clOffset.z);
-                    Vec3 c1(start.x - clOffset.x, start.y, start.z - clOffset.z);
-                    Vec3 c2(end.x - clOffset.x, end.y, end.z - clOffset.z);
-                    Vec3 c3(end.x + clOffset.x, end.y, end.z + clOffset.z);
-                    float uvV = centerlineLength / centerlineRepeatMeters;
-                    pushQuad(centerlineVerts, c0, c1, c2, c3,
-                             Vec2(0.0f, 0.0f), Vec2(1.0f, 0.0f),
-                             Vec2(1.0f, uvV), Vec2(0.0f, uvV));
-                }
-
-                float thresholdWidth = std::max(1.0f, widthMeters - 2.0f * edgeInsetMeters);
-                float thresholdHalfWidth = thresholdWidth * 0.5f;
-                float thresholdEnd = thresholdInsetMeters + thresholdDepthMeters;
-                if (thresholdTex && thresholdEnd < length * 0.45f) {
-                    auto addThreshold = [&](const Vec3& base, float t0, float t1) {
-                        Vec3 a = base + dir * t0;
-                        Vec3 b = base + dir * t1;
-                        a.y = lerpY(t0 / length) + markingsHeightOffset;
-                        b.y = lerpY(t1 / length) + markingsHeightOffset;
-                        Vec3 offset = perp * thresholdHalfWidth;
-                        Vec3 q0(a.x + offset.x, a.y, a.z + offset.z);
-                        Vec3 q1(a.x - offset.x, a.y, a.z - offset.z);
-                        Vec3 q2(b.x - offset.x, b.y, b.z - offset.z);
-                        Vec3 q3(b.x + offset.x, b.y, b.z + offset.z);
-                        pushQuad(thresholdVerts, q0, q1, q2, q3,
-                                 Vec2(0.0f, 0.0f), Vec2(1.0f, 0.0f),
-                                 Vec2(1.0f, 1.0f), Vec2(0.0f, 1.0f));
-                    };
-                    addThreshold(lePos, thresholdInsetMeters, thresholdEnd);
-                    float t1 = length - thresholdInsetMeters;
-                    float t0 = length - thresholdEnd;
-                    addThreshold(lePos, t0, t1);
-                }
-
-                float aimWidth = aimWidthMeters;
-                if (aimWidth <= 0.1f) {
-                    aimWidth = std::max(6.0f, widthMeters * 0.2f);
-                }
-                aimWidth = std::min(aimWidth, widthMeters - 2.0f * edgeInsetMeters);
-                aimWidth = std::max(0.1f, aimWidth);
-                float aimHalfWidth = aimWidth * 0.5f;
-                float aimHalfDepth = aimDepthMeters * 0.5f;
-                if (aimTex && aimOffsetMeters + aimHalfDepth < length * 0.5f) {
-                    auto addAim = [&](float centerDist) {
-                        float t0 = centerDist - aimHalfDepth;
-                        float t1 = centerDist + aimHalfDepth;
-                        Vec3 a = lePos + dir * t0;
-                        Vec3 b = lePos + dir * t1;
-                        a.y = lerpY(t0 / length) + markingsHeightOffset;
-                        b.y = lerpY(t1 / length) + markingsHeightOffset;
-                        Vec3 offset = perp * aimHalfWidth;
-                        Vec3 q0(a.x + offset.x, a.y, a.z + offset.z);
-                        Vec3 q1(a.x - offset.x, a.y, a.z - offset.z);
-                        Vec3 q2(b.x - offset.x, b.y, b.z - offset.z);
-                        Vec3 q3(b.x + offset.x, b.y, b.z + offset.z);
-                        pushQuad(aimVerts, q0, q1, q2, q3,
-                                 Vec2(0.0f, 0.0f), Vec2(1.0f, 0.0f),
-                                 Vec2(1.0f, 1.0f), Vec2(0.0f, 1.0f));
-                    };
-                    if (aimOffsetMeters + aimHalfDepth < length) {
-                        addAim(aimOffsetMeters);
-                    }
-                    if (length - aimOffsetMeters - aimHalfDepth > 0.0f) {
-                        addAim(length - aimOffsetMeters);
-                    }
-                }
-            }
+            addRunway(Vec3(le[0].get<float>(), le[1].get<float>(), le[2].get<float>()),
+                      Vec3(he[0].get<float>(), he[1].get<float>(), he[2].get<float>()), widthMeters);
         }
     }
 
+    std::vector<SpatialGrid::Bounds> colliderBounds;
+    colliderBounds.reserve(m_runwayColliders.size());
+    for (const auto& collider : m_runwayColliders) {
+        float extentX = std::abs(collider.dir.x) * collider.halfLength + std::abs(collider.perp.x) * collider.halfWidth;
+        float extentZ = std::abs(collider.dir.z) * collider.halfLength + std::abs(collider.perp.z) * collider.halfWidth;
+        colliderBounds.push_back({collider.center.x - extentX, collider.center.z - extentZ,
+                                  collider.center.x + extentX, collider.center.z + extentZ});
+    }
+    m_runwayGrid.build(colliderBounds, kRunwayGridCellMeters);
+
+    if (m_heightsOnly) {
+        std::cout << "[runways] loaded " << m_runwayColliders.size() << " runway colliders from " << runwaysPath << "\n";
+        return;
+    }
     if (!verts.empty()) {
         m_runwayMesh = std::make_unique<Mesh>();
         m_runwayMesh->initTextured(verts);
@@ -364,12 +419,18 @@ bool TerrainRenderer::sampleRunway(float worldX, float worldZ, TerrainSample& ou
     if (!m_runwaysEnabled || m_runwayColliders.empty()) {
         return false;
     }
-    for (const auto& runway : m_runwayColliders) {
+    // Cells list colliders in load order, so overlaps resolve as before.
+    bool found = false;
+    m_runwayGrid.queryPoint(worldX, worldZ, [&](std::uint32_t index) {
+        if (found) {
+            return;
+        }
+        const auto& runway = m_runwayColliders[index];
         Vec3 delta(worldX - runway.center.x, 0.0f, worldZ - runway.center.z);
         float along = delta.x * runway.dir.x + delta.z * runway.dir.z;
         float side = delta.x * runway.perp.x + delta.z * runway.perp.z;
         if (std::abs(along) > runway.halfLength || std::abs(side) > runway.halfWidth) {
-            continue;
+            return;
         }
         float t = (along + runway.halfLength) / (2.0f * runway.halfLength);
         t = std::clamp(t, 0.0f, 1.0f);
@@ -391,9 +452,9 @@ bool TerrainRenderer::sampleRunway(float worldX, float worldZ, TerrainSample& ou
         outSample.urban = 0.0f;
         outSample.forest = 0.0f;
         outSample.onRunway = true;
-        return true;
-    }
-    return false;
+        found = true;
+    });
+    return found;
 }
 
 } // namespace nuage
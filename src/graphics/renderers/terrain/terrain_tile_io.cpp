@@ -3,24 +3,62 @@
 
 namespace nuage {
 
-bool load_compiled_mesh(const std::string& path, std::vector<float>& out) {
+bool load_compiled_mesh(const std::string& path, std::vector<float>& out,
+                        std::vector<std::uint32_t>* outIndices) {
     std::ifstream in(path, std::ios::binary);
     if (!in.is_open()) {
         return false;
     }
+    if (outIndices) {
+        outIndices->clear();
+    }
     char magic[4] = {};
     in.read(magic, 4);
-    if (in.gcount() != 4 || std::string(magic, 4) != "NTM1") {
+    std::string format(magic, 4);
+    if (in.gcount() != 4 || (format != "NTM1" && format != "NTM2")) {
         return false;
     }
     std::uint32_t count = 0;
     in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    std::uint32_t indexCount = 0;
+    if (format == "NTM2") {
+        in.read(reinterpret_cast<char*>(&indexCount), sizeof(indexCount));
+    }
     if (!in || count == 0) {
         return false;
     }
     out.resize(count);
     in.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(count * sizeof(float)));
-    return static_cast<std::size_t>(in.gcount()) == count * sizeof(float);
+    if (static_cast<std::size_t>(in.gcount()) != count * sizeof(float)) {
+        return false;
+    }
+    if (format == "NTM1") {
+        return true;
+    }
+
+    std::vector<std::uint32_t> indices(indexCount);
+    in.read(reinterpret_cast<char*>(indices.data()), static_cast<std::streamsize>(indexCount * sizeof(std::uint32_t)));
+    if (static_cast<std::size_t>(in.gcount()) != indexCount * sizeof(std::uint32_t) || indexCount % 3 != 0) {
+        return false;
+    }
+    std::size_t vertexCount = count / 9;
+    for (std::uint32_t index : indices) {
+        if (index >= vertexCount) {
+            return false;
+        }
+    }
+    if (outIndices) {
+        *outIndices = std::move(indices);
+        return true;
+    }
+    // Callers without index support get the equivalent triangle list.
+    std::vector<float> expanded;
+    expanded.reserve(indices.size() * 9);
+    for (std::uint32_t index : indices) {
+        expanded.insert(expanded.end(), out.begin() + index * 9, out.begin() + index * 9 + 9);
+    }
+    out = std::move(expanded);
+    return true;
 }
 
 bool load_compiled_mask(const std::string& path, int expectedRes, std::vector<std::uint8_t>& out) {
@@ -37,4 +75,18 @@ bool load_compiled_mask(const std::string& path, int expectedRes, std::vector<st
     return static_cast<std::size_t>(in.gcount()) == size;
 }
 
+bool load_compiled_normal_map(const std::string& path, int expectedRes, std::vector<std::uint8_t>& out) {
+    if (expectedRes <= 0) {
+        return false;
+    }
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    size_t size = static_cast<size_t>(expectedRes * expectedRes) * 4;
+    out.resize(size);
+    in.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(size));
+    return static_cast<std::size_t>(in.gcount()) == size;
+}
+
 } // namespace nuage
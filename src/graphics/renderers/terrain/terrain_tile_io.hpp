@@ -6,7 +6,12 @@
 
 namespace nuage {
 
-bool load_compiled_mesh(const std::string& path, std::vector<float>& out);
+// Reads an NTM1 triangle list or an NTM2 indexed mesh. NTM2 indices go to
+// outIndices when given; otherwise the mesh is expanded to a triangle list.
+bool load_compiled_mesh(const std::string& path, std::vector<float>& out,
+                        std::vector<std::uint32_t>* outIndices = nullptr);
 bool load_compiled_mask(const std::string& path, int expectedRes, std::vector<std::uint8_t>& out);
+// Reads a baked RGBA normal map (normal in rgb, curvature in a).
+bool load_compiled_normal_map(const std::string& path, int expectedRes, std::vector<std::uint8_t>& out);
 
 } // namespace nuage
@@ -31,6 +31,7 @@ void TerrainVisualSettings::resetDefaults() {
     distanceDesatStrength = 0.35f;
     distanceContrastLoss = 0.25f;
     fogSunScale = 0.35f;
+    curvatureShading = 0.35f;
 }
 
 void TerrainVisualSettings::setHeightRange(float minHeight, float maxHeight) {
@@ -58,6 +59,7 @@ void TerrainVisualSettings::applyConfig(const nlohmann::json& config) {
     distanceDesatStrength = visuals.value("distanceDesatStrength", distanceDesatStrength);
     distanceContrastLoss = visuals.value("distanceContrastLoss", distanceContrastLoss);
     fogSunScale = visuals.value("fogSunScale", fogSunScale);
+    curvatureShading = visuals.value("curvatureShading", curvatureShading);
     if (visuals.contains("tint") && visuals["tint"].is_array() && visuals["tint"].size() == 3) {
         tint = Vec3(
             visuals["tint"][0].get<float>(),
@@ -77,6 +79,7 @@ void TerrainVisualSettings::clamp() {
     distanceDesatStrength = std::clamp(distanceDesatStrength, 0.0f, 1.0f);
     distanceContrastLoss = std::clamp(distanceContrastLoss, 0.0f, 1.0f);
     fogSunScale = std::clamp(fogSunScale, 0.0f, 0.95f);
+    curvatureShading = std::clamp(curvatureShading, 0.0f, 1.0f);
 }
 
 Vec3 TerrainVisualSettings::fogColorForSunDir(const Vec3& sunDir) const {
@@ -124,6 +127,7 @@ void TerrainVisualSettings::bind(Shader* shader, const Vec3& sunDir, const Vec3&
     shader->setFloat("uTerrainDistanceDesatEnd", distanceDesatEnd);
     shader->setFloat("uTerrainDistanceDesatStrength", distanceDesatStrength);
     shader->setFloat("uTerrainDistanceContrastLoss", distanceContrastLoss);
+    shader->setFloat("uTerrainCurvatureStrength", curvatureShading);
 }
 
 } // namespace nuage
@@ -24,6 +24,7 @@ struct TerrainVisualSettings {
     float distanceDesatStrength = 0.35f;
     float distanceContrastLoss = 0.25f;
     float fogSunScale = 0.35f;
+    float curvatureShading = 0.35f;
 
     void resetDefaults();
     void setHeightRange(float minHeight, float maxHeight);
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <iterator>
 
 namespace nuage {
 
@@ -24,6 +25,7 @@ void TerrainRenderer::init(AssetStore& assets) {
 
 void TerrainRenderer::shutdown() {
     m_tileCache.clear();
+    clearPhysicsGrids();
     m_compiledTileCreateCounts.clear();
     m_compiledTiles.clear();
     m_compiledTilesLoadedThisFrame = 0;
@@ -68,13 +70,38 @@ void TerrainRenderer::setTreesEnabled(bool enabled) {
         m_tileCache.clear();
         m_compiledTileCreateCounts.clear();
         m_compiledTileRebuilds = 0;
+        // Trees do not change heights, so tiles physics is using stay
+        // sampleable until the next updatePhysicsTiles() reloads them.
+        std::lock_guard<std::mutex> lock(m_physicsMutex);
+        for (auto it = m_physicsGrids.begin(); it != m_physicsGrids.end();) {
+            it = m_physicsKeep.count(it->first) ? std::next(it) : m_physicsGrids.erase(it);
+        }
     }
 }
 
+void TerrainRenderer::setPhysicsThreaded(bool threaded) {
+    m_physicsThreaded = threaded;
+}
+
 void TerrainRenderer::setup(const std::string& configPath, AssetStore& assets) {
     m_assets = &assets;
+    m_heightsOnly = false;
+    setupTerrain(configPath);
+}
+
+void TerrainRenderer::setupHeightsOnly(const std::string& configPath) {
+    m_assets = nullptr;
+    m_heightsOnly = true;
+    // Nothing renders, so tiles come and go only as physics asks for them,
+    // exactly as when physics runs on its own thread.
+    m_physicsThreaded = true;
+    setupTerrain(configPath);
+}
+
+void TerrainRenderer::setupTerrain(const std::string& configPath) {
     m_compiled = false;
     m_tileCache.clear();
+    clearPhysicsGrids();
     m_compiledTileCreateCounts.clear();
     m_compiledTileRebuilds = 0;
     m_mesh = nullptr;
@@ -188,6 +215,15 @@ bool TerrainRenderer::sampleSurfaceHeight(float worldX, float worldZ, float& out
     return true;
 }
 
+bool TerrainRenderer::samplePhysicsHeight(float worldX, float worldZ, float& outHeight) const {
+    TerrainSample sample;
+    if (!samplePhysicsSurface(worldX, worldZ, sample)) {
+        return false;
+    }
+    outHeight = sample.height;
+    return true;
+}
+
 bool TerrainRenderer::sampleSurfaceHeightNoLoad(float worldX, float worldZ, float& outHeight) const {
     TerrainSample sample;
     if (!sampleSurfaceNoLoad(worldX, worldZ, sample)) {
@@ -5,6 +5,7 @@
 #include "math/vec3.hpp"
 #include "graphics/renderers/terrain/terrain_visual_settings.hpp"
 #include "graphics/texture_array.hpp"
+#include "utils/airport_db.hpp"
 #include "utils/json.hpp"
 #include <array>
 #include <unordered_map>
@@ -12,6 +13,7 @@
 #include <vector>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <unordered_set>
 
 namespace nuage {
@@ -82,11 +84,18 @@ public:
     void init(AssetStore& assets);
     void shutdown();
     void setup(const std::string& configPath, AssetStore& assets);
+    // Loads only what sampling needs (height grids, landclass flags, runway
+    // colliders and airports) without an AssetStore or GL context. Tiles are
+    // loaded and evicted through requestPhysicsTiles()/updatePhysicsTiles().
+    void setupHeightsOnly(const std::string& configPath);
+    bool heightsOnly() const { return m_heightsOnly; }
     void render(const Mat4& viewProjection, const Vec3& sunDir, const Vec3& cameraPos);
     bool isCompiled() const { return m_compiled; }
     bool treesEnabled() const { return m_treesEnabled; }
     bool hasCompiledOrigin() const { return m_compiledOriginValid; }
     GeoOrigin compiledOrigin() const { return m_compiledOrigin; }
+    // Airport database from the runways config, or null when none was loaded.
+    const AirportDatabase* airports() const { return m_airportsLoaded ? &m_airports : nullptr; }
     Vec3 compiledGeoToWorld(double latDeg, double lonDeg, double altMeters) const;
     bool sampleSurface(float worldX, float worldZ, TerrainSample& outSample) const;
     bool sampleSurfaceNoLoad(float worldX, float worldZ, TerrainSample& outSample) const;
@@ -94,6 +103,19 @@ public:
     bool sampleSurfaceHeight(float worldX, float worldZ, float& outHeight) const;
     bool sampleSurfaceHeightNoLoad(float worldX, float worldZ, float& outHeight) const;
     void preloadPhysicsAt(float worldX, float worldZ, int radius = 0);
+
+    // Physics-side access. When physics runs on its own thread, or steps
+    // aircraft on several, it must not load tiles or touch the cache: it
+    // samples grids the render thread has published and queues the tiles it
+    // needs, which updatePhysicsTiles() loads on the render thread and keeps
+    // resident while they are wanted. Unthreaded, these behave like the
+    // loading samplers above.
+    void setPhysicsThreaded(bool threaded);
+    bool physicsThreaded() const { return m_physicsThreaded; }
+    bool samplePhysicsSurface(float worldX, float worldZ, TerrainSample& outSample) const;
+    bool samplePhysicsHeight(float worldX, float worldZ, float& outHeight) const;
+    void requestPhysicsTiles(float worldX, float worldZ, int radius) const;
+    void updatePhysicsTiles();
     int compiledVisibleRadius() const { return m_compiledVisibleRadius; }
     int compiledLoadsPerFrame() const { return m_compiledLoadsPerFrame; }
     void setCompiledVisibleRadius(int radius);
@@ -119,10 +141,13 @@ private:
         Texture* texture = nullptr;
         std::unique_ptr<Texture> ownedMaskTexture;
         Texture* maskTexture = nullptr;
+        std::unique_ptr<Texture> ownedNormalTexture;
+        Texture* normalTexture = nullptr;
         Vec3 center{0, 0, 0};
         float radius = 0.0f;
         float tileMinX = 0.0f;
         float tileMinZ = 0.0f;
+        float tileSize = 0.0f;
         int level = 0;
         int x = 0;
         int y = 0;
@@ -130,12 +155,21 @@ private:
         bool textured = false;
         bool compiled = false;
         bool hasGrid = false;
-        std::vector<float> gridVerts;
+        // Shared so the physics thread can keep sampling a tile the render
+        // thread has since evicted.
+        std::shared_ptr<const std::vector<float>> gridVerts;
+    };
+
+    struct PhysicsGrid {
+        std::shared_ptr<const std::vector<float>> verts;
+        int res = 0;
     };
 
+    void setupTerrain(const std::string& configPath);
     void setupCompiled(const std::string& configPath);
     void renderCompiled(const Mat4& viewProjection, const Vec3& sunDir, const Vec3& cameraPos);
     TileResource* ensureCompiledTileLoaded(int x, int y, bool force = false);
+    TileResource* ensureCompiledLodTileLoaded(int level, int x, int y);
     std::int64_t packedTileKey(int x, int y) const;
     void applyTextureConfig(const nlohmann::json& config, const std::string& configPath);
     void bindTerrainTextures(Shader* shader, bool useMasks) const;
@@ -147,6 +181,9 @@ private:
                                bool forceLoad, TerrainSample& outSample) const;
     bool sampleCompiledSurfaceCached(int tx, int ty, float worldX, float worldZ,
                                      TerrainSample& outSample) const;
+    void publishPhysicsGrid(const TileResource& tile);
+    void withdrawPhysicsGrid(int x, int y);
+    void clearPhysicsGrids();
 
     Mesh* m_mesh = nullptr;
     Shader* m_shader = nullptr;
@@ -196,8 +233,12 @@ private:
         float h1 = 0.0f;
     };
     std::vector<RunwayCollider> m_runwayColliders;
+    SpatialGrid m_runwayGrid;
+    AirportDatabase m_airports;
+    bool m_airportsLoaded = false;
 
     bool m_compiled = false;
+    bool m_heightsOnly = false;
     bool m_debugMaskView = false;
     bool m_useLandclassMaterials = false;
     AssetStore* m_assets = nullptr;
@@ -218,10 +259,33 @@ private:
     GeoOrigin m_compiledOrigin;
     bool m_compiledOriginValid = false;
     int m_compiledMaskResolution = 0;
+    int m_compiledNormalMapResolution = 0;
     bool m_compiledMaskIsLandclass = false;
     std::unordered_set<std::int64_t> m_compiledTiles;
     int m_compiledTilesLoadedThisFrame = 0;
 
+    // Base tile grids visible to the physics thread, and the tiles it has
+    // asked for since the last updatePhysicsTiles(); both under m_physicsMutex.
+    // m_physicsKeep (render thread only) counts down frames until a tile
+    // physics stopped asking for may be evicted.
+    bool m_physicsThreaded = false;
+    mutable std::mutex m_physicsMutex;
+    std::unordered_map<std::int64_t, PhysicsGrid> m_physicsGrids;
+    mutable std::unordered_set<std::int64_t> m_physicsRequests;
+    std::unordered_map<std::int64_t, int> m_physicsKeep;
+
+    // Far-field pyramid from the manifest's lodLevels; entry i is level i + 1.
+    // Coarse tile coordinates count from the pyramid origin in base tiles.
+    struct CompiledLodLevel {
+        float tileSizeMeters = 0.0f;
+        std::string path;
+        std::unordered_set<std::int64_t> tiles;
+    };
+    std::vector<CompiledLodLevel> m_compiledLodLevels;
+    int m_compiledLodOriginX = 0;
+    int m_compiledLodOriginY = 0;
+    int m_compiledLodRadius = 2;
+
     bool m_treesEnabled = false;
     float m_treesDensityPerSqKm = 80.0f;
     float m_treesMinHeight = 4.0f;
@@ -1,7 +1,6 @@
 #include "graphics/texture_array.hpp"
+#include "utils/raster_kernels.hpp"
 #include "utils/stb_image.h"
-#include <algorithm>
-#include <cmath>
 #include <iostream>
 
 namespace nuage {
@@ -10,34 +9,7 @@ namespace {
 std::vector<unsigned char> resampleRGBA(const unsigned char* src, int srcW, int srcH,
                                         int dstW, int dstH) {
     std::vector<unsigned char> out(static_cast<size_t>(dstW * dstH * 4));
-    for (int y = 0; y < dstH; ++y) {
-        float v = (dstH > 1) ? static_cast<float>(y) / (dstH - 1) : 0.0f;
-        float srcY = v * (srcH - 1);
-        int y0 = static_cast<int>(std::floor(srcY));
-        int y1 = std::min(y0 + 1, srcH - 1);
-        float fy = srcY - static_cast<float>(y0);
-        for (int x = 0; x < dstW; ++x) {
-            float u = (dstW > 1) ? static_cast<float>(x) / (dstW - 1) : 0.0f;
-            float srcX = u * (srcW - 1);
-            int x0 = static_cast<int>(std::floor(srcX));
-            int x1 = std::min(x0 + 1, srcW - 1);
-            float fx = srcX - static_cast<float>(x0);
-            for (int c = 0; c < 4; ++c) {
-                int idx00 = (y0 * srcW + x0) * 4 + c;
-                int idx10 = (y0 * srcW + x1) * 4 + c;
-                int idx01 = (y1 * srcW + x0) * 4 + c;
-                int idx11 = (y1 * srcW + x1) * 4 + c;
-                float v00 = static_cast<float>(src[idx00]);
-                float v10 = static_cast<float>(src[idx10]);
-                float v01 = static_cast<float>(src[idx01]);
-                float v11 = static_cast<float>(src[idx11]);
-                float v0 = v00 + (v10 - v00) * fx;
-                float v1 = v01 + (v11 - v01) * fx;
-                float vFinal = v0 + (v1 - v0) * fy;
-                out[static_cast<size_t>(y * dstW + x) * 4 + c] = static_cast<unsigned char>(vFinal);
-            }
-        }
-    }
+    resampleBilinearRGBA8(src, srcW, srcH, out.data(), dstW, dstH);
     return out;
 }
 
@@ -95,7 +95,7 @@ void Input::mapToControls(double dt) {
     }
 
     if (isKeyPressed(GLFW_KEY_TAB)) {
-        PropertyBus::global().set("sim/commands/toggle-camera", true);
+        PropertyBus::global().trigger(Properties::Sim::TOGGLE_CAMERA);
     }
 
     if (isButtonPressed("debug_menu")) {
@@ -12,7 +12,7 @@ void HudOverlay::draw(UIManager& ui, Aircraft& aircraft) {
     Aircraft::Instance* player = aircraft.player();
     if (!player) return;
 
-    const auto& bus = player->state();
+    PropertySnapshot bus = player->state().snapshot();
     float airspeedKts = static_cast<float>(bus.get(Properties::Velocities::AIRSPEED_KT, 0.0));
     float airspeedIasKts = static_cast<float>(bus.get(Properties::Velocities::AIRSPEED_IAS_KT, 0.0));
     float groundSpeedKts = static_cast<float>(bus.get(Properties::Velocities::GROUND_SPEED_KT, 0.0));
@@ -23,6 +23,49 @@ void HudOverlay::draw(UIManager& ui, Aircraft& aircraft) {
     float flapPercent = std::clamp(static_cast<float>(bus.get(Properties::Surfaces::FLAPS_NORM, 0.0)), 0.0f, 1.0f);
     float flapDeg = static_cast<float>(bus.get(Properties::Surfaces::FLAPS_DEG, 0.0));
 
+    std::array<std::uint32_t, kTextSourceCount> versions = {
+        bus.version(Properties::Velocities::AIRSPEED_KT),
+        bus.version(Properties::Velocities::AIRSPEED_IAS_KT),
+        bus.version(Properties::Velocities::GROUND_SPEED_KT),
+        bus.version(Properties::Position::ALTITUDE_FT),
+        bus.version(Properties::Position::ALTITUDE_AGL_FT),
+        bus.version(Properties::Orientation::HEADING_DEG),
+        bus.version(Properties::Controls::THROTTLE),
+        bus.version(Properties::Surfaces::FLAPS_NORM),
+        bus.version(Properties::Surfaces::FLAPS_DEG),
+    };
+    if (m_textSource != &player->state() || versions != m_textVersions) {
+        m_textSource = &player->state();
+        m_textVersions = versions;
+
+        int percentValue = static_cast<int>(std::round(std::clamp(powerPercent, 0.0f, 1.0f) * 100.0f));
+        m_percentText = std::to_string(percentValue) + "%";
+
+        auto formatWithCommas = [](int value) {
+            std::string s = std::to_string(value);
+            int insertPos = static_cast<int>(s.size()) - 3;
+            while (insertPos > 0) {
+                s.insert(static_cast<std::string::size_type>(insertPos), ",");
+                insertPos -= 3;
+            }
+            return s;
+        };
+
+        m_altText = "ALT MSL " + formatWithCommas(static_cast<int>(std::round(altitudeFeet))) + " ft";
+        m_aglText = "ALT AGL " + formatWithCommas(static_cast<int>(std::round(altitudeAglFeet))) + " ft";
+        m_speedText = "TAS " + formatWithCommas(static_cast<int>(std::round(airspeedKts))) + " kts";
+        m_iasGsText = "IAS " + formatWithCommas(static_cast<int>(std::round(airspeedIasKts)))
+            + " kts  GS " + formatWithCommas(static_cast<int>(std::round(groundSpeedKts))) + " kts";
+        int flapDegInt = static_cast<int>(std::round(flapDeg));
+        int flapPercentInt = static_cast<int>(std::round(flapPercent * 100.0f));
+        m_flapText = "Flaps " + std::to_string(flapDegInt) + " deg (" + std::to_string(flapPercentInt) + "%)";
+        int headVal = static_cast<int>(std::round(headingDegrees)) % 360;
+        if (headVal < 0) headVal += 360;
+        char headBuf[32];
+        std::snprintf(headBuf, sizeof(headBuf), "Heading %03d deg", headVal);
+        m_headingText = headBuf;
+    }
+
     // Gauge constants
     constexpr float kHudLeftX = 20.0f;
     constexpr float kCompassSize = 280.0f;
@@ -53,9 +96,7 @@ void HudOverlay::draw(UIManager& ui, Aircraft& aircraft) {
                            kGaugeRadius - kInset, kGaugeFill, 0.9f, Anchor::BottomLeft);
     }
 
-    int percentValue = static_cast<int>(std::round(percent * 100.0f));
-    std::string percentText = std::to_string(percentValue) + "%";
-    ui.drawText(percentText, kGaugeX, -(kGaugeY + kGaugeHeight + 8.0f),
+    ui.drawText(m_percentText, kGaugeX, -(kGaugeY + kGaugeHeight + 8.0f),
                 Anchor::BottomLeft, 0.55f, kGaugeSubText, 0.9f);
 
     // Info Box (Alt/Speed)
@@ -64,29 +105,6 @@ void HudOverlay::draw(UIManager& ui, Aircraft& aircraft) {
     const Vec3 kInfoBoxBack = Vec3(0.18f, 0.2f, 0.23f);
     const Vec3 kInfoText = Vec3(0.95f, 0.96f, 0.98f);
 
-    auto formatWithCommas = [](int value) {
-        std::string s = std::to_string(value);
-        int insertPos = static_cast<int>(s.size()) - 3;
-        while (insertPos > 0) {
-            s.insert(static_cast<std::string::size_type>(insertPos), ",");
-            insertPos -= 3;
-        }
-        return s;
-    };
-
-    std::string altText = "ALT MSL " + formatWithCommas(static_cast<int>(std::round(altitudeFeet))) + " ft";
-    std::string aglText = "ALT AGL " + formatWithCommas(static_cast<int>(std::round(altitudeAglFeet))) + " ft";
-    std::string speedText = "TAS " + formatWithCommas(static_cast<int>(std::round(airspeedKts))) + " kts";
-    std::string iasGsText = "IAS " + formatWithCommas(static_cast<int>(std::round(airspeedIasKts)))
-        + " kts  GS " + formatWithCommas(static_cast<int>(std::round(groundSpeedKts))) + " kts";
-    int flapDegInt = static_cast<int>(std::round(flapDeg));
-    int flapPercentInt = static_cast<int>(std::round(flapPercent * 100.0f));
-    std::string flapText = "Flaps " + std::to_string(flapDegInt) + " deg (" + std::to_string(flapPercentInt) + "%)";
-    int headVal = static_cast<int>(std::round(headingDegrees)) % 360;
-    if (headVal < 0) headVal += 360;
-    char headBuf[32];
-    std::snprintf(headBuf, sizeof(headBuf), "Heading %03d deg", headVal);
-
     float infoBoxX = kHudLeftX;
     float infoBoxY = kHudLeftX + kInfoBoxPadding;
     float infoBoxW = kCompassSize;
@@ -102,17 +120,17 @@ void HudOverlay::draw(UIManager& ui, Aircraft& aircraft) {
 
     ui.drawRoundedRect(infoBoxX, infoBoxY, infoBoxW, infoBoxHeight, kInfoBoxRadius,
                        kInfoBoxBack, 0.92f, Anchor::TopLeft);
-    ui.drawText(altText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop,
+    ui.drawText(m_altText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop,
                 Anchor::TopLeft, kInfoTextScale, kInfoText, 0.98f);
-    ui.drawText(aglText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop + kInfoLineGap,
+    ui.drawText(m_aglText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop + kInfoLineGap,
                 Anchor::TopLeft, kInfoTextScale, kInfoText, 0.98f);
-    ui.drawText(speedText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop + kInfoLineGap * 2.0f,
+    ui.drawText(m_speedText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop + kInfoLineGap * 2.0f,
                 Anchor::TopLeft, kInfoTextScale, kInfoText, 0.98f);
-    ui.drawText(iasGsText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop + kInfoLineGap * 3.0f,
+    ui.drawText(m_iasGsText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop + kInfoLineGap * 3.0f,
                 Anchor::TopLeft, kInfoTextScale, kInfoText, 0.98f);
-    ui.drawText(flapText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop + kInfoLineGap * 4.0f,
+    ui.drawText(m_flapText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop + kInfoLineGap * 4.0f,
                 Anchor::TopLeft, kInfoTextScale, kInfoText, 0.98f);
-    ui.drawText(headBuf, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop + kInfoLineGap * 5.0f,
+    ui.drawText(m_headingText, infoBoxX + kInfoTextPadX, infoBoxY + kInfoTextPadTop + kInfoLineGap * 5.0f,
                 Anchor::TopLeft, kInfoTextScale, kInfoText, 0.98f);
 }
 
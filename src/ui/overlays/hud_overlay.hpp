@@ -1,6 +1,9 @@
 #pragma once
 
 #include "ui/ui_manager.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
 
 namespace nuage {
 
@@ -10,6 +13,19 @@ class UIManager;
 class HudOverlay {
 public:
     void draw(UIManager& ui, Aircraft& aircraft);
+
+private:
+    // Text is rebuilt only when a source property's version changes.
+    static constexpr size_t kTextSourceCount = 9;
+    const void* m_textSource = nullptr;
+    std::array<std::uint32_t, kTextSourceCount> m_textVersions{};
+    std::string m_percentText;
+    std::string m_altText;
+    std::string m_aglText;
+    std::string m_speedText;
+    std::string m_iasGsText;
+    std::string m_flapText;
+    std::string m_headingText;
 };
 
 }
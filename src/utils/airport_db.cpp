@@ -0,0 +1,416 @@
+#include "utils/airport_db.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+
+namespace nuage {
+
+namespace {
+constexpr char kMagic[4] = {'N', 'A', 'P', '1'};
+constexpr std::uint32_t kVersion = 1;
+constexpr float kFtToM = 0.3048f;
+// Caps a grid axis so a database spread over a huge area still stays small;
+// cells grow instead.
+constexpr std::uint32_t kMaxGridCells = 1024;
+
+static_assert(std::is_trivially_copyable_v<AirportRecord> && sizeof(AirportRecord) == 56,
+              "airport records are written as raw bytes");
+static_assert(std::is_trivially_copyable_v<RunwayRecord> && sizeof(RunwayRecord) == 52,
+              "runway records are written as raw bytes");
+
+template<typename T>
+void writePod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+void writeArray(std::ostream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+// Bounds-checked cursor over the loaded file.
+class ByteReader {
+public:
+    explicit ByteReader(const std::string& data) : m_data(data) {}
+
+    template<typename T>
+    bool read(T& out) {
+        return readBytes(&out, sizeof(T));
+    }
+
+    template<typename T>
+    bool readArray(std::vector<T>& out, size_t count) {
+        if (count > (m_data.size() - m_offset) / sizeof(T)) {
+            return false;
+        }
+        out.resize(count);
+        return readBytes(out.data(), count * sizeof(T));
+    }
+
+    bool readString(std::string& out, size_t size) {
+        if (size > m_data.size() - m_offset) {
+            return false;
+        }
+        out.assign(m_data, m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+private:
+    bool readBytes(void* out, size_t size) {
+        if (size > m_data.size() - m_offset) {
+            return false;
+        }
+        if (size > 0) {
+            std::memcpy(out, m_data.data() + m_offset, size);
+        }
+        m_offset += size;
+        return true;
+    }
+
+    const std::string& m_data;
+    size_t m_offset = 0;
+};
+
+void writeGrid(std::ostream& out, const SpatialGrid& grid) {
+    writePod(out, grid.minX);
+    writePod(out, grid.minZ);
+    writePod(out, grid.cellSize);
+    writePod(out, grid.cols);
+    writePod(out, grid.rows);
+    writePod(out, static_cast<std::uint32_t>(grid.items.size()));
+    writeArray(out, grid.cellStart);
+    writeArray(out, grid.items);
+}
+
+bool readGrid(ByteReader& in, SpatialGrid& grid, size_t itemLimit) {
+    std::uint32_t itemCount = 0;
+    if (!in.read(grid.minX) || !in.read(grid.minZ) || !in.read(grid.cellSize) ||
+        !in.read(grid.cols) || !in.read(grid.rows) || !in.read(itemCount)) {
+        return false;
+    }
+    if (grid.cols > kMaxGridCells || grid.rows > kMaxGridCells || !(grid.cellSize > 0.0f)) {
+        return false;
+    }
+    size_t cells = static_cast<size_t>(grid.cols) * grid.rows;
+    if (!in.readArray(grid.cellStart, cells > 0 ? cells + 1 : 0) || !in.readArray(grid.items, itemCount)) {
+        return false;
+    }
+    if (cells == 0) {
+        return itemCount == 0;
+    }
+    if (grid.cellStart.front() != 0 || grid.cellStart.back() != itemCount ||
+        !std::is_sorted(grid.cellStart.begin(), grid.cellStart.end())) {
+        return false;
+    }
+    return std::all_of(grid.items.begin(), grid.items.end(),
+                       [&](std::uint32_t item) { return item < itemLimit; });
+}
+
+SpatialGrid::Bounds runwayBounds(const RunwayRecord& runway) {
+    float halfWidth = runway.widthFt * kFtToM * 0.5f;
+    SpatialGrid::Bounds bounds;
+    bounds.minX = std::min(runway.le[0], runway.he[0]) - halfWidth;
+    bounds.maxX = std::max(runway.le[0], runway.he[0]) + halfWidth;
+    bounds.minZ = std::min(runway.le[2], runway.he[2]) - halfWidth;
+    bounds.maxZ = std::max(runway.le[2], runway.he[2]) + halfWidth;
+    return bounds;
+}
+} // namespace
+
+AirportType parseAirportType(std::string_view type) {
+    if (type == "small_airport") return AirportType::SmallAirport;
+    if (type == "medium_airport") return AirportType::MediumAirport;
+    if (type == "large_airport") return AirportType::LargeAirport;
+    if (type == "seaplane_base") return AirportType::SeaplaneBase;
+    if (type == "balloonport") return AirportType::Balloonport;
+    if (type == "heliport") return AirportType::Heliport;
+    if (type == "closed") return AirportType::Closed;
+    return AirportType::Unknown;
+}
+
+const char* airportTypeName(AirportType type) {
+    switch (type) {
+        case AirportType::SmallAirport: return "small_airport";
+        case AirportType::MediumAirport: return "medium_airport";
+        case AirportType::LargeAirport: return "large_airport";
+        case AirportType::SeaplaneBase: return "seaplane_base";
+        case AirportType::Balloonport: return "balloonport";
+        case AirportType::Heliport: return "heliport";
+        case AirportType::Closed: return "closed";
+        default: return "";
+    }
+}
+
+int SpatialGrid::cellCoord(float v, float origin, std::uint32_t count) const {
+    float cell = std::floor((v - origin) / cellSize);
+    if (!(cell > 0.0f)) {
+        return 0;
+    }
+    return static_cast<int>(std::min(cell, static_cast<float>(count - 1)));
+}
+
+void SpatialGrid::build(const std::vector<Bounds>& bounds, float requestedCellSize) {
+    cellStart.clear();
+    items.clear();
+    cols = 0;
+    rows = 0;
+    if (bounds.empty()) {
+        return;
+    }
+
+    float maxX = bounds.front().maxX;
+    float maxZ = bounds.front().maxZ;
+    minX = bounds.front().minX;
+    minZ = bounds.front().minZ;
+    for (const auto& b : bounds) {
+        minX = std::min(minX, b.minX);
+        minZ = std::min(minZ, b.minZ);
+        maxX = std::max(maxX, b.maxX);
+        maxZ = std::max(maxZ, b.maxZ);
+    }
+    float extent = std::max(maxX - minX, maxZ - minZ);
+    cellSize = std::max({requestedCellSize, extent / static_cast<float>(kMaxGridCells), 1.0f});
+    cols = static_cast<std::uint32_t>(std::floor((maxX - minX) / cellSize)) + 1;
+    rows = static_cast<std::uint32_t>(std::floor((maxZ - minZ) / cellSize)) + 1;
+    cols = std::min(cols, kMaxGridCells);
+    rows = std::min(rows, kMaxGridCells);
+
+    // Counting sort: count items per cell, prefix-sum, then fill in item order.
+    size_t cells = static_cast<size_t>(cols) * rows;
+    cellStart.assign(cells + 1, 0);
+    auto forCells = [&](const Bounds& b, auto&& fn) {
+        int c0 = cellCoord(b.minX, minX, cols);
+        int c1 = cellCoord(b.maxX, minX, cols);
+        int r0 = cellCoord(b.minZ, minZ, rows);
+        int r1 = cellCoord(b.maxZ, minZ, rows);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                fn(static_cast<size_t>(r) * cols + static_cast<size_t>(c));
+            }
+        }
+    };
+    for (const auto& b : bounds) {
+        forCells(b, [&](size_t cell) { ++cellStart[cell + 1]; });
+    }
+    for (size_t i = 0; i < cells; ++i) {
+        cellStart[i + 1] += cellStart[i];
+    }
+    items.resize(cellStart[cells]);
+    std::vector<std::uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        forCells(bounds[i], [&](size_t cell) { items[cursor[cell]++] = static_cast<std::uint32_t>(i); });
+    }
+}
+
+void AirportDatabase::setOrigin(double latDeg, double lonDeg, double altMeters) {
+    m_origin[0] = latDeg;
+    m_origin[1] = lonDeg;
+    m_origin[2] = altMeters;
+}
+
+std::uint32_t AirportDatabase::addString(std::string_view value) {
+    if (m_strings.empty()) {
+        m_strings.push_back('\0'); // offset 0 is the empty string
+    }
+    if (value.empty()) {
+        return 0;
+    }
+    std::string key(value);
+    auto it = m_stringOffsets.find(key);
+    if (it != m_stringOffsets.end()) {
+        return it->second;
+    }
+    auto offset = static_cast<std::uint32_t>(m_strings.size());
+    m_strings.append(value);
+    m_strings.push_back('\0');
+    m_stringOffsets.emplace(std::move(key), offset);
+    return offset;
+}
+
+std::uint32_t AirportDatabase::addAirport(const AirportRecord& airport) {
+    m_airports.push_back(airport);
+    return static_cast<std::uint32_t>(m_airports.size() - 1);
+}
+
+void AirportDatabase::addRunway(const RunwayRecord& runway) {
+    m_runways.push_back(runway);
+}
+
+void AirportDatabase::finalize(float cellSizeMeters) {
+    if (m_strings.empty()) {
+        m_strings.push_back('\0');
+    }
+    std::stable_sort(m_runways.begin(), m_runways.end(),
+                     [](const RunwayRecord& a, const RunwayRecord& b) { return a.airport < b.airport; });
+    for (auto& airport : m_airports) {
+        airport.firstRunway = 0;
+        airport.runwayCount = 0;
+        airport.longestRunwayFt = 0.0f;
+    }
+    for (size_t i = 0; i < m_runways.size(); ++i) {
+        auto& airport = m_airports[m_runways[i].airport];
+        if (airport.runwayCount == 0) {
+            airport.firstRunway = static_cast<std::uint32_t>(i);
+        }
+        airport.runwayCount += 1;
+        airport.longestRunwayFt = std::max(airport.longestRunwayFt, m_runways[i].lengthFt);
+    }
+
+    std::vector<SpatialGrid::Bounds> bounds;
+    bounds.reserve(m_airports.size());
+    for (const auto& airport : m_airports) {
+        bounds.push_back({airport.position[0], airport.position[2], airport.position[0], airport.position[2]});
+    }
+    m_airportGrid.build(bounds, cellSizeMeters);
+    bounds.clear();
+    for (const auto& runway : m_runways) {
+        bounds.push_back(runwayBounds(runway));
+    }
+    m_runwayGrid.build(bounds, cellSizeMeters);
+}
+
+bool AirportDatabase::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(kMagic, 4);
+    writePod(out, kVersion);
+    writePod(out, m_origin);
+    writePod(out, static_cast<std::uint32_t>(m_airports.size()));
+    writePod(out, static_cast<std::uint32_t>(m_runways.size()));
+    writePod(out, static_cast<std::uint32_t>(m_strings.size()));
+    writeArray(out, m_airports);
+    writeArray(out, m_runways);
+    out.write(m_strings.data(), static_cast<std::streamsize>(m_strings.size()));
+    writeGrid(out, m_airportGrid);
+    writeGrid(out, m_runwayGrid);
+    return static_cast<bool>(out);
+}
+
+bool AirportDatabase::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "[airports] failed to open " << path << "\n";
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    *this = AirportDatabase();
+    ByteReader reader(data);
+    char magic[4] = {};
+    std::uint32_t version = 0;
+    std::uint32_t airportCount = 0;
+    std::uint32_t runwayCount = 0;
+    std::uint32_t stringBytes = 0;
+    bool ok = reader.read(magic) && std::memcmp(magic, kMagic, 4) == 0 &&
+              reader.read(version) && version == kVersion &&
+              reader.read(m_origin) && reader.read(airportCount) && reader.read(runwayCount) &&
+              reader.read(stringBytes) && stringBytes > 0 &&
+              reader.readArray(m_airports, airportCount) && reader.readArray(m_runways, runwayCount) &&
+              reader.readString(m_strings, stringBytes) && m_strings.back() == '\0' &&
+              readGrid(reader, m_airportGrid, airportCount) && readGrid(reader, m_runwayGrid, runwayCount);
+    for (size_t i = 0; ok && i < m_airports.size(); ++i) {
+        const auto& airport = m_airports[i];
+        ok = airport.ident < stringBytes && airport.name < stringBytes &&
+             airport.firstRunway <= runwayCount && airport.runwayCount <= runwayCount - airport.firstRunway;
+    }
+    for (size_t i = 0; ok && i < m_runways.size(); ++i) {
+        const auto& runway = m_runways[i];
+        ok = runway.airport < airportCount && runway.leIdent < stringBytes &&
+             runway.heIdent < stringBytes && runway.surface < stringBytes;
+    }
+    if (!ok) {
+        std::cerr << "[airports] malformed airport database: " << path << "\n";
+        *this = AirportDatabase();
+        return false;
+    }
+    return true;
+}
+
+std::string_view AirportDatabase::string(std::uint32_t offset) const {
+    if (offset >= m_strings.size()) {
+        return {};
+    }
+    return std::string_view(m_strings.c_str() + offset);
+}
+
+int AirportDatabase::findAirport(std::string_view ident) const {
+    for (size_t i = 0; i < m_airports.size(); ++i) {
+        if (string(m_airports[i].ident) == ident) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int AirportDatabase::nearestAirport(float x, float z, bool withRunways, float maxDistance) const {
+    const SpatialGrid& grid = m_airportGrid;
+    if (grid.empty()) {
+        return -1;
+    }
+    auto hasOpenRunway = [&](const AirportRecord& airport) {
+        for (std::uint32_t i = 0; i < airport.runwayCount; ++i) {
+            if (!(m_runways[airport.firstRunway + i].flags & RunwayClosed)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Search rings of cells outwards; cells in ring r are at least (r - 1)
+    // cells away, so stop once the best hit is closer than that.
+    long cx = static_cast<long>(std::floor((x - grid.minX) / grid.cellSize));
+    long cz = static_cast<long>(std::floor((z - grid.minZ) / grid.cellSize));
+    long cols = static_cast<long>(grid.cols);
+    long rows = static_cast<long>(grid.rows);
+    long lastRing = std::max({std::abs(cx), std::abs(cx - cols + 1), std::abs(cz), std::abs(cz - rows + 1)});
+    double bestD2 = static_cast<double>(maxDistance) * maxDistance;
+    int best = -1;
+    auto visit = [&](long c, long r) {
+        if (c < 0 || c >= cols || r < 0 || r >= rows) {
+            return;
+        }
+        size_t cell = static_cast<size_t>(r * cols + c);
+        for (std::uint32_t i = grid.cellStart[cell]; i < grid.cellStart[cell + 1]; ++i) {
+            std::uint32_t index = grid.items[i];
+            const auto& airport = m_airports[index];
+            double dx = static_cast<double>(airport.position[0]) - x;
+            double dz = static_cast<double>(airport.position[2]) - z;
+            double d2 = dx * dx + dz * dz;
+            if (d2 < bestD2 || (d2 == bestD2 && best >= 0 && static_cast<int>(index) < best)) {
+                if (withRunways && !hasOpenRunway(airport)) {
+                    continue;
+                }
+                bestD2 = d2;
+                best = static_cast<int>(index);
+            }
+        }
+    };
+    // Rings that miss the grid entirely are skipped.
+    long firstRing = std::max({0L, -cx, cx - cols + 1, -cz, cz - rows + 1});
+    for (long ring = firstRing; ring <= lastRing; ++ring) {
+        double reach = static_cast<double>(ring - 1) * grid.cellSize;
+        if (ring > 0 && reach * reach >= bestD2) {
+            break;
+        }
+        for (long r = std::max(cz - ring, 0L); r <= std::min(cz + ring, rows - 1); ++r) {
+            if (r == cz - ring || r == cz + ring) {
+                for (long c = std::max(cx - ring, 0L); c <= std::min(cx + ring, cols - 1); ++c) {
+                    visit(c, r);
+                }
+            } else {
+                visit(cx - ring, r);
+                visit(cx + ring, r);
+            }
+        }
+    }
+    return best;
+}
+
+} // namespace nuage
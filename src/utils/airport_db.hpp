@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace nuage {
+
+// ---------------------------------------------------------------------------
+// Binary airport/runway database written by ourairports_import and loaded by
+// the simulator. Records are fixed-size and stored back to back, strings live
+// in one NUL-separated table, and airports and runways each have a uniform
+// ENU grid so lookups around a point only touch nearby records.
+
+enum class AirportType : std::uint32_t {
+    Unknown = 0,
+    SmallAirport,
+    MediumAirport,
+    LargeAirport,
+    SeaplaneBase,
+    Balloonport,
+    Heliport,
+    Closed,
+};
+
+AirportType parseAirportType(std::string_view type);
+const char* airportTypeName(AirportType type);
+
+struct AirportRecord {
+    double latDeg = 0.0;
+    double lonDeg = 0.0;
+    float position[3] = {0.0f, 0.0f, 0.0f}; // ENU relative to the database origin
+    float elevationFt = 0.0f;
+    std::uint32_t ident = 0;                // string table offsets
+    std::uint32_t name = 0;
+    std::uint32_t firstRunway = 0;          // runways are grouped by airport
+    std::uint32_t runwayCount = 0;
+    AirportType type = AirportType::Unknown;
+    float longestRunwayFt = 0.0f;
+};
+
+enum RunwayFlags : std::uint32_t {
+    RunwayLighted = 0x1,
+    RunwayClosed = 0x2,
+};
+
+struct RunwayRecord {
+    float le[3] = {0.0f, 0.0f, 0.0f};       // ENU of the low and high ends
+    float he[3] = {0.0f, 0.0f, 0.0f};
+    float lengthFt = 0.0f;
+    float widthFt = 0.0f;
+    std::uint32_t airport = 0;
+    std::uint32_t leIdent = 0;
+    std::uint32_t heIdent = 0;
+    std::uint32_t surface = 0;
+    std::uint32_t flags = 0;
+};
+
+// Uniform xz grid over item bounds, stored as per-cell ranges into one item
+// list so it serializes as two flat arrays. An item is listed in every cell
+// its bounds touch, in ascending item order.
+struct SpatialGrid {
+    struct Bounds {
+        float minX = 0.0f;
+        float minZ = 0.0f;
+        float maxX = 0.0f;
+        float maxZ = 0.0f;
+    };
+
+    float minX = 0.0f;
+    float minZ = 0.0f;
+    float cellSize = 1.0f;
+    std::uint32_t cols = 0;
+    std::uint32_t rows = 0;
+    std::vector<std::uint32_t> cellStart; // cols * rows + 1 entries
+    std::vector<std::uint32_t> items;
+
+    void build(const std::vector<Bounds>& bounds, float cellSize);
+    bool empty() const { return items.empty(); }
+
+    // Calls fn(item) for items listed in the cells overlapping the rectangle.
+    // Items spanning several of those cells are reported once per cell.
+    template<typename Fn>
+    void query(float qMinX, float qMinZ, float qMaxX, float qMaxZ, Fn&& fn) const {
+        if (items.empty()) {
+            return;
+        }
+        int c0 = cellCoord(qMinX, minX, cols);
+        int c1 = cellCoord(qMaxX, minX, cols);
+        int r0 = cellCoord(qMinZ, minZ, rows);
+        int r1 = cellCoord(qMaxZ, minZ, rows);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                size_t cell = static_cast<size_t>(r) * cols + static_cast<size_t>(c);
+                for (std::uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                    fn(items[i]);
+                }
+            }
+        }
+    }
+
+    template<typename Fn>
+    void queryPoint(float x, float z, Fn&& fn) const {
+        query(x, z, x, z, fn);
+    }
+
+private:
+    int cellCoord(float v, float origin, std::uint32_t count) const;
+};
+
+class AirportDatabase {
+public:
+    // Building (ourairports_import).
+    void setOrigin(double latDeg, double lonDeg, double altMeters);
+    std::uint32_t addString(std::string_view value);
+    // Returns the new airport's index.
+    std::uint32_t addAirport(const AirportRecord& airport);
+    void addRunway(const RunwayRecord& runway);
+    // Groups runways by airport, fills the per-airport runway ranges and
+    // builds both grids. Call once after everything is added.
+    void finalize(float cellSizeMeters);
+    bool save(const std::string& path) const;
+
+    // Loading (simulator). Returns false and logs on a missing or malformed file.
+    bool load(const std::string& path);
+
+    double originLatDeg() const { return m_origin[0]; }
+    double originLonDeg() const { return m_origin[1]; }
+    double originAltMeters() const { return m_origin[2]; }
+
+    size_t airportCount() const { return m_airports.size(); }
+    size_t runwayCount() const { return m_runways.size(); }
+    const AirportRecord& airport(size_t index) const { return m_airports[index]; }
+    const RunwayRecord& runway(size_t index) const { return m_runways[index]; }
+    const std::vector<RunwayRecord>& runways() const { return m_runways; }
+    std::string_view string(std::uint32_t offset) const;
+
+    // Index of the airport with this ident, or -1.
+    int findAirport(std::string_view ident) const;
+    // Nearest airport to (x, z) within maxDistance, or -1. withRunways skips
+    // airports without an open runway.
+    int nearestAirport(float x, float z, bool withRunways,
+                       float maxDistance = std::numeric_limits<float>::max()) const;
+    // Runways whose footprint may cover (x, z); candidates can repeat.
+    template<typename Fn>
+    void runwaysNear(float x, float z, float radius, Fn&& fn) const {
+        m_runwayGrid.query(x - radius, z - radius, x + radius, z + radius, fn);
+    }
+
+private:
+    double m_origin[3] = {0.0, 0.0, 0.0};
+    std::vector<AirportRecord> m_airports;
+    std::vector<RunwayRecord> m_runways;
+    std::string m_strings;
+    std::unordered_map<std::string, std::uint32_t> m_stringOffsets;
+    SpatialGrid m_airportGrid;
+    SpatialGrid m_runwayGrid;
+};
+
+} // namespace nuage
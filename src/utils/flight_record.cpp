@@ -0,0 +1,195 @@
+#include "utils/flight_record.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nuage {
+
+namespace {
+constexpr char kMagic[4] = {'N', 'F', 'D', 'R'};
+constexpr std::uint32_t kVersion = 1;
+constexpr size_t kInitialDataBytes = 1 << 20;
+
+static_assert(std::is_trivially_copyable_v<FlightRecordHeader> && sizeof(FlightRecordHeader) == 64,
+              "the header is written as raw bytes");
+static_assert(std::is_trivially_copyable_v<FlightRecordColumn> && sizeof(FlightRecordColumn) == 64,
+              "columns are written as raw bytes");
+} // namespace
+
+FlightRecordWriter::~FlightRecordWriter() {
+    close();
+}
+
+bool FlightRecordWriter::open(const std::string& path, const FlightRecordSchema& schema) {
+    close();
+    if (schema.columns.empty()) {
+        std::cerr << "[recorder] no columns to record\n";
+        return false;
+    }
+    for (const std::string& name : schema.columns) {
+        if (name.size() >= sizeof(FlightRecordColumn::name)) {
+            std::cerr << "[recorder] column name too long: " << name << "\n";
+            return false;
+        }
+    }
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0) {
+        std::cerr << "[recorder] failed to create " << path << "\n";
+        return false;
+    }
+
+    FlightRecordHeader header;
+    header.columnCount = static_cast<std::uint32_t>(schema.columns.size());
+    header.rowBytes = static_cast<std::uint32_t>(schema.columns.size() * sizeof(double));
+    header.dataOffset = static_cast<std::uint32_t>(sizeof(FlightRecordHeader) +
+                                                   schema.columns.size() * sizeof(FlightRecordColumn));
+    header.tickSeconds = schema.tickSeconds;
+    header.startUnixSeconds = schema.startUnixSeconds;
+    m_rowBytes = header.rowBytes;
+    m_rowCount = 0;
+
+    if (!mapFile(header.dataOffset + kInitialDataBytes)) {
+        std::cerr << "[recorder] failed to map " << path << "\n";
+        close();
+        return false;
+    }
+    std::memcpy(m_map, &header, sizeof(header));
+    unsigned char* out = m_map + sizeof(header);
+    for (const std::string& name : schema.columns) {
+        FlightRecordColumn column;
+        std::memcpy(column.name, name.data(), name.size());
+        std::memcpy(out, &column, sizeof(column));
+        out += sizeof(column);
+    }
+    m_used = header.dataOffset;
+    return true;
+}
+
+bool FlightRecordWriter::mapFile(size_t size) {
+    if (m_map) {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+    }
+    if (ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+        return false;
+    }
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    m_map = static_cast<unsigned char*>(mapped);
+    m_mapSize = size;
+    return true;
+}
+
+bool FlightRecordWriter::append(const double* rows, size_t rowCount) {
+    if (!m_map) {
+        return false;
+    }
+    size_t bytes = rowCount * m_rowBytes;
+    if (m_used + bytes > m_mapSize) {
+        size_t size = m_mapSize;
+        while (m_used + bytes > size) {
+            size *= 2;
+        }
+        if (!mapFile(size)) {
+            std::cerr << "[recorder] failed to grow recording to " << size << " bytes\n";
+            close();
+            return false;
+        }
+    }
+    if (bytes > 0) {
+        std::memcpy(m_map + m_used, rows, bytes);
+    }
+    m_used += bytes;
+    m_rowCount += rowCount;
+    std::memcpy(m_map + offsetof(FlightRecordHeader, rowCount), &m_rowCount, sizeof(m_rowCount));
+    return true;
+}
+
+bool FlightRecordWriter::close() {
+    if (m_fd < 0) {
+        return false;
+    }
+    bool ok = m_map != nullptr;
+    if (m_map) {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+        ok = ftruncate(m_fd, static_cast<off_t>(m_used)) == 0;
+    }
+    ::close(m_fd);
+    m_fd = -1;
+    m_used = 0;
+    return ok;
+}
+
+FlightRecordReader::~FlightRecordReader() {
+    if (m_data) {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+}
+
+bool FlightRecordReader::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "[recorder] failed to open " << path << "\n";
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FlightRecordHeader)) {
+        ::close(fd);
+        std::cerr << "[recorder] malformed recording " << path << "\n";
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "[recorder] failed to map " << path << "\n";
+        return false;
+    }
+    m_data = static_cast<const unsigned char*>(mapped);
+    m_size = size;
+
+    std::memcpy(&m_header, m_data, sizeof(m_header));
+    size_t tableEnd = sizeof(FlightRecordHeader) + size_t(m_header.columnCount) * sizeof(FlightRecordColumn);
+    bool ok = std::memcmp(m_header.magic, kMagic, 4) == 0 && m_header.version == kVersion &&
+              m_header.columnCount > 0 &&
+              m_header.rowBytes == m_header.columnCount * sizeof(double) &&
+              m_header.dataOffset >= tableEnd && m_header.dataOffset <= size &&
+              m_header.dataOffset % alignof(double) == 0;
+    if (!ok) {
+        std::cerr << "[recorder] malformed recording " << path << "\n";
+        return false;
+    }
+
+    m_columns.clear();
+    for (std::uint32_t i = 0; i < m_header.columnCount; ++i) {
+        FlightRecordColumn column;
+        std::memcpy(&column, m_data + sizeof(FlightRecordHeader) + i * sizeof(FlightRecordColumn), sizeof(column));
+        if (column.type != FlightRecordColumnType::Float64) {
+            std::cerr << "[recorder] unsupported column type in " << path << "\n";
+            return false;
+        }
+        m_columns.emplace_back(column.name, strnlen(column.name, sizeof(column.name)));
+    }
+
+    std::uint64_t complete = (size - m_header.dataOffset) / m_header.rowBytes;
+    m_rowCount = std::min(m_header.rowCount, complete);
+    return true;
+}
+
+const double* FlightRecordReader::row(std::uint64_t index) const {
+    return reinterpret_cast<const double*>(m_data + m_header.dataOffset + index * m_header.rowBytes);
+}
+
+} // namespace nuage
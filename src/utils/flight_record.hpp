@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nuage {
+
+// ---------------------------------------------------------------------------
+// Binary flight data recording written by the flight recorder and read by
+// flight_record_convert. A fixed header and a column table describe the
+// schema; rows of float64 values follow back to back, one per physics tick.
+// rowCount is updated after every append, so a recording cut short by a
+// crash still reads back up to the last batch the writer flushed.
+
+enum class FlightRecordColumnType : std::uint32_t {
+    Float64 = 1,
+};
+
+struct FlightRecordHeader {
+    char magic[4] = {'N', 'F', 'D', 'R'};
+    std::uint32_t version = 1;
+    std::uint32_t dataOffset = 0;  // bytes from the file start to the first row
+    std::uint32_t columnCount = 0;
+    std::uint32_t rowBytes = 0;
+    std::uint32_t reserved = 0;
+    double tickSeconds = 0.0;
+    std::uint64_t rowCount = 0;
+    std::int64_t startUnixSeconds = 0;
+    std::uint8_t padding[16] = {};
+};
+
+struct FlightRecordColumn {
+    char name[56] = {};  // NUL terminated; longer names are rejected, not cut
+    FlightRecordColumnType type = FlightRecordColumnType::Float64;
+    std::uint32_t reserved = 0;
+};
+
+struct FlightRecordSchema {
+    std::vector<std::string> columns;  // names; every column is float64
+    double tickSeconds = 0.0;
+    std::int64_t startUnixSeconds = 0;
+};
+
+// Appends rows to a memory-mapped file that grows by doubling. Single
+// threaded; the recorder drives it from its writer thread.
+class FlightRecordWriter {
+public:
+    FlightRecordWriter() = default;
+    ~FlightRecordWriter();
+    FlightRecordWriter(const FlightRecordWriter&) = delete;
+    FlightRecordWriter& operator=(const FlightRecordWriter&) = delete;
+
+    bool open(const std::string& path, const FlightRecordSchema& schema);
+    bool append(const double* rows, size_t rowCount);
+    // Trims the file to its contents.
+    bool close();
+    bool isOpen() const { return m_fd >= 0; }
+    std::uint64_t rowCount() const { return m_rowCount; }
+
+private:
+    bool mapFile(size_t size);
+
+    int m_fd = -1;
+    unsigned char* m_map = nullptr;
+    size_t m_mapSize = 0;
+    size_t m_used = 0;
+    size_t m_rowBytes = 0;
+    std::uint64_t m_rowCount = 0;
+};
+
+// Read-only view of a recording. Returns false and logs on a missing or
+// malformed file.
+class FlightRecordReader {
+public:
+    FlightRecordReader() = default;
+    ~FlightRecordReader();
+    FlightRecordReader(const FlightRecordReader&) = delete;
+    FlightRecordReader& operator=(const FlightRecordReader&) = delete;
+
+    bool open(const std::string& path);
+
+    const FlightRecordHeader& header() const { return m_header; }
+    size_t columnCount() const { return m_columns.size(); }
+    const std::string& columnName(size_t column) const { return m_columns[column]; }
+    std::uint64_t rowCount() const { return m_rowCount; }
+    const double* row(std::uint64_t index) const;
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+    FlightRecordHeader m_header;
+    std::vector<std::string> m_columns;
+    std::uint64_t m_rowCount = 0;
+};
+
+} // namespace nuage
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nuage {
+
+// Hot raster loops shared by terrainc and the runtime. Each kernel has a
+// scalar version plus SSE4.1 and AVX2 versions picked at runtime from the
+// CPU; every version performs the same float operations in the same order,
+// so results are bit-identical whichever one runs. AVX2 is not a win
+// everywhere: resampleBilinearRGBA8 stays on SSE4.1 and short
+// bilinearBlendRow calls drop back to it, per raster_kernels_bench.
+enum class SimdLevel {
+    Scalar = 0,
+    Sse41 = 1,
+    Avx2 = 2,
+};
+
+// Best level this CPU supports (always Scalar off x86).
+SimdLevel detectSimdLevel();
+// Level the kernels currently dispatch to; starts at detectSimdLevel().
+SimdLevel activeSimdLevel();
+// Forces a level, clamped to what the CPU supports. Meant for benchmarks.
+void setSimdLevel(SimdLevel level);
+const char* simdLevelName(SimdLevel level);
+
+// One pass of mask smoothing: a texel becomes class c (1..4) when at least
+// five of its 3x3 neighbours (edges clamped) are c, otherwise it keeps its
+// class. src and dst are res x res and must not overlap.
+void majorityFilter3x3(const std::uint8_t* src, std::uint8_t* dst, int res);
+
+// Bilinear resample of an RGBA8 image with corners aligned; channels are
+// truncated back to bytes.
+void resampleBilinearRGBA8(const std::uint8_t* src, int srcW, int srcH,
+                           std::uint8_t* dst, int dstW, int dstH);
+
+// out[i] = lerp(lerp(c00, c10, tx), lerp(c01, c11, tx), ty) for a row of
+// samples sharing one ty.
+void bilinearBlendRow(const float* c00, const float* c10, const float* c01, const float* c11,
+                      const float* tx, float ty, float* out, std::size_t count);
+
+// Normals of a resX x resZ grid of packed xyz positions: cross of the z and x
+// central differences (clamped at the edges), or +Y where degenerate.
+void gridNormals(const float* positions, int resX, int resZ, float* normals);
+
+// Writes water/urban/forest weights into floats 6..8 of each vertex by
+// bilinearly weighting the four mask texels around its xz position.
+// classFlags maps a class to bits 0x1 water, 0x2 urban, 0x4 forest; null
+// uses the landuse classes (1 water, 2 urban, 3 forest).
+void maskBlendWeights(float* verts, std::size_t vertexCount, std::size_t stride,
+                      const std::uint8_t* mask, int maskRes, float tileSize,
+                      float tileMinX, float tileMinZ, const std::uint8_t* classFlags);
+
+} // namespace nuage
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace nuage {
+
+// Bounded lock-free queue from one producer thread to one consumer thread.
+// The capacity is rounded up to a power of two; push() fails rather than
+// blocks when the consumer has fallen that far behind.
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    // Producer side.
+    bool push(const T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) > m_mask) {
+            return false;
+        }
+        m_slots[head & m_mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.
+    bool pop(T& out) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = m_slots[tail & m_mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+} // namespace nuage
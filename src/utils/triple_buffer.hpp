@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace nuage {
+
+// Hands the latest value from one writer thread to one reader thread without
+// locks. The writer fills back() and publish() swaps it with the middle slot;
+// acquire() swaps the middle slot into the front when something new was
+// published since the last call. Neither side ever waits, and the reader
+// skips values that were overwritten before it looked.
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    // Not thread-safe; call before the writer and reader start.
+    void reset(const T& value) {
+        m_slots.fill(value);
+        m_back = 0;
+        m_middle.store(1, std::memory_order_relaxed);
+        m_front = 2;
+    }
+
+    // Writer side.
+    T& back() { return m_slots[m_back]; }
+    void publish() {
+        std::uint8_t previous = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel);
+        m_back = previous & kIndexMask;
+    }
+
+    // Reader side. The reference stays valid until the next acquire().
+    const T& acquire() {
+        if (m_middle.load(std::memory_order_relaxed) & kFresh) {
+            std::uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = previous & kIndexMask;
+        }
+        return m_slots[m_front];
+    }
+    const T& front() const { return m_slots[m_front]; }
+
+private:
+    static constexpr std::uint8_t kIndexMask = 0x3;
+    static constexpr std::uint8_t kFresh = 0x4;
+
+    std::array<T, 3> m_slots{};
+    std::uint8_t m_back = 0;
+    alignas(64) std::atomic<std::uint8_t> m_middle{1};
+    alignas(64) std::uint8_t m_front = 2;
+};
+
+} // namespace nuage
@@ -0,0 +1,90 @@
+#include "utils/worker_pool.hpp"
+#include <algorithm>
+
+namespace nuage {
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+void WorkerPool::start(int threads) {
+    stop();
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    m_stopping = false;
+    // Workers count batches from zero, so one that starts after run() has
+    // already been called still picks that batch up.
+    m_batch = 0;
+    m_workers.reserve(static_cast<size_t>(threads - 1));
+    for (int i = 1; i < threads; ++i) {
+        m_workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+void WorkerPool::stop() {
+    if (m_workers.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+void WorkerPool::run(size_t count, const std::function<void(size_t)>& job) {
+    if (m_workers.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            job(i);
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_busy = static_cast<int>(m_workers.size());
+        ++m_batch;
+    }
+    m_wake.notify_all();
+    drain();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_job = nullptr;
+}
+
+void WorkerPool::workerLoop() {
+    std::uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [&] { return m_stopping || m_batch != seen; });
+        if (m_stopping) {
+            return;
+        }
+        seen = m_batch;
+        lock.unlock();
+        drain();
+        lock.lock();
+        if (--m_busy == 0) {
+            m_done.notify_one();
+        }
+    }
+}
+
+void WorkerPool::drain() {
+    const auto& job = *m_job;
+    size_t count = m_count;
+    for (size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < count;
+         i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+        job(i);
+    }
+}
+
+} // namespace nuage
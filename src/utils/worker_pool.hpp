@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nuage {
+
+// Persistent threads for running one batch of independent jobs at a time.
+// run() hands out indices from a shared counter, helps with the batch on the
+// calling thread and returns once every job has finished, so it doubles as
+// the barrier after the batch. Jobs must not depend on which thread or in
+// which order they run.
+class WorkerPool {
+public:
+    WorkerPool() = default;
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // threads counts the caller; 0 means one per hardware thread, and 1 runs
+    // every batch inline. Restarts the pool if it is already running.
+    void start(int threads);
+    void stop();
+    int threads() const { return static_cast<int>(m_workers.size()) + 1; }
+
+    // Calls job(i) for every i in [0, count). Call from one thread at a time.
+    void run(size_t count, const std::function<void(size_t)>& job);
+
+private:
+    void workerLoop();
+    void drain();
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    bool m_stopping = false;
+    std::uint64_t m_batch = 0;
+    int m_busy = 0;
+
+    const std::function<void(size_t)>* m_job = nullptr;
+    size_t m_count = 0;
+    std::atomic<size_t> m_next{0};
+};
+
+} // namespace nuage
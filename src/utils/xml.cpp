@@ -2,7 +2,7 @@
 #include <cctype>
 #include <cstring>
 #include <fstream>
-#include <sstream>
+#include <iterator>
 #include <sstream>
 
 namespace nuage {
@@ -190,8 +190,309 @@ std::string stripXmlPrologAndComments(const std::string& content) {
     return out;
 }
 
+bool isNameChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == ':' || c == '.';
+}
+
+std::string_view trimView(std::string_view s) {
+    size_t start = 0;
+    while (start < s.size() && std::isspace(static_cast<unsigned char>(s[start]))) {
+        ++start;
+    }
+    size_t end = s.size();
+    while (end > start && std::isspace(static_cast<unsigned char>(s[end - 1]))) {
+        --end;
+    }
+    return s.substr(start, end - start);
+}
+
+class SaxTokenizer {
+public:
+    SaxTokenizer(std::string_view content, XmlSaxHandler& handler)
+        : m_content(content), m_handler(handler) {}
+
+    bool run() {
+        while (m_pos < m_content.size()) {
+            if (m_content[m_pos] != '<') {
+                size_t end = m_content.find('<', m_pos);
+                if (end == std::string_view::npos) {
+                    end = m_content.size();
+                }
+                std::string_view segment = trimView(m_content.substr(m_pos, end - m_pos));
+                if (!segment.empty() && !m_stack.empty()) {
+                    m_handler.text(segment);
+                }
+                m_pos = end;
+                continue;
+            }
+            if (startsWithView("<?")) {
+                if (!skipPast("?>")) return false;
+            } else if (startsWithView("<!--")) {
+                if (!skipPast("-->")) return false;
+            } else if (startsWithView("<![CDATA[")) {
+                size_t start = m_pos + 9;
+                size_t end = m_content.find("]]>", start);
+                if (end == std::string_view::npos) return false;
+                if (!m_stack.empty() && end > start) {
+                    m_handler.text(m_content.substr(start, end - start));
+                }
+                m_pos = end + 3;
+            } else if (startsWithView("<!")) {
+                if (!skipPast(">")) return false;
+            } else if (startsWithView("</")) {
+                m_pos += 2;
+                std::string_view name = parseName();
+                if (name.empty() || m_stack.empty() || m_stack.back() != name) {
+                    return false;
+                }
+                skipSpace();
+                if (m_pos >= m_content.size() || m_content[m_pos] != '>') {
+                    return false;
+                }
+                ++m_pos;
+                m_stack.pop_back();
+                m_handler.endElement(name);
+                if (m_stack.empty()) {
+                    return true;
+                }
+            } else {
+                if (!parseStartTag()) return false;
+                if (m_stack.empty()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    bool startsWithView(std::string_view token) const {
+        return m_content.compare(m_pos, token.size(), token) == 0;
+    }
+
+    bool skipPast(std::string_view token) {
+        size_t end = m_content.find(token, m_pos);
+        if (end == std::string_view::npos) {
+            return false;
+        }
+        m_pos = end + token.size();
+        return true;
+    }
+
+    void skipSpace() {
+        while (m_pos < m_content.size() && std::isspace(static_cast<unsigned char>(m_content[m_pos]))) {
+            ++m_pos;
+        }
+    }
+
+    std::string_view parseName() {
+        skipSpace();
+        size_t start = m_pos;
+        while (m_pos < m_content.size() && isNameChar(m_content[m_pos])) {
+            ++m_pos;
+        }
+        return m_content.substr(start, m_pos - start);
+    }
+
+    bool parseStartTag() {
+        ++m_pos;
+        std::string_view name = parseName();
+        if (name.empty()) {
+            return false;
+        }
+        m_attributes.clear();
+        for (;;) {
+            skipSpace();
+            if (m_pos >= m_content.size()) {
+                return false;
+            }
+            char c = m_content[m_pos];
+            if (c == '/' || c == '>') {
+                break;
+            }
+            std::string_view attrName = parseName();
+            if (attrName.empty()) {
+                return false;
+            }
+            skipSpace();
+            if (m_pos >= m_content.size() || m_content[m_pos] != '=') {
+                return false;
+            }
+            ++m_pos;
+            skipSpace();
+            if (m_pos >= m_content.size()) {
+                return false;
+            }
+            char quote = m_content[m_pos];
+            if (quote != '"' && quote != '\'') {
+                return false;
+            }
+            size_t start = m_pos + 1;
+            size_t end = m_content.find(quote, start);
+            if (end == std::string_view::npos) {
+                return false;
+            }
+            m_attributes.push_back({attrName, m_content.substr(start, end - start)});
+            m_pos = end + 1;
+        }
+
+        m_handler.startElement(name, m_attributes.data(), m_attributes.size());
+        if (m_content[m_pos] == '/') {
+            ++m_pos;
+            if (m_pos >= m_content.size() || m_content[m_pos] != '>') {
+                return false;
+            }
+            ++m_pos;
+            m_handler.endElement(name);
+            return true;
+        }
+        ++m_pos;
+        m_stack.push_back(name);
+        return true;
+    }
+
+    std::string_view m_content;
+    XmlSaxHandler& m_handler;
+    size_t m_pos = 0;
+    std::vector<std::string_view> m_stack;
+    std::vector<XmlAttributeView> m_attributes;
+};
+
+bool readFileBytes(const std::string& path, std::vector<char>& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
 } // namespace
 
+class XmlDocumentBuilder : public XmlSaxHandler {
+public:
+    explicit XmlDocumentBuilder(XmlDocument& doc) : m_doc(doc) {}
+
+    void startElement(std::string_view name, const XmlAttributeView* attributes, size_t count) override {
+        XmlDocument::ElementData data;
+        data.name = name;
+        data.firstAttribute = static_cast<std::uint32_t>(m_doc.m_attributes.size());
+        data.attributeCount = static_cast<std::uint32_t>(count);
+        m_doc.m_attributes.insert(m_doc.m_attributes.end(), attributes, attributes + count);
+
+        auto index = static_cast<std::int32_t>(m_doc.m_elements.size());
+        m_doc.m_elements.push_back(data);
+        if (!m_open.empty()) {
+            OpenElement& parent = m_open.back();
+            if (parent.lastChild >= 0) {
+                m_doc.m_elements[static_cast<size_t>(parent.lastChild)].nextSibling = index;
+            } else {
+                m_doc.m_elements[static_cast<size_t>(parent.index)].firstChild = index;
+            }
+            parent.lastChild = index;
+        }
+        m_open.push_back({index, -1});
+    }
+
+    void text(std::string_view text) override {
+        auto& element = m_doc.m_elements[static_cast<size_t>(m_open.back().index)];
+        if (element.text.empty()) {
+            element.text = text;
+            return;
+        }
+        // Only the element being filled can own the newest joined string.
+        auto& joined = m_doc.m_joinedText;
+        if (joined.empty() || element.text.data() != joined.back().data()) {
+            joined.emplace_back(element.text);
+        }
+        joined.back().append(text);
+        element.text = joined.back();
+    }
+
+    void endElement(std::string_view name) override {
+        (void)name;
+        m_open.pop_back();
+    }
+
+private:
+    struct OpenElement {
+        std::int32_t index;
+        std::int32_t lastChild;
+    };
+
+    XmlDocument& m_doc;
+    std::vector<OpenElement> m_open;
+};
+
+bool parseXmlSax(std::string_view content, XmlSaxHandler& handler) {
+    SaxTokenizer tokenizer(content, handler);
+    return tokenizer.run();
+}
+
+bool loadXmlFileSax(const std::string& path, XmlSaxHandler& handler) {
+    std::vector<char> buffer;
+    if (!readFileBytes(path, buffer)) {
+        return false;
+    }
+    return parseXmlSax(std::string_view(buffer.data(), buffer.size()), handler);
+}
+
+bool XmlDocument::parse(std::string_view content) {
+    m_buffer.assign(content.begin(), content.end());
+    return parseBuffer();
+}
+
+bool XmlDocument::load(const std::string& path) {
+    if (!readFileBytes(path, m_buffer)) {
+        m_elements.clear();
+        m_attributes.clear();
+        return false;
+    }
+    return parseBuffer();
+}
+
+bool XmlDocument::parseBuffer() {
+    m_elements.clear();
+    m_attributes.clear();
+    m_joinedText.clear();
+    XmlDocumentBuilder builder(*this);
+    if (!parseXmlSax(std::string_view(m_buffer.data(), m_buffer.size()), builder)) {
+        m_elements.clear();
+        m_attributes.clear();
+        return false;
+    }
+    return !m_elements.empty();
+}
+
+std::string_view XmlElement::name() const {
+    return m_doc->m_elements[static_cast<size_t>(m_index)].name;
+}
+
+std::string_view XmlElement::text() const {
+    return m_doc->m_elements[static_cast<size_t>(m_index)].text;
+}
+
+std::optional<std::string_view> XmlElement::attribute(std::string_view name) const {
+    const auto& data = m_doc->m_elements[static_cast<size_t>(m_index)];
+    for (std::uint32_t i = 0; i < data.attributeCount; ++i) {
+        const auto& attr = m_doc->m_attributes[data.firstAttribute + i];
+        if (attr.name == name) {
+            return attr.value;
+        }
+    }
+    return std::nullopt;
+}
+
+XmlElement XmlElement::firstChild() const {
+    std::int32_t child = m_doc->m_elements[static_cast<size_t>(m_index)].firstChild;
+    return child >= 0 ? XmlElement(m_doc, child) : XmlElement();
+}
+
+XmlElement XmlElement::nextSibling() const {
+    std::int32_t next = m_doc->m_elements[static_cast<size_t>(m_index)].nextSibling;
+    return next >= 0 ? XmlElement(m_doc, next) : XmlElement();
+}
+
 std::optional<XmlNode> parseXml(const std::string& content) {
     std::string cleaned = stripXmlPrologAndComments(content);
     size_t i = 0;
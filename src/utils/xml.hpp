@@ -1,10 +1,13 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <optional>
-#include <optional>
 
 namespace nuage {
 
@@ -18,4 +21,128 @@ struct XmlNode {
 std::optional<XmlNode> parseXml(const std::string& content);
 std::optional<XmlNode> loadXmlFile(const std::string& path);
 
+// ---------------------------------------------------------------------------
+// In-situ parsing. Names, attribute values and text are views into the source
+// buffer; nothing is copied or unescaped. Text is reported per segment with
+// surrounding whitespace trimmed, and empty segments are skipped.
+
+struct XmlAttributeView {
+    std::string_view name;
+    std::string_view value;
+};
+
+class XmlSaxHandler {
+public:
+    virtual ~XmlSaxHandler() = default;
+    virtual void startElement(std::string_view name, const XmlAttributeView* attributes, size_t count) {
+        (void)name; (void)attributes; (void)count;
+    }
+    virtual void text(std::string_view text) { (void)text; }
+    virtual void endElement(std::string_view name) { (void)name; }
+};
+
+// Streams the first root element of content to handler. Returns false on malformed input.
+bool parseXmlSax(std::string_view content, XmlSaxHandler& handler);
+bool loadXmlFileSax(const std::string& path, XmlSaxHandler& handler);
+
+class XmlDocument;
+
+/**
+ * @brief Lightweight handle to an element stored in an XmlDocument arena.
+ * Only valid while the owning document is alive; documents do not move.
+ */
+class XmlElement {
+public:
+    XmlElement() = default;
+
+    bool valid() const { return m_doc != nullptr && m_index >= 0; }
+    explicit operator bool() const { return valid(); }
+
+    std::string_view name() const;
+    // Text directly inside this element, with the trimmed segments around
+    // comments, CDATA and child elements joined in document order.
+    std::string_view text() const;
+    std::optional<std::string_view> attribute(std::string_view name) const;
+
+    XmlElement firstChild() const;
+    XmlElement nextSibling() const;
+
+    class Iterator;
+    struct ChildRange;
+    ChildRange children() const;
+
+private:
+    friend class XmlDocument;
+    XmlElement(const XmlDocument* doc, std::int32_t index) : m_doc(doc), m_index(index) {}
+
+    const XmlDocument* m_doc = nullptr;
+    std::int32_t m_index = -1;
+};
+
+class XmlElement::Iterator {
+public:
+    explicit Iterator(XmlElement element) : m_element(element) {}
+    XmlElement operator*() const { return m_element; }
+    Iterator& operator++() {
+        m_element = m_element.nextSibling();
+        return *this;
+    }
+    bool operator!=(const Iterator& other) const { return m_element.m_index != other.m_element.m_index; }
+
+private:
+    XmlElement m_element;
+};
+
+struct XmlElement::ChildRange {
+    XmlElement first;
+    Iterator begin() const { return Iterator(first); }
+    Iterator end() const { return Iterator(XmlElement()); }
+};
+
+inline XmlElement::ChildRange XmlElement::children() const {
+    return ChildRange{firstChild()};
+}
+
+/**
+ * @brief Arena-backed XML tree that keeps the file buffer alive and stores
+ * elements and attributes in flat arrays.
+ */
+class XmlDocument {
+public:
+    XmlDocument() = default;
+    XmlDocument(const XmlDocument&) = delete;
+    XmlDocument& operator=(const XmlDocument&) = delete;
+    // Elements point back at their document, so it stays where it was built.
+    XmlDocument(XmlDocument&&) = delete;
+    XmlDocument& operator=(XmlDocument&&) = delete;
+
+    bool parse(std::string_view content);
+    bool load(const std::string& path);
+
+    XmlElement root() const { return m_elements.empty() ? XmlElement() : XmlElement(this, 0); }
+    size_t elementCount() const { return m_elements.size(); }
+
+private:
+    friend class XmlElement;
+    friend class XmlDocumentBuilder;
+
+    struct ElementData {
+        std::string_view name;
+        std::string_view text;
+        std::uint32_t firstAttribute = 0;
+        std::uint32_t attributeCount = 0;
+        std::int32_t firstChild = -1;
+        std::int32_t nextSibling = -1;
+    };
+
+    bool parseBuffer();
+
+    std::vector<char> m_buffer;
+    std::vector<ElementData> m_elements;
+    std::vector<XmlAttributeView> m_attributes;
+    // Text of elements split into several segments; a deque so growing it
+    // leaves the strings other elements view in place.
+    std::deque<std::string> m_joinedText;
+};
+
 } // namespace nuage
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <FGFDMExec.h>
+#include <simgear/misc/sg_path.hxx>
+
+#include "core/flight_recorder.hpp"
+#include "core/properties/property_paths.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::unique_ptr<JSBSim::FGFDMExec> loadModel(const std::string& root, const std::string& model, double dt) {
+    auto fdm = std::make_unique<JSBSim::FGFDMExec>();
+    fdm->SetRootDir(SGPath(root));
+    fdm->SetAircraftPath(SGPath("aircraft"));
+    fdm->SetEnginePath(SGPath("engine"));
+    fdm->SetSystemsPath(SGPath("systems"));
+    fdm->Setdt(dt);
+    fdm->SetPropertyValue("ic/h-sl-ft", 3000.0);
+    fdm->SetPropertyValue("ic/u-fps", 180.0);
+    if (!fdm->LoadModel(model)) {
+        return nullptr;
+    }
+    fdm->RunIC();
+    fdm->SetPropertyValue("propulsion/engine[0]/set-running", 1.0);
+    fdm->SetPropertyValue("fcs/mixture-cmd-norm", 1.0);
+    fdm->SetPropertyValue("fcs/throttle-cmd-norm", 0.7);
+    return fdm;
+}
+
+void printUsage() {
+    std::cout << "Usage: flight_record_bench [--root <assets/jsbsim>] [--model <c172p>] [--ticks <n>]\n"
+              << "  Steps the model at 120 Hz and records every tick with the columns in\n"
+              << "  assets/config/recorder.json, timing FlightRecorder::record() against\n"
+              << "  FGFDMExec::Run(). Leaves the recording in the configured directory.\n";
+}
+}
+
+int main(int argc, char** argv) {
+    using namespace nuage;
+
+    std::string root = "assets/jsbsim";
+    std::string model = "c172p";
+    int ticks = 12000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--root" && i + 1 < argc) {
+            root = argv[++i];
+        } else if (arg == "--model" && i + 1 < argc) {
+            model = argv[++i];
+        } else if (arg == "--ticks" && i + 1 < argc) {
+            ticks = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Unknown arg: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    const double dt = 1.0 / 120.0;
+    auto fdm = loadModel(root, model, dt);
+    if (!fdm) {
+        std::cerr << "[flight_record_bench] failed to load " << model << " from " << root << "\n";
+        return 1;
+    }
+
+    FlightRecorder recorder;
+    recorder.init();
+    recorder.setEnabled(true);
+    if (!recorder.start(dt)) {
+        return 1;
+    }
+
+    PropertyBus bus;
+    AircraftState state;
+    double runNs = 0.0;
+    double recordNs = 0.0;
+    for (int tick = 0; tick < ticks; ++tick) {
+        auto start = Clock::now();
+        fdm->Run();
+        auto ran = Clock::now();
+
+        // Roughly what JsbsimSystem publishes, so every channel has a value.
+        state.position.y = static_cast<float>(fdm->GetPropertyValue("position/h-sl-ft") * 0.3048);
+        state.airspeed = fdm->GetPropertyValue("velocities/vtrue-fps") * 0.3048;
+        bus.set(Properties::Controls::THROTTLE, 0.7);
+        bus.set(Properties::Position::ALTITUDE_FT, fdm->GetPropertyValue("position/h-sl-ft"));
+
+        auto recorded = Clock::now();
+        recorder.record(state, bus, PropertyBus::global());
+        auto end = Clock::now();
+        runNs += std::chrono::duration<double, std::nano>(ran - start).count();
+        recordNs += std::chrono::duration<double, std::nano>(end - recorded).count();
+    }
+    recorder.stop();
+
+    double run = runNs / ticks;
+    double record = recordNs / ticks;
+    std::cout << "[flight_record_bench] " << model << ", " << ticks << " ticks\n"
+              << "  Run() " << run << " ns/tick, record() " << record << " ns/tick ("
+              << 100.0 * record / (run + record) << "% of the tick)\n";
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "utils/flight_record.hpp"
+#include "utils/json.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cout << "Usage: flight_record_convert <recording.nfdr> [--csv <out.csv>] [--columns <out_dir>]\n"
+              << "  --csv      one row per tick, one column per recorded value\n"
+              << "  --columns  one little-endian float64 file per column plus schema.json\n";
+}
+
+bool writeCsv(const nuage::FlightRecordReader& reader, const std::string& path) {
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        std::cerr << "Failed to open " << path << "\n";
+        return false;
+    }
+    size_t columns = reader.columnCount();
+    for (size_t c = 0; c < columns; ++c) {
+        std::fprintf(out, c == 0 ? "%s" : ",%s", reader.columnName(c).c_str());
+    }
+    std::fputc('\n', out);
+    for (std::uint64_t r = 0; r < reader.rowCount(); ++r) {
+        const double* row = reader.row(r);
+        for (size_t c = 0; c < columns; ++c) {
+            std::fprintf(out, c == 0 ? "%.10g" : ",%.10g", row[c]);
+        }
+        std::fputc('\n', out);
+    }
+    bool ok = std::ferror(out) == 0;
+    ok = std::fclose(out) == 0 && ok;
+    return ok;
+}
+
+std::string columnFileName(size_t index, const std::string& name) {
+    std::string file = std::to_string(index) + "_";
+    for (char c : name) {
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+        file.push_back(safe ? c : '.');
+    }
+    return file + ".f64";
+}
+
+bool writeColumns(const nuage::FlightRecordReader& reader, const std::string& dir) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        std::cerr << "Failed to create " << dir << "\n";
+        return false;
+    }
+
+    nlohmann::json schema;
+    schema["rows"] = reader.rowCount();
+    schema["tickSeconds"] = reader.header().tickSeconds;
+    schema["startUnixSeconds"] = reader.header().startUnixSeconds;
+    schema["columns"] = nlohmann::json::array();
+
+    // Transpose one column at a time so only a column-sized buffer is needed.
+    std::vector<double> values(static_cast<size_t>(reader.rowCount()));
+    for (size_t c = 0; c < reader.columnCount(); ++c) {
+        for (std::uint64_t r = 0; r < reader.rowCount(); ++r) {
+            values[static_cast<size_t>(r)] = reader.row(r)[c];
+        }
+        std::string file = columnFileName(c, reader.columnName(c));
+        std::ofstream out(std::filesystem::path(dir) / file, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(values.data()),
+                  static_cast<std::streamsize>(values.size() * sizeof(double)));
+        if (!out) {
+            std::cerr << "Failed to write " << file << "\n";
+            return false;
+        }
+        schema["columns"].push_back({{"name", reader.columnName(c)}, {"file", file}, {"type", "float64"}});
+    }
+
+    std::ofstream out(std::filesystem::path(dir) / "schema.json");
+    out << schema.dump(2) << "\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string inputPath;
+    std::string csvPath;
+    std::string columnsDir;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&](std::string& out) -> bool {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        if (arg == "--csv") {
+            if (!next(csvPath)) return 1;
+        } else if (arg == "--columns") {
+            if (!next(columnsDir)) return 1;
+        } else if (inputPath.empty() && arg.rfind("--", 0) != 0) {
+            inputPath = arg;
+        } else {
+            std::cerr << "Unknown arg: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (inputPath.empty() || (csvPath.empty() && columnsDir.empty())) {
+        printUsage();
+        return 1;
+    }
+
+    nuage::FlightRecordReader reader;
+    if (!reader.open(inputPath)) {
+        return 1;
+    }
+    std::cout << inputPath << ": " << reader.rowCount() << " rows, " << reader.columnCount()
+              << " columns at " << reader.header().tickSeconds << " s/tick\n";
+
+    if (!csvPath.empty() && !writeCsv(reader, csvPath)) {
+        return 1;
+    }
+    if (!columnsDir.empty() && !writeColumns(reader, columnsDir)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <FGFDMExec.h>
+#include <input_output/FGPropertyManager.h>
+#include <simgear/misc/sg_path.hxx>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The inputs JsbsimSystem writes and the outputs it reads every tick, as the
+// string paths it used before caching nodes (duplicate "[0]" spellings included).
+const char* const kInputPaths[] = {
+    "propulsion/engine/set-running",
+    "propulsion/engine[0]/set-running",
+    "fcs/mixture-cmd-norm",
+    "fcs/mixture-cmd-norm[0]",
+    "propulsion/engine[0]/mixture-cmd-norm",
+    "fcs/elevator-cmd-norm",
+    "fcs/aileron-cmd-norm",
+    "fcs/rudder-cmd-norm",
+    "fcs/throttle-cmd-norm",
+    "fcs/throttle-cmd-norm[0]",
+    "fcs/flap-cmd-norm",
+    "fcs/roll-trim-cmd-norm",
+    "fcs/left-brake-cmd-norm",
+    "fcs/right-brake-cmd-norm",
+    "fcs/center-brake-cmd-norm",
+    "propulsion/magneto_cmd",
+    "propulsion/starter_cmd",
+    "atmosphere/wind-north-fps",
+    "atmosphere/wind-east-fps",
+    "atmosphere/wind-down-fps",
+};
+
+const char* const kOutputPaths[] = {
+    "propulsion/engine[0]/engine-rpm",
+    "position/lat-geod-rad",
+    "position/long-gc-rad",
+    "position/h-sl-ft",
+    "position/h-agl-ft",
+    "velocities/vtrue-fps",
+    "velocities/vg-fps",
+    "velocities/vc-kts",
+    "velocities/v-down-fps",
+    "attitude/theta-deg",
+    "attitude/phi-deg",
+    "attitude/psi-deg",
+    "fcs/flap-pos-deg",
+    "fcs/flap-pos-norm",
+};
+
+constexpr size_t kInputCount = sizeof(kInputPaths) / sizeof(kInputPaths[0]);
+constexpr size_t kOutputCount = sizeof(kOutputPaths) / sizeof(kOutputPaths[0]);
+
+// Values for one tick: a slowly moving elevator, everything else steady,
+// which is what a pilot holding a cruise attitude produces.
+void tickInputs(int tick, double* values) {
+    for (size_t i = 0; i < kInputCount; ++i) {
+        values[i] = 0.0;
+    }
+    values[0] = values[1] = 1.0;                // set-running
+    values[2] = values[3] = values[4] = 1.0;    // mixture
+    values[5] = 0.05 * std::sin(tick * 0.01);   // elevator
+    values[8] = values[9] = 0.7;                // throttle
+    values[15] = 3.0;                           // magneto
+}
+
+struct Timing {
+    double syncNs = 0.0;
+    double runNs = 0.0;
+    double checksum = 0.0;
+};
+
+std::unique_ptr<JSBSim::FGFDMExec> loadModel(const std::string& root, const std::string& model, double dt) {
+    auto fdm = std::make_unique<JSBSim::FGFDMExec>();
+    fdm->SetRootDir(SGPath(root));
+    fdm->SetAircraftPath(SGPath("aircraft"));
+    fdm->SetEnginePath(SGPath("engine"));
+    fdm->SetSystemsPath(SGPath("systems"));
+    fdm->Setdt(dt);
+    fdm->SetPropertyValue("ic/h-sl-ft", 3000.0);
+    fdm->SetPropertyValue("ic/u-fps", 180.0);
+    if (!fdm->LoadModel(model)) {
+        return nullptr;
+    }
+    fdm->RunIC();
+    return fdm;
+}
+
+Timing runStrings(JSBSim::FGFDMExec& fdm, int ticks) {
+    Timing timing;
+    double values[kInputCount];
+    for (int tick = 0; tick < ticks; ++tick) {
+        tickInputs(tick, values);
+        auto start = Clock::now();
+        for (size_t i = 0; i < kInputCount; ++i) {
+            fdm.SetPropertyValue(kInputPaths[i], values[i]);
+        }
+        auto ran = Clock::now();
+        fdm.Run();
+        auto read = Clock::now();
+        for (size_t i = 0; i < kOutputCount; ++i) {
+            timing.checksum += fdm.GetPropertyValue(kOutputPaths[i]);
+        }
+        auto end = Clock::now();
+        timing.syncNs += std::chrono::duration<double, std::nano>((ran - start) + (end - read)).count();
+        timing.runNs += std::chrono::duration<double, std::nano>(read - ran).count();
+    }
+    return timing;
+}
+
+Timing runNodes(JSBSim::FGFDMExec& fdm, int ticks) {
+    auto properties = fdm.GetPropertyManager();
+    std::vector<SGPropertyNode*> inputs;
+    std::vector<SGPropertyNode*> outputs;
+    for (const char* path : kInputPaths) {
+        inputs.push_back(properties->GetNode(path, true));
+    }
+    for (const char* path : kOutputPaths) {
+        outputs.push_back(properties->GetNode(path, false));
+    }
+
+    Timing timing;
+    double values[kInputCount];
+    for (int tick = 0; tick < ticks; ++tick) {
+        tickInputs(tick, values);
+        auto start = Clock::now();
+        for (size_t i = 0; i < kInputCount; ++i) {
+            if (inputs[i]->getDoubleValue() != values[i]) {
+                inputs[i]->setDoubleValue(values[i]);
+            }
+        }
+        auto ran = Clock::now();
+        fdm.Run();
+        auto read = Clock::now();
+        for (SGPropertyNode* node : outputs) {
+            timing.checksum += node ? node->getDoubleValue() : 0.0;
+        }
+        auto end = Clock::now();
+        timing.syncNs += std::chrono::duration<double, std::nano>((ran - start) + (end - read)).count();
+        timing.runNs += std::chrono::duration<double, std::nano>(read - ran).count();
+    }
+    return timing;
+}
+
+void report(const char* name, const Timing& timing, int ticks) {
+    double sync = timing.syncNs / ticks;
+    double run = timing.runNs / ticks;
+    std::cout << "  " << name << ": sync " << sync << " ns/tick, Run() " << run << " ns/tick ("
+              << 100.0 * sync / (sync + run) << "% of the tick in property access)\n";
+}
+
+void printUsage() {
+    std::cout << "Usage: jsbsim_sync_bench [--root <assets/jsbsim>] [--model <c172p>] [--ticks <n>]\n"
+              << "  Steps the model at 120 Hz, syncing JsbsimSystem's inputs and outputs through\n"
+              << "  string paths and then through cached property nodes, and reports both.\n";
+}
+}
+
+int main(int argc, char** argv) {
+    std::string root = "assets/jsbsim";
+    std::string model = "c172p";
+    int ticks = 12000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--root" && i + 1 < argc) {
+            root = argv[++i];
+        } else if (arg == "--model" && i + 1 < argc) {
+            model = argv[++i];
+        } else if (arg == "--ticks" && i + 1 < argc) {
+            ticks = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Unknown arg: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    const double dt = 1.0 / 120.0;
+    auto strings = loadModel(root, model, dt);
+    auto nodes = loadModel(root, model, dt);
+    if (!strings || !nodes) {
+        std::cerr << "[jsbsim_sync_bench] failed to load " << model << " from " << root << "\n";
+        return 1;
+    }
+
+    std::cout << "[jsbsim_sync_bench] " << model << ", " << ticks << " ticks\n";
+    Timing before = runStrings(*strings, ticks);
+    Timing after = runNodes(*nodes, ticks);
+    report("string paths", before, ticks);
+    report("cached nodes", after, ticks);
+    std::cout << "  sync speedup " << before.syncNs / std::max(after.syncNs, 1.0) << "x\n";
+    // Both runs see the same inputs, so the trajectories should agree.
+    std::cout << "  output checksum " << before.checksum << " vs " << after.checksum << "\n";
+    return 0;
+}
@@ -5,19 +5,22 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
+#include "utils/airport_db.hpp"
 #include "utils/config_loader.hpp"
 #include "utils/json.hpp"
 #include "math/vec3.hpp"
+#include "tools/ourairports_import/csv_reader.hpp"
 
 namespace {
 constexpr double kDegToRad = 3.141592653589793 / 180.0;
 constexpr double kRadToDeg = 180.0 / 3.141592653589793;
 constexpr double kEarthRadiusM = 6378137.0;
 constexpr double kFtToM = 0.3048;
+constexpr float kDbCellMeters = 10000.0f;
 
 struct Origin {
     double latDeg = 0.0;
@@ -33,60 +36,6 @@ struct BoundsLLA {
     bool valid = false;
 };
 
-bool parseCsvLine(std::istream& in, std::vector<std::string>& out) {
-    out.clear();
-    std::string field;
-    bool inQuotes = false;
-    bool hadData = false;
-
-    for (;;) {
-        int ch = in.get();
-        if (ch == EOF) {
-            if (!field.empty() || hadData) {
-                out.push_back(field);
-                return true;
-            }
-            return false;
-        }
-        hadData = true;
-        char c = static_cast<char>(ch);
-        if (inQuotes) {
-            if (c == '"') {
-                if (in.peek() == '"') {
-                    in.get();
-                    field.push_back('"');
-                } else {
-                    inQuotes = false;
-                }
-            } else {
-                field.push_back(c);
-            }
-        } else {
-            if (c == '"') {
-                inQuotes = true;
-            } else if (c == ',') {
-                out.push_back(field);
-                field.clear();
-            } else if (c == '\n') {
-                if (!field.empty() && field.back() == '\r') {
-                    field.pop_back();
-                }
-                out.push_back(field);
-                return true;
-            } else {
-                field.push_back(c);
-            }
-        }
-    }
-}
-
-bool parseDouble(const std::string& s, double& out) {
-    if (s.empty()) return false;
-    char* end = nullptr;
-    out = std::strtod(s.c_str(), &end);
-    return end != s.c_str();
-}
-
 nuage::Vec3 llaToEnu(const Origin& origin, double latDeg, double lonDeg, double altMeters) {
     double dLat = (latDeg - origin.latDeg) * kDegToRad;
     double dLon = (lonDeg - origin.lonDeg) * kDegToRad;
@@ -146,7 +95,7 @@ bool withinBounds(double lat, double lon, const BoundsLLA& bounds) {
 
 void printUsage() {
     std::cout << "Usage: ourairports_import --airports <airports.csv> --runways <runways.csv>\n"
-              << "                          --manifest <manifest.json> --out <output.json>\n"
+              << "                          --manifest <manifest.json> [--out <output.json>] [--db <airports.nadb>]\n"
               << "                          [--min-lat <deg> --min-lon <deg> --max-lat <deg> --max-lon <deg>]\n";
 }
 }
@@ -156,6 +105,7 @@ int main(int argc, char** argv) {
     std::string runwaysPath;
     std::string manifestPath;
     std::string outPath;
+    std::string dbPath;
     BoundsLLA boundsOverride;
     bool boundsOverrideSet = false;
 
@@ -174,6 +124,8 @@ int main(int argc, char** argv) {
             if (!next(manifestPath)) return 1;
         } else if (arg == "--out") {
             if (!next(outPath)) return 1;
+        } else if (arg == "--db") {
+            if (!next(dbPath)) return 1;
         } else if (arg == "--min-lat") {
             std::string v;
             if (!next(v)) return 1;
@@ -201,7 +153,7 @@ int main(int argc, char** argv) {
         }
     }
 
-    if (airportsPath.empty() || runwaysPath.empty() || manifestPath.empty() || outPath.empty()) {
+    if (airportsPath.empty() || runwaysPath.empty() || manifestPath.empty() || (outPath.empty() && dbPath.empty())) {
         printUsage();
         return 1;
     }
@@ -231,35 +183,33 @@ int main(int argc, char** argv) {
         if (bounds.minLon > bounds.maxLon) std::swap(bounds.minLon, bounds.maxLon);
     }
 
-    std::ifstream airportsFile(airportsPath);
-    if (!airportsFile.is_open()) {
-        std::cerr << "Failed to open airports.csv: " << airportsPath << "\n";
+    CsvReader airportsFile;
+    if (!airportsFile.open(airportsPath)) {
         return 1;
     }
-    std::ifstream runwaysFile(runwaysPath);
-    if (!runwaysFile.is_open()) {
-        std::cerr << "Failed to open runways.csv: " << runwaysPath << "\n";
+    CsvReader runwaysFile;
+    if (!runwaysFile.open(runwaysPath)) {
         return 1;
     }
 
     std::unordered_map<std::string, int> airportHeader;
     std::unordered_map<std::string, int> runwayHeader;
-    std::vector<std::string> fields;
+    std::vector<std::string_view> fields;
 
-    if (!parseCsvLine(airportsFile, fields)) {
+    if (!airportsFile.nextRow(fields)) {
         std::cerr << "airports.csv is empty.\n";
         return 1;
     }
     for (size_t i = 0; i < fields.size(); ++i) {
-        airportHeader[fields[i]] = static_cast<int>(i);
+        airportHeader[std::string(fields[i])] = static_cast<int>(i);
     }
 
-    if (!parseCsvLine(runwaysFile, fields)) {
+    if (!runwaysFile.nextRow(fields)) {
         std::cerr << "runways.csv is empty.\n";
         return 1;
     }
     for (size_t i = 0; i < fields.size(); ++i) {
-        runwayHeader[fields[i]] = static_cast<int>(i);
+        runwayHeader[std::string(fields[i])] = static_cast<int>(i);
     }
 
     auto idx = [&](const std::unordered_map<std::string, int>& map, const char* key) -> int {
@@ -267,6 +217,10 @@ int main(int argc, char** argv) {
         if (it == map.end()) return -1;
         return it->second;
     };
+    auto get = [&](int i) -> std::string_view {
+        if (i < 0 || static_cast<size_t>(i) >= fields.size()) return {};
+        return fields[static_cast<size_t>(i)];
+    };
 
     int aIdent = idx(airportHeader, "ident");
     int aName = idx(airportHeader, "name");
@@ -290,6 +244,7 @@ int main(int argc, char** argv) {
     int rLighted = idx(runwayHeader, "lighted");
     int rClosed = idx(runwayHeader, "closed");
 
+    bool writeJson = !outPath.empty();
     nlohmann::json out;
     out["originLLA"] = {origin.latDeg, origin.lonDeg, origin.altMeters};
     if (bounds.valid) {
@@ -298,26 +253,26 @@ int main(int argc, char** argv) {
     out["airports"] = nlohmann::json::array();
     out["runways"] = nlohmann::json::array();
 
-    std::unordered_set<std::string> selectedAirports;
+    nuage::AirportDatabase db;
+    db.setOrigin(origin.latDeg, origin.lonDeg, origin.altMeters);
+
+    // Selected airport ident -> database index.
+    std::unordered_map<std::string, std::uint32_t> selectedAirports;
 
-    while (parseCsvLine(airportsFile, fields)) {
+    while (airportsFile.nextRow(fields)) {
         if (fields.empty()) continue;
-        auto get = [&](int i) -> std::string {
-            if (i < 0 || static_cast<size_t>(i) >= fields.size()) return {};
-            return fields[static_cast<size_t>(i)];
-        };
 
-        std::string ident = get(aIdent);
+        std::string_view ident = get(aIdent);
         if (ident.empty()) continue;
 
-        std::string type = get(aType);
+        std::string_view type = get(aType);
         if (type == "heliport") {
             continue;
         }
 
         double lat = 0.0;
         double lon = 0.0;
-        if (!parseDouble(get(aLat), lat) || !parseDouble(get(aLon), lon)) {
+        if (!parseCsvDouble(get(aLat), lat) || !parseCsvDouble(get(aLon), lon)) {
             continue;
         }
         if (!withinBounds(lat, lon, bounds)) {
@@ -325,79 +280,133 @@ int main(int argc, char** argv) {
         }
 
         double elevFt = 0.0;
-        parseDouble(get(aElev), elevFt);
+        parseCsvDouble(get(aElev), elevFt);
         double elevM = elevFt * kFtToM;
         nuage::Vec3 enu = llaToEnu(origin, lat, lon, elevM);
 
-        nlohmann::json entry;
-        entry["ident"] = ident;
-        entry["name"] = get(aName);
-        entry["type"] = type;
-        entry["latitudeDeg"] = lat;
-        entry["longitudeDeg"] = lon;
-        entry["elevationFt"] = elevFt;
-        entry["positionENU"] = {enu.x, enu.y, enu.z};
-        out["airports"].push_back(entry);
-        selectedAirports.insert(ident);
+        if (writeJson) {
+            nlohmann::json entry;
+            entry["ident"] = ident;
+            entry["name"] = get(aName);
+            entry["type"] = type;
+            entry["latitudeDeg"] = lat;
+            entry["longitudeDeg"] = lon;
+            entry["elevationFt"] = elevFt;
+            entry["positionENU"] = {enu.x, enu.y, enu.z};
+            out["airports"].push_back(entry);
+        }
+
+        nuage::AirportRecord record;
+        record.latDeg = lat;
+        record.lonDeg = lon;
+        record.position[0] = enu.x;
+        record.position[1] = enu.y;
+        record.position[2] = enu.z;
+        record.elevationFt = static_cast<float>(elevFt);
+        record.ident = db.addString(ident);
+        record.name = db.addString(get(aName));
+        record.type = nuage::parseAirportType(type);
+        selectedAirports.emplace(std::string(ident), db.addAirport(record));
     }
 
-    while (parseCsvLine(runwaysFile, fields)) {
+    while (runwaysFile.nextRow(fields)) {
         if (fields.empty()) continue;
-        auto get = [&](int i) -> std::string {
-            if (i < 0 || static_cast<size_t>(i) >= fields.size()) return {};
-            return fields[static_cast<size_t>(i)];
-        };
 
-        std::string airportIdent = get(rAirport);
+        std::string_view airportIdent = get(rAirport);
         if (airportIdent.empty()) continue;
-        if (!selectedAirports.empty() && selectedAirports.find(airportIdent) == selectedAirports.end()) {
+        auto selected = selectedAirports.find(std::string(airportIdent));
+        if (!selectedAirports.empty() && selected == selectedAirports.end()) {
             continue;
         }
 
         double leLat = 0.0, leLon = 0.0, leElevFt = 0.0;
         double heLat = 0.0, heLon = 0.0, heElevFt = 0.0;
-        if (!parseDouble(get(rLeLat), leLat) || !parseDouble(get(rLeLon), leLon)) {
+        if (!parseCsvDouble(get(rLeLat), leLat) || !parseCsvDouble(get(rLeLon), leLon)) {
             continue;
         }
-        if (!parseDouble(get(rHeLat), heLat) || !parseDouble(get(rHeLon), heLon)) {
+        if (!parseCsvDouble(get(rHeLat), heLat) || !parseCsvDouble(get(rHeLon), heLon)) {
             continue;
         }
-        parseDouble(get(rLeElev), leElevFt);
-        parseDouble(get(rHeElev), heElevFt);
+        parseCsvDouble(get(rLeElev), leElevFt);
+        parseCsvDouble(get(rHeElev), heElevFt);
 
         double leElevM = leElevFt * kFtToM;
         double heElevM = heElevFt * kFtToM;
         nuage::Vec3 leEnu = llaToEnu(origin, leLat, leLon, leElevM);
         nuage::Vec3 heEnu = llaToEnu(origin, heLat, heLon, heElevM);
 
-        nlohmann::json entry;
-        entry["airportIdent"] = airportIdent;
-        entry["leIdent"] = get(rLeIdent);
-        entry["heIdent"] = get(rHeIdent);
-        entry["leLatitudeDeg"] = leLat;
-        entry["leLongitudeDeg"] = leLon;
-        entry["leElevationFt"] = leElevFt;
-        entry["heLatitudeDeg"] = heLat;
-        entry["heLongitudeDeg"] = heLon;
-        entry["heElevationFt"] = heElevFt;
-        entry["leENU"] = {leEnu.x, leEnu.y, leEnu.z};
-        entry["heENU"] = {heEnu.x, heEnu.y, heEnu.z};
-        entry["lengthFt"] = get(rLength);
-        entry["widthFt"] = get(rWidth);
-        entry["surface"] = get(rSurface);
-        entry["lighted"] = get(rLighted);
-        entry["closed"] = get(rClosed);
-        out["runways"].push_back(entry);
+        if (writeJson) {
+            nlohmann::json entry;
+            entry["airportIdent"] = airportIdent;
+            entry["leIdent"] = get(rLeIdent);
+            entry["heIdent"] = get(rHeIdent);
+            entry["leLatitudeDeg"] = leLat;
+            entry["leLongitudeDeg"] = leLon;
+            entry["leElevationFt"] = leElevFt;
+            entry["heLatitudeDeg"] = heLat;
+            entry["heLongitudeDeg"] = heLon;
+            entry["heElevationFt"] = heElevFt;
+            entry["leENU"] = {leEnu.x, leEnu.y, leEnu.z};
+            entry["heENU"] = {heEnu.x, heEnu.y, heEnu.z};
+            entry["lengthFt"] = get(rLength);
+            entry["widthFt"] = get(rWidth);
+            entry["surface"] = get(rSurface);
+            entry["lighted"] = get(rLighted);
+            entry["closed"] = get(rClosed);
+            out["runways"].push_back(entry);
+        }
+
+        // Only runways of airports in the database can be indexed.
+        if (selected == selectedAirports.end()) {
+            continue;
+        }
+        nuage::RunwayRecord record;
+        record.le[0] = leEnu.x;
+        record.le[1] = leEnu.y;
+        record.le[2] = leEnu.z;
+        record.he[0] = heEnu.x;
+        record.he[1] = heEnu.y;
+        record.he[2] = heEnu.z;
+        double lengthFt = 0.0;
+        double widthFt = 0.0;
+        parseCsvDouble(get(rLength), lengthFt);
+        parseCsvDouble(get(rWidth), widthFt);
+        record.lengthFt = static_cast<float>(lengthFt);
+        record.widthFt = static_cast<float>(widthFt);
+        record.airport = selected->second;
+        record.leIdent = db.addString(get(rLeIdent));
+        record.heIdent = db.addString(get(rHeIdent));
+        record.surface = db.addString(get(rSurface));
+        std::string_view lighted = get(rLighted);
+        std::string_view closed = get(rClosed);
+        if (lighted == "1" || lighted == "true" || lighted == "TRUE") {
+            record.flags |= nuage::RunwayLighted;
+        }
+        if (closed == "1" || closed == "true" || closed == "TRUE") {
+            record.flags |= nuage::RunwayClosed;
+        }
+        db.addRunway(record);
     }
 
-    std::ofstream outFile(outPath);
-    if (!outFile.is_open()) {
-        std::cerr << "Failed to open output: " << outPath << "\n";
-        return 1;
+    if (writeJson) {
+        std::ofstream outFile(outPath);
+        if (!outFile.is_open()) {
+            std::cerr << "Failed to open output: " << outPath << "\n";
+            return 1;
+        }
+        outFile << out.dump(2) << "\n";
+        std::cout << "Wrote " << out["airports"].size() << " airports and "
+                  << out["runways"].size() << " runways to " << outPath << "\n";
     }
-    outFile << out.dump(2) << "\n";
 
-    std::cout << "Wrote " << out["airports"].size() << " airports and "
-              << out["runways"].size() << " runways to " << outPath << "\n";
+    if (!dbPath.empty()) {
+        db.finalize(kDbCellMeters);
+        if (!db.save(dbPath)) {
+            std::cerr << "Failed to write airport database: " << dbPath << "\n";
+            return 1;
+        }
+        std::cout << "Wrote " << db.airportCount() << " airports and " << db.runwayCount()
+                  << " runways to " << dbPath << "\n";
+    }
     return 0;
 }
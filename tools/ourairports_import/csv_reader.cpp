@@ -0,0 +1,151 @@
+#include "tools/ourairports_import/csv_reader.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CsvReader::~CsvReader() {
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+bool CsvReader::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open CSV: " << path << "\n";
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        std::cerr << "Failed to stat CSV: " << path << "\n";
+        return false;
+    }
+    if (st.st_size <= 0) {
+        // Nothing to map; nextRow() reports end of input straight away.
+        ::close(fd);
+        return true;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Failed to map CSV: " << path << "\n";
+        return false;
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char*>(mapped);
+    m_size = size;
+    return true;
+}
+
+// Strips quoting characters from a field whose quotes are not a plain
+// "value" wrapper, into a buffer that lives until the next row.
+std::string_view CsvReader::unescape(const char* begin, const char* end) {
+    if (m_unescapedUsed == m_unescaped.size()) {
+        m_unescaped.emplace_back();
+    }
+    std::string& out = m_unescaped[m_unescapedUsed++];
+    out.clear();
+    bool inQuotes = false;
+    for (const char* p = begin; p < end; ++p) {
+        if (*p == '"') {
+            if (inQuotes && p + 1 < end && p[1] == '"') {
+                out.push_back('"');
+                ++p;
+            } else {
+                inQuotes = !inQuotes;
+            }
+        } else {
+            out.push_back(*p);
+        }
+    }
+    return out;
+}
+
+// Quotes toggle quoting anywhere in a field, "" inside quotes is a literal
+// quote, newlines inside quotes stay in the field and a trailing \r is dropped.
+bool CsvReader::nextRow(std::vector<std::string_view>& fields) {
+    fields.clear();
+    m_unescapedUsed = 0;
+    if (m_offset >= m_size) {
+        return false;
+    }
+
+    const char* p = m_data + m_offset;
+    const char* end = m_data + m_size;
+    while (true) {
+        const char* start = p;
+        int quotes = 0;
+        // Fast path: a field with no quotes ends at the next separator.
+        while (p < end && *p != ',' && *p != '\n' && *p != '"') {
+            ++p;
+        }
+        if (p < end && *p == '"') {
+            bool inQuotes = false;
+            for (; p < end; ++p) {
+                if (*p == '"') {
+                    ++quotes;
+                    if (inQuotes && p + 1 < end && p[1] == '"') {
+                        ++p;
+                    } else {
+                        inQuotes = !inQuotes;
+                    }
+                } else if (!inQuotes && (*p == ',' || *p == '\n')) {
+                    break;
+                }
+            }
+        }
+
+        // Like the quoting, a trailing \r is judged on the field's content and
+        // only dropped before a newline.
+        bool newline = p < end && *p == '\n';
+        bool stripCr = newline;
+        std::string_view field;
+        if (quotes == 0) {
+            field = std::string_view(start, static_cast<size_t>(p - start));
+        } else {
+            const char* closing = p;
+            if (newline && p[-1] == '\r') {
+                --closing;
+                stripCr = false;
+            }
+            if (quotes == 2 && *start == '"' && closing - start >= 2 && closing[-1] == '"') {
+                // Plain "value": view between the quotes.
+                field = std::string_view(start + 1, static_cast<size_t>(closing - start - 2));
+            } else {
+                field = unescape(start, p);
+                stripCr = newline;
+            }
+        }
+        if (stripCr && !field.empty() && field.back() == '\r') {
+            field.remove_suffix(1);
+        }
+        fields.push_back(field);
+
+        if (p >= end || newline) {
+            m_offset = p < end ? static_cast<size_t>(p - m_data) + 1 : m_size;
+            return true;
+        }
+        ++p; // skip ','
+    }
+}
+
+bool parseCsvDouble(std::string_view field, double& out) {
+    if (field.empty()) {
+        return false;
+    }
+    char buffer[64];
+    size_t length = std::min(field.size(), sizeof(buffer) - 1);
+    std::memcpy(buffer, field.data(), length);
+    buffer[length] = '\0';
+    char* end = nullptr;
+    out = std::strtod(buffer, &end);
+    return end != buffer;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Memory-mapped CSV reader. Fields are views into the mapping, so rows cost no
+// copies; only quoted fields containing doubled quotes are unescaped, into
+// buffers owned by the reader. Views stay valid until the next nextRow().
+class CsvReader {
+public:
+    CsvReader() = default;
+    ~CsvReader();
+    CsvReader(const CsvReader&) = delete;
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    bool open(const std::string& path);
+    // Splits the next record into fields. Returns false at end of input.
+    bool nextRow(std::vector<std::string_view>& fields);
+    size_t size() const { return m_size; }
+
+private:
+    std::string_view unescape(const char* begin, const char* end);
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_offset = 0;
+    std::deque<std::string> m_unescaped; // deque keeps earlier views valid as it grows
+    size_t m_unescapedUsed = 0;
+};
+
+// strtod over a field view; false when the field holds no number.
+bool parseCsvDouble(std::string_view field, double& out);
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "utils/raster_kernels.hpp"
+
+namespace {
+
+using nuage::SimdLevel;
+
+// A kernel run writes its whole output into a byte buffer so every SIMD level
+// can be compared against the scalar result with memcmp.
+struct KernelCase {
+    std::string name;
+    std::function<void(std::vector<std::uint8_t>& out)> run;
+};
+
+template<typename T>
+void storeBytes(const std::vector<T>& values, std::vector<std::uint8_t>& out) {
+    out.resize(values.size() * sizeof(T));
+    std::memcpy(out.data(), values.data(), out.size());
+}
+
+std::vector<SimdLevel> availableLevels() {
+    std::vector<SimdLevel> levels = {SimdLevel::Scalar};
+    SimdLevel best = nuage::detectSimdLevel();
+    if (best >= SimdLevel::Sse41) levels.push_back(SimdLevel::Sse41);
+    if (best >= SimdLevel::Avx2) levels.push_back(SimdLevel::Avx2);
+    return levels;
+}
+
+std::vector<std::uint8_t> blockyMask(int res, std::mt19937& rng) {
+    std::uniform_int_distribution<int> cls(0, 6);
+    std::uniform_real_distribution<float> noise(0.0f, 1.0f);
+    std::vector<std::uint8_t> blocks(static_cast<size_t>((res / 8 + 1) * (res / 8 + 1)));
+    for (auto& b : blocks) {
+        b = static_cast<std::uint8_t>(cls(rng));
+    }
+    std::vector<std::uint8_t> mask(static_cast<size_t>(res * res));
+    for (int z = 0; z < res; ++z) {
+        for (int x = 0; x < res; ++x) {
+            std::uint8_t value = blocks[static_cast<size_t>((z / 8) * (res / 8 + 1) + x / 8)];
+            if (noise(rng) < 0.25f) {
+                value = static_cast<std::uint8_t>(cls(rng));
+            }
+            mask[static_cast<size_t>(z * res + x)] = value;
+        }
+    }
+    return mask;
+}
+
+std::vector<KernelCase> buildCases(bool quick) {
+    std::vector<KernelCase> cases;
+    std::mt19937 rng(1234);
+
+    // Odd sizes exercise the scalar edges and tails around the vector loops.
+    for (int res : {1, 2, 3, 17, 33, 34, 65, quick ? 256 : 1024}) {
+        auto mask = std::make_shared<std::vector<std::uint8_t>>(blockyMask(res, rng));
+        cases.push_back({"majorityFilter3x3 " + std::to_string(res), [mask, res](std::vector<std::uint8_t>& out) {
+            out.assign(mask->size(), 0);
+            nuage::majorityFilter3x3(mask->data(), out.data(), res);
+        }});
+    }
+
+    struct ResampleSize {
+        int srcW, srcH, dstW, dstH;
+    };
+    for (ResampleSize size : {ResampleSize{1, 1, 3, 3}, ResampleSize{5, 7, 3, 9}, ResampleSize{63, 41, 64, 64},
+                              ResampleSize{1000, 700, quick ? 256 : 1024, quick ? 256 : 1024}}) {
+        auto src = std::make_shared<std::vector<std::uint8_t>>(static_cast<size_t>(size.srcW * size.srcH * 4));
+        std::uniform_int_distribution<int> byte(0, 255);
+        for (auto& b : *src) {
+            b = static_cast<std::uint8_t>(byte(rng));
+        }
+        std::string name = "resampleBilinearRGBA8 " + std::to_string(size.srcW) + "x" + std::to_string(size.srcH)
+            + "->" + std::to_string(size.dstW) + "x" + std::to_string(size.dstH);
+        cases.push_back({name, [src, size](std::vector<std::uint8_t>& out) {
+            out.assign(static_cast<size_t>(size.dstW * size.dstH * 4), 0);
+            nuage::resampleBilinearRGBA8(src->data(), size.srcW, size.srcH, out.data(), size.dstW, size.dstH);
+        }});
+    }
+
+    for (size_t count : {size_t{3}, size_t{13}, quick ? size_t{4096} : size_t{1} << 18}) {
+        auto data = std::make_shared<std::vector<float>>(count * 5);
+        std::uniform_real_distribution<float> value(-500.0f, 3000.0f);
+        std::uniform_real_distribution<float> t(0.0f, 1.0f);
+        for (size_t i = 0; i < count * 4; ++i) {
+            (*data)[i] = value(rng);
+        }
+        for (size_t i = count * 4; i < count * 5; ++i) {
+            (*data)[i] = t(rng);
+        }
+        cases.push_back({"bilinearBlendRow " + std::to_string(count), [data, count](std::vector<std::uint8_t>& out) {
+            std::vector<float> result(count);
+            const float* d = data->data();
+            nuage::bilinearBlendRow(d, d + count, d + 2 * count, d + 3 * count, d + 4 * count, 0.37f,
+                                    result.data(), count);
+            storeBytes(result, out);
+        }});
+    }
+
+    for (int res : {1, 2, 6, 13, quick ? 129 : 513}) {
+        auto positions = std::make_shared<std::vector<float>>(static_cast<size_t>(res * res * 3));
+        std::uniform_real_distribution<float> height(0.0f, 40.0f);
+        for (int z = 0; z < res; ++z) {
+            for (int x = 0; x < res; ++x) {
+                float* p = &(*positions)[static_cast<size_t>(z * res + x) * 3];
+                p[0] = 1000.0f + static_cast<float>(x) * 15.625f;
+                // Flat patches produce the degenerate +Y fallback too.
+                p[1] = (x / 4 + z / 4) % 3 == 0 ? 12.0f : height(rng);
+                p[2] = -2000.0f + static_cast<float>(z) * 15.625f;
+            }
+        }
+        cases.push_back({"gridNormals " + std::to_string(res), [positions, res](std::vector<std::uint8_t>& out) {
+            std::vector<float> normals(positions->size());
+            nuage::gridNormals(positions->data(), res, res, normals.data());
+            storeBytes(normals, out);
+        }});
+    }
+
+    for (bool flags : {false, true}) {
+        int maskRes = 512;
+        size_t vertexCount = quick ? 4099 : 263171;
+        auto mask = std::make_shared<std::vector<std::uint8_t>>(blockyMask(maskRes, rng));
+        auto verts = std::make_shared<std::vector<float>>(vertexCount * 9);
+        std::uniform_real_distribution<float> coord(-50.0f, 2050.0f);
+        for (size_t i = 0; i < vertexCount; ++i) {
+            (*verts)[i * 9 + 0] = coord(rng);
+            (*verts)[i * 9 + 2] = coord(rng);
+        }
+        auto classFlags = std::make_shared<std::vector<std::uint8_t>>(256);
+        for (size_t i = 0; i < classFlags->size(); ++i) {
+            (*classFlags)[i] = static_cast<std::uint8_t>((i * 5) & 0x7);
+        }
+        std::string name = std::string("maskBlendWeights ") + (flags ? "landclass" : "landuse");
+        cases.push_back({name, [mask, verts, classFlags, flags, maskRes, vertexCount](std::vector<std::uint8_t>& out) {
+            std::vector<float> work(*verts);
+            nuage::maskBlendWeights(work.data(), vertexCount, 9, mask->data(), maskRes, 2000.0f, 0.0f, 0.0f,
+                                    flags ? classFlags->data() : nullptr);
+            storeBytes(work, out);
+        }});
+    }
+    return cases;
+}
+
+double bestMs(const KernelCase& kernel, int iterations, std::vector<std::uint8_t>& out) {
+    double best = 1e30;
+    for (int it = 0; it < iterations; ++it) {
+        auto start = std::chrono::steady_clock::now();
+        kernel.run(out);
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+void printUsage() {
+    std::cout << "Usage: raster_kernels_bench [--iterations <n>] [--quick]\n"
+              << "  Runs every raster kernel at each SIMD level this CPU supports, checks the\n"
+              << "  output is bit-identical to the scalar version and reports the best of n runs.\n";
+}
+}
+
+int main(int argc, char** argv) {
+    int iterations = 10;
+    bool quick = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--quick") {
+            quick = true;
+        } else {
+            std::cerr << "Unknown arg: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::vector<SimdLevel> levels = availableLevels();
+    std::cout << "[raster_kernels_bench] cpu supports " << nuage::simdLevelName(levels.back())
+              << ", best of " << iterations << " runs\n";
+
+    size_t mismatches = 0;
+    for (const auto& kernel : buildCases(quick)) {
+        std::cout << "  " << kernel.name << ":";
+        std::vector<std::uint8_t> reference;
+        double scalarMs = 0.0;
+        for (SimdLevel level : levels) {
+            nuage::setSimdLevel(level);
+            std::vector<std::uint8_t> out;
+            double ms = bestMs(kernel, iterations, out);
+            std::cout << " " << nuage::simdLevelName(level) << " " << ms << " ms";
+            if (level == SimdLevel::Scalar) {
+                reference = std::move(out);
+                scalarMs = ms;
+                continue;
+            }
+            if (ms > 0.0) {
+                std::cout << " (" << (scalarMs / ms) << "x)";
+            }
+            if (out != reference) {
+                std::cout << " MISMATCH";
+                ++mismatches;
+            }
+        }
+        std::cout << "\n";
+    }
+    nuage::setSimdLevel(nuage::detectSimdLevel());
+
+    if (mismatches > 0) {
+        std::cerr << "[raster_kernels_bench] " << mismatches << " kernel runs differ from scalar\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "utils/stb_image.h"
+#include "tools/terrainc/raster.hpp"
+
+namespace {
+void printUsage() {
+    std::cout << "Usage: raster_tile --in <raster> --out <file.ntr> [--tile <pixels>]\n"
+              << "  Converts a DEM or landclass raster (PNG, PGM, .hgt, .bil/.raw + .hdr)\n"
+              << "  into the tiled .ntr layout terrainc reads through mmap.\n";
+}
+}
+
+int main(int argc, char** argv) {
+    std::string inPath;
+    std::string outPath;
+    int tileSize = 256;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&](std::string& out) -> bool {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        if (arg == "--in") {
+            if (!next(inPath)) return 1;
+        } else if (arg == "--out") {
+            if (!next(outPath)) return 1;
+        } else if (arg == "--tile") {
+            std::string v;
+            if (!next(v)) return 1;
+            tileSize = std::atoi(v.c_str());
+        } else {
+            std::cerr << "Unknown arg: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (inPath.empty() || outPath.empty() || tileSize <= 0) {
+        printUsage();
+        return 1;
+    }
+
+    Raster raster;
+    if (!raster.open(inPath)) {
+        std::cerr << "Failed to load raster: " << inPath << "\n";
+        return 1;
+    }
+    if (!writeTiledRaster(raster, outPath, tileSize)) {
+        std::cerr << "Failed to write tiled raster: " << outPath << "\n";
+        return 1;
+    }
+    std::cout << "Wrote " << raster.width() << "x" << raster.height() << " raster as "
+              << tileSize << "px tiles to " << outPath << "\n";
+    return 0;
+}
@@ -69,6 +69,7 @@ def main():
     parser.add_argument("--clean", action="store_true")
     parser.add_argument("--download", action="store_true")
     parser.add_argument("--dry-run", action="store_true")
+    parser.add_argument("--threads", type=int, default=0, help="terrainc worker threads (0 = all cores)")
     args = parser.parse_args()
 
     repo_root = Path(__file__).resolve().parents[2]
@@ -93,6 +94,7 @@ def main():
     output_pack = resolve_path(repo_root, config["outputPack"])
     tmp_compiled = work_dir / "compiled_tmp"
     runways_json = work_dir / "runways_source.json"
+    airports_db = work_dir / "airports.nadb"
 
     terrainc = resolve_path(repo_root, config.get("terrainc", "build/terrainc"))
     ourairports = resolve_path(repo_root, config.get("ourairports_import", "build/ourairports_import"))
@@ -125,8 +127,8 @@ def main():
     landclass_clip = work_dir / "landclass_clip.tif"
     landclass_resampled = work_dir / "landclass_resampled.tif"
     landclass_gray = work_dir / "landclass_gray.tif"
-    height_png = work_dir / "height.png"
-    landclass_pgm = work_dir / "landclass.pgm"
+    height_bil = work_dir / "height.bil"
+    landclass_bil = work_dir / "landclass.bil"
 
     if args.download:
         downloads = config.get("downloads", {})
@@ -264,8 +266,8 @@ def main():
         args.dry_run,
     )
     run(
-        f"gdal_translate -of PNG -ot UInt16 -scale {config['heightMin']} {config['heightMax']} 0 65535 "
-        f"\"{dem_clip}\" \"{height_png}\"",
+        f"gdal_translate -of EHdr -ot UInt16 -scale {config['heightMin']} {config['heightMax']} 0 65535 "
+        f"\"{dem_clip}\" \"{height_bil}\"",
         args.dry_run,
     )
 
@@ -274,7 +276,9 @@ def main():
         f"-r near -overwrite \"{landclass_src}\" \"{landclass_clip}\"",
         args.dry_run,
     )
-    landclass_max_dim = config.get("landclassMaxDim", 4096)
+    # terrainc maps the BIL outputs and reads them per tile, so full resolution
+    # is fine; landclassMaxDim remains as an opt-in cap.
+    landclass_max_dim = config.get("landclassMaxDim", 0)
     landclass_source = landclass_clip
     if landclass_max_dim and not args.dry_run:
         w, h = gdal_raster_size(landclass_clip)
@@ -295,8 +299,8 @@ def main():
         args.dry_run,
     )
     run(
-        f"gdal_translate -of PNM -ot Byte -b 1 -a_nodata 0 "
-        f"\"{landclass_gray}\" \"{landclass_pgm}\"",
+        f"gdal_translate -of EHdr -ot Byte -b 1 -a_nodata 0 "
+        f"\"{landclass_gray}\" \"{landclass_bil}\"",
         args.dry_run,
     )
 
@@ -304,11 +308,14 @@ def main():
     tile_size = config["tileSizeMeters"]
     grid_res = config["gridResolution"]
     runway_blend = config.get("runwayBlendMeters", 60.0)
+    lod_levels = config.get("lodLevels", 0)
+    mesh_max_error = config.get("meshMaxError", 0.0)
+    normal_map_res = config.get("normalMapResolution", 0)
 
     if landclass_map and not landclass_map.exists():
         raise SystemExit(f"Missing landclass map: {landclass_map}")
 
-    landclass_args = f"--landclass \"{landclass_pgm}\" --mask-res {mask_res}"
+    landclass_args = f"--landclass \"{landclass_bil}\" --mask-res {mask_res}"
     if landclass_map:
         landclass_args += f" --landclass-map \"{landclass_map}\""
     use_osm = False
@@ -319,13 +326,12 @@ def main():
             print(f"[scenery] OSM source missing, skipping: {osm_src}")
     if use_osm and landclass_src.exists() and not config.get("useOsmWithLandclass", False):
         use_osm = False
-    if use_osm:
-        require_tool("osmium")
     bbox_args = f"--xmin {xmin} --ymin {ymin} --xmax {xmax} --ymax {ymax}"
     base_args = (
-        f"\"{terrainc}\" --heightmap \"{height_png}\" "
+        f"\"{terrainc}\" --heightmap \"{height_bil}\" "
         f"--height-min {config['heightMin']} --height-max {config['heightMax']} "
-        f"--tile-size {tile_size} --grid {grid_res} {bbox_args} {landclass_args}"
+        f"--tile-size {tile_size} --grid {grid_res} {bbox_args} {landclass_args} "
+        f"--threads {args.threads}"
     )
     if use_osm:
         base_args += f" --osm \"{osm_src}\""
@@ -334,7 +340,7 @@ def main():
 
     run(
         f"\"{ourairports}\" --airports \"{airports_csv}\" --runways \"{runways_csv}\" "
-        f"--manifest \"{tmp_compiled / 'manifest.json'}\" --out \"{runways_json}\" "
+        f"--manifest \"{tmp_compiled / 'manifest.json'}\" --out \"{runways_json}\" --db \"{airports_db}\" "
         f"--min-lat {ymin} --min-lon {xmin} --max-lat {ymax} --max-lon {xmax}",
         args.dry_run,
     )
@@ -344,10 +350,15 @@ def main():
     output_pack.mkdir(parents=True, exist_ok=True)
 
     run(
-        f"{base_args} --runways-json \"{runways_json}\" --runway-blend {runway_blend} --out \"{output_pack}\"",
+        f"{base_args} --runways-json \"{runways_json}\" --runway-blend {runway_blend} "
+        f"--lod-levels {lod_levels} --max-error {mesh_max_error} "
+        f"--normal-map-res {normal_map_res} --out \"{output_pack}\"",
         args.dry_run,
     )
 
+    if not args.dry_run:
+        shutil.copy2(airports_db, output_pack / "airports.nadb")
+
     pack_meta = {
         "name": config["name"],
         "bbox": bbox,
@@ -1,31 +1,47 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <initializer_list>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "utils/stb_image.h"
 #include "utils/config_loader.hpp"
 #include "utils/json.hpp"
+#include "utils/raster_kernels.hpp"
 #include "math/vec2.hpp"
 #include "math/vec3.hpp"
 #include "tools/terrainc/color_ramp.hpp"
+#include "tools/terrainc/compile_profile.hpp"
+#include "tools/terrainc/geojson_stream.hpp"
 #include "tools/terrainc/heightmap.hpp"
 #include "tools/terrainc/mask_smoothing.hpp"
+#include "tools/terrainc/osm_pbf.hpp"
+#include "tools/terrainc/raster.hpp"
+#include "tools/terrainc/rtin.hpp"
+#include "tools/terrainc/tile_fingerprint.hpp"
 
 namespace {
 struct Config {
     std::string heightmapPath;
     std::string osmPath;
+    std::string landuseGeoJsonPath;
+    std::string waterGeoJsonPath;
+    std::string roadsGeoJsonPath;
     std::string landcoverPath;
     std::string landclassPath;
     std::string landclassMapPath;
@@ -50,6 +66,14 @@ struct Config {
     double originLon = 0.0;
     double originAlt = 0.0;
     float runwayBlendMeters = 60.0f;
+    int threads = 1;
+    bool force = false;
+    bool useOsmium = false;
+    int lodLevels = 0;
+    float maxError = 0.0f;
+    int normalMapResolution = 0;
+    std::string profilePath;
+    int profileSlowest = 10;
 };
 
 struct RunwayInput {
@@ -82,7 +106,15 @@ void printUsage() {
               << "               [--osm <path> --mask-res <pixels> --xmin <lon> --ymin <lat>\n"
               << "                --xmax <lon> --ymax <lat> --mask-smooth <passes>\n"
               << "                --road-width-boost <scale> --road-smooth <passes>]\n"
-              << "               [--landcover <path>] [--landclass <path>] [--landclass-map <path>]\n";
+              << "               [--osmium]  (filter OSM through the external osmium tool instead)\n"
+              << "               [--landuse-geojson <path>] [--water-geojson <path>] [--roads-geojson <path>]\n"
+              << "               [--landcover <path>] [--landclass <path>] [--landclass-map <path>]\n"
+              << "               [--threads <count>]  (0 = all hardware threads)\n"
+              << "               [--force]  (rebuild tiles even if their inputs are unchanged)\n"
+              << "               [--lod-levels <count>]  (coarser far-field levels under tiles/lodN)\n"
+              << "               [--max-error <m>]  (adaptive mesh within this vertical error; grid must be a power of two)\n"
+              << "               [--normal-map-res <pixels>]  (bake per-tile normal/curvature maps from the DEM)\n"
+              << "               [--profile <report.json> [--profile-slowest <count>]]  (per-stage tile timings)\n";
 }
 
 bool parseArgs(int argc, char** argv, Config& cfg) {
@@ -130,6 +162,12 @@ bool parseArgs(int argc, char** argv, Config& cfg) {
             cfg.runwayBlendMeters = std::stof(v);
         } else if (arg == "--osm") {
             if (!next(cfg.osmPath)) return false;
+        } else if (arg == "--landuse-geojson") {
+            if (!next(cfg.landuseGeoJsonPath)) return false;
+        } else if (arg == "--water-geojson") {
+            if (!next(cfg.waterGeoJsonPath)) return false;
+        } else if (arg == "--roads-geojson") {
+            if (!next(cfg.roadsGeoJsonPath)) return false;
         } else if (arg == "--landcover") {
             if (!next(cfg.landcoverPath)) return false;
         } else if (arg == "--landclass") {
@@ -184,6 +222,32 @@ bool parseArgs(int argc, char** argv, Config& cfg) {
             std::string v;
             if (!next(v)) return false;
             cfg.originAlt = std::stod(v);
+        } else if (arg == "--threads") {
+            std::string v;
+            if (!next(v)) return false;
+            cfg.threads = std::stoi(v);
+        } else if (arg == "--force") {
+            cfg.force = true;
+        } else if (arg == "--osmium") {
+            cfg.useOsmium = true;
+        } else if (arg == "--normal-map-res") {
+            std::string v;
+            if (!next(v)) return false;
+            cfg.normalMapResolution = std::stoi(v);
+        } else if (arg == "--max-error") {
+            std::string v;
+            if (!next(v)) return false;
+            cfg.maxError = std::stof(v);
+        } else if (arg == "--profile") {
+            if (!next(cfg.profilePath)) return false;
+        } else if (arg == "--profile-slowest") {
+            std::string v;
+            if (!next(v)) return false;
+            cfg.profileSlowest = std::max(0, std::stoi(v));
+        } else if (arg == "--lod-levels") {
+            std::string v;
+            if (!next(v)) return false;
+            cfg.lodLevels = std::stoi(v);
         } else {
             std::cerr << "Unknown arg: " << arg << "\n";
             return false;
@@ -200,6 +264,11 @@ bool parseArgs(int argc, char** argv, Config& cfg) {
     return true;
 }
 
+bool hasVectorInputs(const Config& cfg) {
+    return !cfg.osmPath.empty() || !cfg.landuseGeoJsonPath.empty() ||
+           !cfg.waterGeoJsonPath.empty() || !cfg.roadsGeoJsonPath.empty();
+}
+
 bool writeMesh(const std::filesystem::path& path, const std::vector<float>& verts) {
     std::ofstream out(path, std::ios::binary);
     if (!out.is_open()) return false;
@@ -211,10 +280,30 @@ bool writeMesh(const std::filesystem::path& path, const std::vector<float>& vert
     return static_cast<bool>(out);
 }
 
-void writeTileMeta(const std::filesystem::path& path, int tx, int ty, float minH, float maxH, int grid) {
+// NTM2: float count, index count, then the vertex floats and uint32 triangle indices.
+bool writeIndexedMesh(const std::filesystem::path& path, const std::vector<float>& verts,
+                      const std::vector<std::uint32_t>& indices) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) return false;
+    const char magic[4] = {'N', 'T', 'M', '2'};
+    std::uint32_t count = static_cast<std::uint32_t>(verts.size());
+    std::uint32_t indexCount = static_cast<std::uint32_t>(indices.size());
+    out.write(magic, 4);
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(&indexCount), sizeof(indexCount));
+    out.write(reinterpret_cast<const char*>(verts.data()), static_cast<std::streamsize>(verts.size() * sizeof(float)));
+    out.write(reinterpret_cast<const char*>(indices.data()),
+              static_cast<std::streamsize>(indices.size() * sizeof(std::uint32_t)));
+    return static_cast<bool>(out);
+}
+
+void writeTileMeta(const std::filesystem::path& path, int level, int tx, int ty, float minH, float maxH, int grid) {
     std::ofstream out(path);
     out << "{\n";
     out << "  \"tileId\": [" << tx << ", " << ty << "],\n";
+    if (level > 0) {
+        out << "  \"level\": " << level << ",\n";
+    }
     out << "  \"gridResolution\": " << grid << ",\n";
     out << "  \"minHeight\": " << minH << ",\n";
     out << "  \"maxHeight\": " << maxH << "\n";
@@ -252,7 +341,7 @@ struct GeoTransform {
 struct LandcoverRaster {
     int width = 0;
     int height = 0;
-    std::vector<std::uint16_t> data;
+    Raster raster;
     GeoTransform geo;
     bool valid = false;
 };
@@ -327,42 +416,32 @@ LandcoverRaster loadLandcoverRaster(const std::string& path) {
     if (path.empty()) {
         return lc;
     }
+    if (!lc.raster.open(path)) {
+        std::cerr << "Failed to load landcover: " << path << "\n";
+        return lc;
+    }
     GeoTransform gt;
+    double headerGeo[6];
     if (!readGeoTransformFromAux(path, gt)) {
-        std::cerr << "Landcover requires a GeoTransform in " << path << ".aux.xml\n";
-        return lc;
+        if (!lc.raster.headerGeoTransform(headerGeo)) {
+            std::cerr << "Landcover requires a GeoTransform in " << path << ".aux.xml\n";
+            return lc;
+        }
+        gt.originX = headerGeo[0];
+        gt.pixelW = headerGeo[1];
+        gt.rotX = headerGeo[2];
+        gt.originY = headerGeo[3];
+        gt.rotY = headerGeo[4];
+        gt.pixelH = headerGeo[5];
     }
     if (std::abs(gt.rotX) > 1e-6 || std::abs(gt.rotY) > 1e-6) {
         std::cerr << "Landcover rotation not supported; please use north-up rasters.\n";
         return lc;
     }
-    int w = 0;
-    int h = 0;
-    int ch = 0;
-    if (stbi_is_16_bit(path.c_str())) {
-        std::uint16_t* data = stbi_load_16(path.c_str(), &w, &h, &ch, 1);
-        if (!data) {
-            std::cerr << "Failed to load landcover: " << path << "\n";
-            return lc;
-        }
-        lc.data.assign(data, data + static_cast<size_t>(w * h));
-        stbi_image_free(data);
-    } else {
-        unsigned char* data = stbi_load(path.c_str(), &w, &h, &ch, 1);
-        if (!data) {
-            std::cerr << "Failed to load landcover: " << path << "\n";
-            return lc;
-        }
-        lc.data.resize(static_cast<size_t>(w * h));
-        for (int i = 0; i < w * h; ++i) {
-            lc.data[static_cast<size_t>(i)] = data[i];
-        }
-        stbi_image_free(data);
-    }
-    lc.width = w;
-    lc.height = h;
+    lc.width = lc.raster.width();
+    lc.height = lc.raster.height();
     lc.geo = gt;
-    lc.valid = !lc.data.empty();
+    lc.valid = lc.width > 0 && lc.height > 0;
     return lc;
 }
 
@@ -404,21 +483,9 @@ LandclassMap loadLandclassMap(const std::string& path) {
     return mapping;
 }
 
-int classFromTags(const nlohmann::json& tags) {
-    auto getTag = [&](const char* key) -> std::string {
-        if (!tags.contains(key)) {
-            return {};
-        }
-        const auto& val = tags[key];
-        if (!val.is_string()) {
-            return {};
-        }
-        return val.get<std::string>();
-    };
-
-    std::string landuse = getTag("landuse");
+int classFromTagValues(std::string_view landuse, std::string_view natural) {
     if (!landuse.empty()) {
-        std::string v = landuse;
+        std::string_view v = landuse;
         if (v == "residential" || v == "commercial" || v == "industrial" || v == "retail") {
             return 2;
         }
@@ -434,9 +501,8 @@ int classFromTags(const nlohmann::json& tags) {
         }
         return 5;
     }
-    std::string natural = getTag("natural");
     if (!natural.empty()) {
-        std::string v = natural;
+        std::string_view v = natural;
         if (v == "wood" || v == "forest") {
             return 3;
         }
@@ -450,6 +516,20 @@ int classFromTags(const nlohmann::json& tags) {
     return 0;
 }
 
+int classFromTags(const nlohmann::json& tags) {
+    auto getTag = [&](const char* key) -> std::string {
+        if (!tags.contains(key)) {
+            return {};
+        }
+        const auto& val = tags[key];
+        if (!val.is_string()) {
+            return {};
+        }
+        return val.get<std::string>();
+    };
+    return classFromTagValues(getTag("landuse"), getTag("natural"));
+}
+
 struct Projection {
     double lon0 = 0.0;
     double lat0 = 0.0;
@@ -486,8 +566,7 @@ float sampleHeightAtWorld(const Heightmap& hm, const Config& cfg, float minX, fl
     v = clamp01(v);
     float hx = u * static_cast<float>(hm.width - 1);
     float hz = v * static_cast<float>(hm.height - 1);
-    float raw = bilinearSample(hm, hx, hz) / 65535.0f;
-    return cfg.heightMin + raw * heightRange;
+    return sampleHeightMeters(hm, hx, hz, cfg.heightMin, heightRange);
 }
 
 float applyRunwayFlatten(float worldX, float worldZ, float baseHeight,
@@ -547,24 +626,18 @@ bool runCommand(const std::string& command) {
     return result == 0;
 }
 
-std::vector<Polygon> loadPolygonsFromGeoJson(const std::string& path, int defaultClass,
-                                             const Projection& proj, bool useTags) {
-    std::ifstream in(path);
-    if (!in.is_open()) {
-        std::cerr << "Failed to open GeoJSON: " << path << "\n";
-        return {};
-    }
-    nlohmann::json doc;
-    in >> doc;
-    if (!doc.contains("features") || !doc["features"].is_array()) {
-        return {};
-    }
+void reportGeoJsonStats(const std::string& path, const GeoJsonStreamStats& stats) {
+    std::cout << "[terrainc] streamed " << stats.features << " features from " << path
+              << " (largest " << stats.largestFeatureBytes << " bytes)\n";
+}
 
-    std::vector<Polygon> polys;
-    for (const auto& feature : doc["features"]) {
-        if (!feature.contains("geometry")) continue;
+bool loadPolygonsFromGeoJson(const std::string& path, int defaultClass,
+                             const Projection& proj, bool useTags, std::vector<Polygon>& polys) {
+    GeoJsonStreamStats stats;
+    bool ok = forEachGeoJsonFeature(path, [&](const nlohmann::json& feature) {
+        if (!feature.contains("geometry")) return;
         const auto& geom = feature["geometry"];
-        if (!geom.contains("type") || !geom.contains("coordinates")) continue;
+        if (!geom.is_object() || !geom.contains("type") || !geom.contains("coordinates")) return;
 
         int classId = defaultClass;
         if (useTags && feature.contains("properties")) {
@@ -576,7 +649,7 @@ std::vector<Polygon> loadPolygonsFromGeoJson(const std::string& path, int defaul
             }
         }
         if (classId == 0) {
-            continue;
+            return;
         }
 
         std::string type = geom["type"].get<std::string>();
@@ -616,8 +689,11 @@ std::vector<Polygon> loadPolygonsFromGeoJson(const std::string& path, int defaul
                 }
             }
         }
+    }, &stats);
+    if (ok) {
+        reportGeoJsonStats(path, stats);
     }
-    return polys;
+    return ok;
 }
 
 int classPriority(int classId) {
@@ -672,7 +748,7 @@ int sampleLandcoverClass(const LandcoverRaster& lc, double lon, double lat) {
     if (ix < 0 || iy < 0 || ix >= lc.width || iy >= lc.height) {
         return 0;
     }
-    std::uint16_t v = lc.data[static_cast<size_t>(iy) * lc.width + static_cast<size_t>(ix)];
+    auto v = static_cast<std::uint16_t>(std::max(0, lc.raster.at(ix, iy)));
     return landcoverClassFromValue(v);
 }
 
@@ -687,7 +763,7 @@ int sampleLandclassValue(const LandcoverRaster& lc, double lon, double lat) {
     if (ix < 0 || iy < 0 || ix >= lc.width || iy >= lc.height) {
         return 0;
     }
-    std::uint16_t v = lc.data[static_cast<size_t>(iy) * lc.width + static_cast<size_t>(ix)];
+    auto v = static_cast<std::uint16_t>(std::max(0, lc.raster.at(ix, iy)));
     return static_cast<int>(std::min<std::uint16_t>(v, 255));
 }
 
@@ -747,14 +823,7 @@ void fillMaskFromLandclass(std::vector<std::uint8_t>& mask, int maskRes,
     }
 }
 
-float roadHalfWidthFromTags(const nlohmann::json& tags) {
-    auto getTag = [&](const char* key) -> std::string {
-        if (!tags.contains(key)) return {};
-        const auto& val = tags[key];
-        if (!val.is_string()) return {};
-        return val.get<std::string>();
-    };
-    std::string highway = getTag("highway");
+float roadHalfWidthFromHighway(std::string_view highway) {
     if (highway.empty()) {
         return 0.0f;
     }
@@ -770,26 +839,25 @@ float roadHalfWidthFromTags(const nlohmann::json& tags) {
     return 3.0f;
 }
 
-std::vector<Road> loadRoadsFromGeoJson(const std::string& path, const Projection& proj) {
-    std::ifstream in(path);
-    if (!in.is_open()) {
-        std::cerr << "Failed to open roads GeoJSON: " << path << "\n";
-        return {};
-    }
-    nlohmann::json doc;
-    in >> doc;
-    if (!doc.contains("features") || !doc["features"].is_array()) {
-        return {};
-    }
+float roadHalfWidthFromTags(const nlohmann::json& tags) {
+    auto getTag = [&](const char* key) -> std::string {
+        if (!tags.contains(key)) return {};
+        const auto& val = tags[key];
+        if (!val.is_string()) return {};
+        return val.get<std::string>();
+    };
+    return roadHalfWidthFromHighway(getTag("highway"));
+}
 
-    std::vector<Road> roads;
-    for (const auto& feature : doc["features"]) {
+bool loadRoadsFromGeoJson(const std::string& path, const Projection& proj, std::vector<Road>& roads) {
+    GeoJsonStreamStats stats;
+    bool ok = forEachGeoJsonFeature(path, [&](const nlohmann::json& feature) {
         if (!feature.contains("geometry") || !feature.contains("properties")) {
-            continue;
+            return;
         }
         const auto& geom = feature["geometry"];
-        if (!geom.contains("type") || !geom.contains("coordinates")) {
-            continue;
+        if (!geom.is_object() || !geom.contains("type") || !geom.contains("coordinates")) {
+            return;
         }
         const auto& props = feature["properties"];
         const auto* tags = &props;
@@ -798,7 +866,7 @@ std::vector<Road> loadRoadsFromGeoJson(const std::string& path, const Projection
         }
         float halfWidth = roadHalfWidthFromTags(*tags);
         if (halfWidth <= 0.0f) {
-            continue;
+            return;
         }
 
         std::string type = geom["type"].get<std::string>();
@@ -835,8 +903,81 @@ std::vector<Road> loadRoadsFromGeoJson(const std::string& path, const Projection
                 }
             }
         }
+    }, &stats);
+    if (ok) {
+        reportGeoJsonStats(path, stats);
+    }
+    return ok;
+}
+
+// Mirrors the tag filters the osmium pipeline applies for water, landuse and roads.
+void classifyOsmFeature(const OsmTags& tags, std::vector<OsmFeatureKind>& out) {
+    std::string_view natural = tags.get("natural");
+    std::string_view waterway = tags.get("waterway");
+    if (natural == "water" || natural == "wetland" || tags.has("water") || waterway == "riverbank" ||
+        waterway == "river" || waterway == "stream" || waterway == "canal") {
+        out.push_back({1, true, 0.0f});
+    }
+
+    std::string_view landuse = tags.get("landuse");
+    if (tags.has("landuse") || natural == "wood" || natural == "grassland" || natural == "heath" ||
+        natural == "scrub" || natural == "beach" || natural == "bare_rock" || natural == "scree" ||
+        natural == "shingle") {
+        int classId = classFromTagValues(landuse, natural);
+        if (classId != 0) {
+            out.push_back({classId, true, 0.0f});
+        }
+    }
+
+    float halfWidth = roadHalfWidthFromHighway(tags.get("highway"));
+    if (halfWidth > 0.0f) {
+        out.push_back({7, false, halfWidth});
+    }
+}
+
+void appendOsmFeatures(const OsmExtract& extract, const Projection& proj, std::vector<Polygon>& landPolys,
+                       std::vector<Polygon>& waterPolys, std::vector<Road>& roads) {
+    for (const auto& feature : extract.features) {
+        float minX = std::numeric_limits<float>::max();
+        float minZ = std::numeric_limits<float>::max();
+        float maxX = std::numeric_limits<float>::lowest();
+        float maxZ = std::numeric_limits<float>::lowest();
+        std::vector<nuage::Vec2> points;
+        points.reserve(feature.points.size());
+        for (const auto& pt : feature.points) {
+            nuage::Vec2 p = projectLonLat(proj, pt.lon, pt.lat);
+            minX = std::min(minX, p.x);
+            maxX = std::max(maxX, p.x);
+            minZ = std::min(minZ, p.y);
+            maxZ = std::max(maxZ, p.y);
+            points.push_back(p);
+        }
+
+        if (feature.kind.area) {
+            Polygon poly;
+            poly.ring = std::move(points);
+            poly.minX = minX;
+            poly.minZ = minZ;
+            poly.maxX = maxX;
+            poly.maxZ = maxZ;
+            poly.classId = feature.kind.classId;
+            if (poly.classId == 1) {
+                waterPolys.push_back(std::move(poly));
+            } else {
+                landPolys.push_back(std::move(poly));
+            }
+        } else {
+            Road road;
+            road.points = std::move(points);
+            road.minX = minX;
+            road.minZ = minZ;
+            road.maxX = maxX;
+            road.maxZ = maxZ;
+            road.halfWidth = feature.kind.width;
+            road.valid = true;
+            roads.push_back(std::move(road));
+        }
     }
-    return roads;
 }
 
 float distancePointToSegment(const nuage::Vec2& p, const nuage::Vec2& a, const nuage::Vec2& b) {
@@ -851,12 +992,75 @@ float distancePointToSegment(const nuage::Vec2& p, const nuage::Vec2& a, const n
     return (p - proj).length();
 }
 
+// X-range where the capsule of radius r around segment ab crosses the row at z.
+// The capsule is convex, so the row hits it in a single interval: the union of
+// both end-cap disks and the swept rectangle.
+bool capsuleRowSpan(const nuage::Vec2& a, const nuage::Vec2& b, double r, double z,
+                    double& outMin, double& outMax) {
+    double lo = std::numeric_limits<double>::max();
+    double hi = std::numeric_limits<double>::lowest();
+    auto addDisk = [&](const nuage::Vec2& c) {
+        double dz = z - c.y;
+        double h2 = r * r - dz * dz;
+        if (h2 >= 0.0) {
+            double h = std::sqrt(h2);
+            lo = std::min(lo, c.x - h);
+            hi = std::max(hi, c.x + h);
+        }
+    };
+    addDisk(a);
+    addDisk(b);
+
+    double abx = static_cast<double>(b.x) - a.x;
+    double abz = static_cast<double>(b.y) - a.y;
+    double len2 = abx * abx + abz * abz;
+    if (len2 > 1e-6) {
+        double len = std::sqrt(len2);
+        double dz = z - a.y;
+        double spanMin = std::numeric_limits<double>::lowest();
+        double spanMax = std::numeric_limits<double>::max();
+        // Restrict (x - a.x) so that c0 + c1 * (x - a.x) stays within [minV, maxV].
+        auto restrict = [&](double c0, double c1, double minV, double maxV) {
+            if (std::abs(c1) < 1e-12) {
+                if (c0 < minV || c0 > maxV) {
+                    spanMin = 1.0;
+                    spanMax = 0.0;
+                }
+                return;
+            }
+            double e0 = (minV - c0) / c1;
+            double e1 = (maxV - c0) / c1;
+            spanMin = std::max(spanMin, std::min(e0, e1));
+            spanMax = std::min(spanMax, std::max(e0, e1));
+        };
+        restrict(dz * abz / len2, abx / len2, 0.0, 1.0);
+        restrict(-dz * abx / len, abz / len, -r, r);
+        if (spanMin <= spanMax) {
+            lo = std::min(lo, a.x + spanMin);
+            hi = std::max(hi, a.x + spanMax);
+        }
+    }
+    outMin = lo;
+    outMax = hi;
+    return lo <= hi;
+}
+
+// Stamps each segment's capsule separately, visiting only the cells near it.
+// Candidate spans are padded by a cell and every cell is still checked with
+// distancePointToSegment, so the result matches a full per-cell scan.
 void rasterizeRoadsToMaskList(std::vector<std::uint8_t>& mask, int maskRes,
                               float tileMinX, float tileMinZ, float tileSize,
                               const std::vector<Road>& roads,
                               const std::vector<int>& indices,
                               float widthBoost) {
     if (maskRes <= 0 || indices.empty()) return;
+    double cellsPerMeter = static_cast<double>(maskRes) / tileSize;
+    // Cell whose center is nearest to a world offset, kept in int range.
+    auto cellIndex = [&](double offset, bool roundUp) {
+        double cell = offset * cellsPerMeter - 0.5;
+        cell = roundUp ? std::ceil(cell) : std::floor(cell);
+        return static_cast<int>(std::clamp(cell, -2.0, static_cast<double>(maskRes) + 1.0));
+    };
     for (int idx : indices) {
         const auto& road = roads[static_cast<size_t>(idx)];
         if (!road.valid) continue;
@@ -875,20 +1079,31 @@ void rasterizeRoadsToMaskList(std::vector<std::uint8_t>& mask, int maskRes,
         z0 = std::clamp(z0, 0, maskRes - 1);
         z1 = std::clamp(z1, 0, maskRes - 1);
 
-        for (int z = z0; z <= z1; ++z) {
-            for (int x = x0; x <= x1; ++x) {
-                float fx = (static_cast<float>(x) + 0.5f) / maskRes;
+        for (size_t i = 0; i + 1 < road.points.size(); ++i) {
+            const auto& a = road.points[i];
+            const auto& b = road.points[i + 1];
+            double segMinZ = std::min(a.y, b.y) - static_cast<double>(halfWidth);
+            double segMaxZ = std::max(a.y, b.y) + static_cast<double>(halfWidth);
+            int sz0 = std::max(cellIndex(segMinZ - tileMinZ, false) - 1, z0);
+            int sz1 = std::min(cellIndex(segMaxZ - tileMinZ, true) + 1, z1);
+
+            for (int z = sz0; z <= sz1; ++z) {
                 float fz = (static_cast<float>(z) + 0.5f) / maskRes;
-                nuage::Vec2 p(tileMinX + fx * tileSize, tileMinZ + fz * tileSize);
-                bool hit = false;
-                for (size_t i = 0; i + 1 < road.points.size(); ++i) {
-                    float d = distancePointToSegment(p, road.points[i], road.points[i + 1]);
-                    if (d <= halfWidth) {
-                        hit = true;
-                        break;
-                    }
+                float worldZ = tileMinZ + fz * tileSize;
+                double spanMin = 0.0;
+                double spanMax = 0.0;
+                if (!capsuleRowSpan(a, b, halfWidth, worldZ, spanMin, spanMax)) {
+                    continue;
                 }
-                if (hit) {
+                int sx0 = std::max(cellIndex(spanMin - tileMinX, false) - 1, x0);
+                int sx1 = std::min(cellIndex(spanMax - tileMinX, true) + 1, x1);
+
+                for (int x = sx0; x <= sx1; ++x) {
+                    float fx = (static_cast<float>(x) + 0.5f) / maskRes;
+                    nuage::Vec2 p(tileMinX + fx * tileSize, worldZ);
+                    if (distancePointToSegment(p, a, b) > halfWidth) {
+                        continue;
+                    }
                     std::uint8_t& cell = mask[z * maskRes + x];
                     if (cell == 1) continue;
                     if (classPriority(7) >= classPriority(cell)) {
@@ -947,55 +1162,1043 @@ std::int64_t tileKey(int x, int y) {
     return (static_cast<std::int64_t>(x) << 32) ^ static_cast<std::uint32_t>(y);
 }
 
+struct ScanEdge {
+    float minZ = 0.0f;
+    float maxZ = 0.0f;
+    nuage::Vec2 a;
+    nuage::Vec2 b;
+};
+
+// Even-odd scanline fill. Crossings use the same expression as pointInPolygon
+// so the filled cells match the per-cell test exactly.
+void rasterizePolygonScanline(std::vector<std::uint8_t>& mask, int maskRes,
+                              float tileMinX, float tileMinZ, float tileSize,
+                              const Polygon& poly, std::vector<ScanEdge>& edges,
+                              std::vector<const ScanEdge*>& active, std::vector<float>& crossings) {
+    int x0 = static_cast<int>(std::floor((poly.minX - tileMinX) / tileSize * maskRes));
+    int x1 = static_cast<int>(std::ceil((poly.maxX - tileMinX) / tileSize * maskRes));
+    int z0 = static_cast<int>(std::floor((poly.minZ - tileMinZ) / tileSize * maskRes));
+    int z1 = static_cast<int>(std::ceil((poly.maxZ - tileMinZ) / tileSize * maskRes));
+    x0 = std::clamp(x0, 0, maskRes - 1);
+    x1 = std::clamp(x1, 0, maskRes - 1);
+    z0 = std::clamp(z0, 0, maskRes - 1);
+    z1 = std::clamp(z1, 0, maskRes - 1);
+
+    edges.clear();
+    size_t count = poly.ring.size();
+    for (size_t i = 0, j = count - 1; i < count; j = i++) {
+        const auto& a = poly.ring[i];
+        const auto& b = poly.ring[j];
+        if (a.y == b.y) {
+            continue;
+        }
+        edges.push_back({std::min(a.y, b.y), std::max(a.y, b.y), a, b});
+    }
+    std::sort(edges.begin(), edges.end(),
+        [](const ScanEdge& lhs, const ScanEdge& rhs) { return lhs.minZ < rhs.minZ; });
+
+    active.clear();
+    size_t nextEdge = 0;
+    std::uint8_t classId = static_cast<std::uint8_t>(poly.classId);
+    int priority = classPriority(poly.classId);
+    for (int z = z0; z <= z1; ++z) {
+        float fz = (static_cast<float>(z) + 0.5f) / maskRes;
+        float worldZ = tileMinZ + fz * tileSize;
+
+        // An edge crosses the row when minZ <= worldZ < maxZ.
+        while (nextEdge < edges.size() && edges[nextEdge].minZ <= worldZ) {
+            active.push_back(&edges[nextEdge]);
+            ++nextEdge;
+        }
+        active.erase(std::remove_if(active.begin(), active.end(),
+            [worldZ](const ScanEdge* edge) { return edge->maxZ <= worldZ; }), active.end());
+        if (active.empty()) {
+            continue;
+        }
+
+        crossings.clear();
+        for (const ScanEdge* edge : active) {
+            const auto& a = edge->a;
+            const auto& b = edge->b;
+            float cross = (b.x - a.x) * (worldZ - a.y) / (b.y - a.y + 1e-9f) + a.x;
+            if (!std::isnan(cross)) {
+                crossings.push_back(cross);
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        // A cell is inside when an odd number of crossings lie strictly to its right.
+        size_t passed = 0;
+        std::uint8_t* row = mask.data() + static_cast<size_t>(z) * maskRes;
+        for (int x = x0; x <= x1; ++x) {
+            float fx = (static_cast<float>(x) + 0.5f) / maskRes;
+            float worldX = tileMinX + fx * tileSize;
+            while (passed < crossings.size() && crossings[passed] <= worldX) {
+                ++passed;
+            }
+            if (passed == crossings.size()) {
+                break;
+            }
+            if (((crossings.size() - passed) & 1) == 0) {
+                continue;
+            }
+            std::uint8_t& cell = row[x];
+            if (poly.classId == 1 || priority >= classPriority(cell)) {
+                cell = classId;
+            }
+        }
+    }
+}
+
 void rasterizePolygonsToMaskList(std::vector<std::uint8_t>& mask, int maskRes,
                                  float tileMinX, float tileMinZ, float tileSize,
                                  const std::vector<Polygon>& polys,
                                  const std::vector<int>& indices) {
     if (maskRes <= 0 || indices.empty()) return;
+    std::vector<ScanEdge> edges;
+    std::vector<const ScanEdge*> active;
+    std::vector<float> crossings;
     for (int idx : indices) {
         const auto& poly = polys[static_cast<size_t>(idx)];
+        if (poly.ring.size() < 3) {
+            continue;
+        }
         if (poly.maxX <= tileMinX || poly.minX >= tileMinX + tileSize ||
             poly.maxZ <= tileMinZ || poly.minZ >= tileMinZ + tileSize) {
             continue;
         }
-        int x0 = static_cast<int>(std::floor((poly.minX - tileMinX) / tileSize * maskRes));
-        int x1 = static_cast<int>(std::ceil((poly.maxX - tileMinX) / tileSize * maskRes));
-        int z0 = static_cast<int>(std::floor((poly.minZ - tileMinZ) / tileSize * maskRes));
-        int z1 = static_cast<int>(std::ceil((poly.maxZ - tileMinZ) / tileSize * maskRes));
-        x0 = std::clamp(x0, 0, maskRes - 1);
-        x1 = std::clamp(x1, 0, maskRes - 1);
-        z0 = std::clamp(z0, 0, maskRes - 1);
-        z1 = std::clamp(z1, 0, maskRes - 1);
+        rasterizePolygonScanline(mask, maskRes, tileMinX, tileMinZ, tileSize, poly, edges, active, crossings);
+    }
+}
 
-        for (int z = z0; z <= z1; ++z) {
-            for (int x = x0; x <= x1; ++x) {
-                float fx = (static_cast<float>(x) + 0.5f) / maskRes;
-                float fz = (static_cast<float>(z) + 0.5f) / maskRes;
-                float worldX = tileMinX + fx * tileSize;
-                float worldZ = tileMinZ + fz * tileSize;
-                if (pointInPolygon(poly.ring, worldX, worldZ)) {
-                    std::uint8_t& cell = mask[z * maskRes + x];
-                    if (poly.classId == 1 || classPriority(poly.classId) >= classPriority(cell)) {
-                        cell = static_cast<std::uint8_t>(poly.classId);
-                    }
+// Bump when the tile format or compile logic changes so old fingerprints stop matching.
+constexpr std::uint32_t kTileFingerprintVersion = 1;
+
+// Scale from the height Laplacian (1/m) to the encoded curvature. Fixed, so a
+// hollow reads the same at every texel size and pyramid level; 2 m matches the
+// old per-texel encoding at 2 km tiles with 256 px maps.
+constexpr float kCurvatureScaleMeters = 2.0f;
+
+std::uint64_t computeConfigHash(const Config& cfg, const Heightmap& hm, const Projection& proj,
+                                const LandcoverRaster& landcover, const LandcoverRaster& landclass,
+                                const LandclassMap& landclassMap, bool useLandclass) {
+    TileFingerprint fp;
+    fp.add(kTileFingerprintVersion);
+    fp.add(cfg.sizeX);
+    fp.add(cfg.sizeZ);
+    fp.add(cfg.heightMin);
+    fp.add(cfg.heightMax);
+    fp.add(cfg.tileSize);
+    fp.add(cfg.gridResolution);
+    fp.add(cfg.maskResolution);
+    fp.add(cfg.maskSmooth);
+    fp.add(cfg.roadWidthBoost);
+    fp.add(cfg.roadSmooth);
+    fp.add(cfg.runwayBlendMeters);
+    fp.add(hm.width);
+    fp.add(hm.height);
+    fp.add(hm.metric);
+    fp.add(static_cast<std::uint32_t>(hm.raster.sampleType()));
+    fp.add(proj.lon0);
+    fp.add(proj.lat0);
+    fp.add(proj.metersPerLon);
+    fp.add(proj.metersPerLat);
+    fp.add(useLandclass);
+    if (cfg.maxError > 0.0f) {
+        fp.add(cfg.maxError);
+    }
+    if (cfg.normalMapResolution > 0) {
+        fp.add(cfg.normalMapResolution);
+        fp.add(kCurvatureScaleMeters);
+    }
+    for (const auto* lc : {&landcover, &landclass}) {
+        fp.add(lc->valid);
+        fp.add(lc->width);
+        fp.add(lc->height);
+        fp.add(lc->geo.originX);
+        fp.add(lc->geo.pixelW);
+        fp.add(lc->geo.originY);
+        fp.add(lc->geo.pixelH);
+    }
+    fp.add(landclassMap.enabled);
+    fp.add(landclassMap.defaultValue);
+    std::vector<std::pair<int, int>> mapping(landclassMap.values.begin(), landclassMap.values.end());
+    std::sort(mapping.begin(), mapping.end());
+    for (const auto& entry : mapping) {
+        fp.add(entry.first);
+        fp.add(entry.second);
+    }
+    return fp.value();
+}
+
+// Totals gathered across worker threads for the end-of-run summary.
+struct CompileStats {
+    std::atomic<std::int64_t> polygonNanos{0};
+    std::atomic<std::int64_t> polygonPasses{0};
+    std::atomic<std::int64_t> polygonTiles{0};
+    std::atomic<std::int64_t> roadNanos{0};
+    std::atomic<std::int64_t> roadPasses{0};
+    std::atomic<std::int64_t> roadTiles{0};
+    std::atomic<std::int64_t> tilesRebuilt{0};
+    std::atomic<std::int64_t> tilesReused{0};
+    std::atomic<std::int64_t> adaptiveTriangles{0};
+    std::atomic<std::int64_t> gridTriangles{0};
+    // Only filled with --profile.
+    std::mutex profileMutex;
+    std::vector<TileProfile> profiles;
+    std::atomic<int> profileThreads{1};
+};
+
+std::int64_t elapsedNanos(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// One tile of the output pyramid. Level 0 uses absolute tile coordinates;
+// coarser levels count from the pyramid origin and span 2^level base tiles.
+struct TileSpec {
+    int level = 0;
+    int x = 0;
+    int y = 0;
+    float minX = 0.0f;
+    float minZ = 0.0f;
+    float size = 0.0f;
+};
+
+// Box-filtered DEM in meters: mip m averages 2^m x 2^m DEM pixels, so coarse
+// tiles sample heights at about their own spacing instead of aliasing.
+struct HeightMip {
+    int width = 0;
+    int height = 0;
+    std::vector<float> heights;
+};
+
+struct TileContext {
+    const Config& cfg;
+    const Heightmap& hm;
+    const std::filesystem::path& tilesDir;
+    float minX;
+    float minZ;
+    float heightRange;
+    const std::vector<Runway>& runways;
+    const std::unordered_map<std::int64_t, std::vector<int>>& runwayBuckets;
+    const Projection& proj;
+    const LandcoverRaster& landcover;
+    const LandcoverRaster& landclass;
+    const LandclassMap& landclassMap;
+    bool useLandclass;
+    const std::vector<Polygon>& allPolys;
+    const std::unordered_map<std::int64_t, std::vector<int>>& polyBuckets;
+    const std::vector<Road>& roadLines;
+    const std::unordered_map<std::int64_t, std::vector<int>>& roadBuckets;
+    std::uint64_t configHash;
+    CompileStats& stats;
+    // Pyramid origin in base tile coordinates and the tile keys present per level.
+    int lodOriginX = 0;
+    int lodOriginZ = 0;
+    std::vector<std::unordered_set<std::int64_t>> levelTiles{};
+    // heightMips[m - 1] is mip m; mip 0 is the DEM itself.
+    std::vector<HeightMip> heightMips{};
+};
+
+// Per-worker buffers reused across tiles to avoid reallocating every tile.
+struct TileScratch {
+    std::vector<nuage::Vec3> positions;
+    std::vector<nuage::Vec3> normals;
+    std::vector<float> verts;
+    std::vector<std::uint8_t> mask;
+    std::vector<std::uint8_t> childMask;
+    std::vector<Runway> runways;
+    std::vector<int> runwayIndices;
+    std::vector<float> heights;
+    std::vector<float> errors;
+    std::vector<std::uint32_t> triangles;
+    std::vector<std::uint32_t> indices;
+    std::vector<std::int32_t> remap;
+    std::vector<float> normalHeights;
+    std::vector<float> sampleX;
+    std::vector<float> sampleHeights;
+    std::vector<std::uint8_t> normalMap;
+};
+
+TileSpec baseTileSpec(const Config& cfg, int tx, int ty) {
+    TileSpec spec;
+    spec.x = tx;
+    spec.y = ty;
+    spec.minX = static_cast<float>(tx) * cfg.tileSize;
+    spec.minZ = static_cast<float>(ty) * cfg.tileSize;
+    spec.size = cfg.tileSize;
+    return spec;
+}
+
+TileSpec lodTileSpec(const TileContext& ctx, int level, int x, int y) {
+    if (level == 0) {
+        return baseTileSpec(ctx.cfg, ctx.lodOriginX + x, ctx.lodOriginZ + y);
+    }
+    int span = 1 << level;
+    TileSpec spec;
+    spec.level = level;
+    spec.x = x;
+    spec.y = y;
+    spec.minX = static_cast<float>(ctx.lodOriginX + x * span) * ctx.cfg.tileSize;
+    spec.minZ = static_cast<float>(ctx.lodOriginZ + y * span) * ctx.cfg.tileSize;
+    spec.size = ctx.cfg.tileSize * static_cast<float>(span);
+    return spec;
+}
+
+// Quadrant (dx, dy) of a coarse tile, one level down.
+TileSpec childTileSpec(const TileContext& ctx, const TileSpec& parent, int dx, int dy) {
+    return lodTileSpec(ctx, parent.level - 1, parent.x * 2 + dx, parent.y * 2 + dy);
+}
+
+float demPixelMeters(const TileContext& ctx) {
+    return std::min(ctx.cfg.sizeX / static_cast<float>(std::max(1, ctx.hm.width - 1)),
+                    ctx.cfg.sizeZ / static_cast<float>(std::max(1, ctx.hm.height - 1)));
+}
+
+// Coarsest mip whose pixels are no larger than spacing meters. Base tiles
+// always read the DEM directly.
+int heightMipFor(const TileContext& ctx, const TileSpec& spec, float spacing) {
+    if (spec.level == 0) {
+        return 0;
+    }
+    float ratio = spacing / std::max(demPixelMeters(ctx), 1e-3f);
+    int mip = ratio >= 2.0f ? static_cast<int>(std::floor(std::log2(ratio))) : 0;
+    return std::min(mip, static_cast<int>(ctx.heightMips.size()));
+}
+
+// Builds mips 1..count, each a 2x2 average of the one below; odd edges
+// average the last pixel with itself.
+void buildHeightMips(TileContext& ctx, int count) {
+    const Heightmap& hm = ctx.hm;
+    ctx.heightMips.clear();
+    std::vector<float> xs(static_cast<size_t>(hm.width));
+    for (int x = 0; x < hm.width; ++x) {
+        xs[static_cast<size_t>(x)] = static_cast<float>(x);
+    }
+    std::vector<float> row0(xs.size());
+    std::vector<float> row1(xs.size());
+    for (int mip = 1; mip <= count; ++mip) {
+        int srcW = mip == 1 ? hm.width : ctx.heightMips.back().width;
+        int srcH = mip == 1 ? hm.height : ctx.heightMips.back().height;
+        if (srcW <= 1 && srcH <= 1) {
+            break;
+        }
+        HeightMip out;
+        out.width = (srcW + 1) / 2;
+        out.height = (srcH + 1) / 2;
+        out.heights.resize(static_cast<size_t>(out.width) * static_cast<size_t>(out.height));
+        for (int z = 0; z < out.height; ++z) {
+            int z0 = 2 * z;
+            int z1 = std::min(z0 + 1, srcH - 1);
+            const float* a = nullptr;
+            const float* b = nullptr;
+            if (mip == 1) {
+                sampleHeightMetersRow(hm, xs.data(), static_cast<float>(z0), xs.size(),
+                                      ctx.cfg.heightMin, ctx.heightRange, row0.data());
+                sampleHeightMetersRow(hm, xs.data(), static_cast<float>(z1), xs.size(),
+                                      ctx.cfg.heightMin, ctx.heightRange, row1.data());
+                a = row0.data();
+                b = row1.data();
+            } else {
+                const HeightMip& src = ctx.heightMips.back();
+                a = &src.heights[static_cast<size_t>(z0) * static_cast<size_t>(srcW)];
+                b = &src.heights[static_cast<size_t>(z1) * static_cast<size_t>(srcW)];
+            }
+            float* dst = &out.heights[static_cast<size_t>(z) * static_cast<size_t>(out.width)];
+            for (int x = 0; x < out.width; ++x) {
+                int x0 = 2 * x;
+                int x1 = std::min(x0 + 1, srcW - 1);
+                dst[x] = 0.25f * (a[x0] + a[x1] + b[x0] + b[x1]);
+            }
+        }
+        ctx.heightMips.push_back(std::move(out));
+    }
+}
+
+// sampleHeightMetersRow at DEM pixel coordinates, read from mip `mip`.
+void sampleTileHeightsRow(const TileContext& ctx, int mip, const float* xs, float hz, size_t count,
+                          float* out) {
+    if (mip == 0) {
+        sampleHeightMetersRow(ctx.hm, xs, hz, count, ctx.cfg.heightMin, ctx.heightRange, out);
+        return;
+    }
+    const HeightMip& level = ctx.heightMips[static_cast<size_t>(mip - 1)];
+    // Mip pixel i averages DEM pixels i*scale .. (i+1)*scale-1.
+    float scale = static_cast<float>(1 << mip);
+    float offset = 0.5f * (scale - 1.0f);
+    float fz = std::clamp((hz - offset) / scale, 0.0f, static_cast<float>(level.height - 1));
+    int z0 = static_cast<int>(fz);
+    int z1 = std::min(z0 + 1, level.height - 1);
+    float tz = fz - static_cast<float>(z0);
+    const float* r0 = &level.heights[static_cast<size_t>(z0) * static_cast<size_t>(level.width)];
+    const float* r1 = &level.heights[static_cast<size_t>(z1) * static_cast<size_t>(level.width)];
+    for (size_t i = 0; i < count; ++i) {
+        float fx = std::clamp((xs[i] - offset) / scale, 0.0f, static_cast<float>(level.width - 1));
+        int x0 = static_cast<int>(fx);
+        int x1 = std::min(x0 + 1, level.width - 1);
+        float tx = fx - static_cast<float>(x0);
+        float top = r0[x0] + (r0[x1] - r0[x0]) * tx;
+        float bottom = r1[x0] + (r1[x1] - r1[x0]) * tx;
+        out[i] = top + (bottom - top) * tz;
+    }
+}
+
+bool tileExists(const TileContext& ctx, const TileSpec& spec) {
+    const auto& tiles = ctx.levelTiles[static_cast<size_t>(spec.level)];
+    return tiles.count(tileKey(spec.x, spec.y)) != 0;
+}
+
+std::filesystem::path levelDir(const TileContext& ctx, int level) {
+    return level == 0 ? ctx.tilesDir : ctx.tilesDir / ("lod" + std::to_string(level));
+}
+
+std::filesystem::path tilePath(const TileContext& ctx, const TileSpec& spec, const char* extension) {
+    return levelDir(ctx, spec.level) /
+        ("tile_" + std::to_string(spec.x) + "_" + std::to_string(spec.y) + extension);
+}
+
+// Runways whose flatten footprint reaches the tile, in ascending order so ties
+// resolve the same way as a scan over every runway. Coarse tiles take the union
+// of the base buckets they cover.
+void collectTileRunways(const TileContext& ctx, const TileSpec& spec, std::vector<int>& out) {
+    out.clear();
+    int span = 1 << spec.level;
+    int baseX = spec.level == 0 ? spec.x : ctx.lodOriginX + spec.x * span;
+    int baseZ = spec.level == 0 ? spec.y : ctx.lodOriginZ + spec.y * span;
+    for (int ty = baseZ; ty < baseZ + span; ++ty) {
+        for (int tx = baseX; tx < baseX + span; ++tx) {
+            auto it = ctx.runwayBuckets.find(tileKey(tx, ty));
+            if (it != ctx.runwayBuckets.end()) {
+                out.insert(out.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+    if (spec.level > 0) {
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}
+
+std::mutex& logMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+void reportTileError(const char* message, const std::filesystem::path& path) {
+    std::lock_guard<std::mutex> lock(logMutex());
+    std::cerr << message << path << "\n";
+}
+
+bool tileWritesMask(const TileContext& ctx) {
+    return ctx.cfg.maskResolution > 0 &&
+        (ctx.useLandclass || ctx.landcover.valid || !ctx.allPolys.empty());
+}
+
+// Pixel window of a georeferenced raster covering a tile, padded by two pixels
+// so nearest-pixel lookups at the tile edge are included.
+void addLandcoverWindow(TileFingerprint& fp, const TileContext& ctx, const LandcoverRaster& lc,
+                        float tileMinX, float tileMinZ, float tileSize) {
+    if (!lc.valid) {
+        return;
+    }
+    double lon0 = 0.0;
+    double lat0 = 0.0;
+    double lon1 = 0.0;
+    double lat1 = 0.0;
+    unprojectToLonLat(ctx.proj, tileMinX, tileMinZ, lon0, lat0);
+    unprojectToLonLat(ctx.proj, tileMinX + tileSize, tileMinZ + tileSize, lon1, lat1);
+    double px0 = (lon0 - lc.geo.originX) / lc.geo.pixelW;
+    double px1 = (lon1 - lc.geo.originX) / lc.geo.pixelW;
+    double py0 = (lat0 - lc.geo.originY) / lc.geo.pixelH;
+    double py1 = (lat1 - lc.geo.originY) / lc.geo.pixelH;
+    auto toPixel = [](double v) {
+        return static_cast<int>(std::clamp(v, -4.0, static_cast<double>(std::numeric_limits<int>::max() / 2)));
+    };
+    fp.addRasterWindow(lc.raster,
+                       toPixel(std::floor(std::min(px0, px1))) - 2, toPixel(std::floor(std::min(py0, py1))) - 2,
+                       toPixel(std::ceil(std::max(px0, px1))) + 2, toPixel(std::ceil(std::max(py0, py1))) + 2);
+}
+
+// Hash of every input that can change this tile's mesh, meta or mask:
+// the DEM window under the grid, nearby runways, and the mask sources.
+// Coarse masks are built from the level below, so they hash its fingerprints.
+TileFingerprint tileFingerprint(const TileContext& ctx, const TileSpec& spec,
+                                const std::vector<int>& runwayIndices) {
+    const Config& cfg = ctx.cfg;
+    TileFingerprint fp(ctx.configHash);
+    if (spec.level > 0) {
+        fp.add(spec.level);
+    }
+    fp.add(spec.x);
+    fp.add(spec.y);
+    int tx = spec.x;
+    int ty = spec.y;
+
+    float tileMinX = spec.minX;
+    float tileMinZ = spec.minZ;
+    float tileMaxX = tileMinX + spec.size;
+    float tileMaxZ = tileMinZ + spec.size;
+    float hx0 = clamp01((tileMinX - ctx.minX) / cfg.sizeX) * static_cast<float>(ctx.hm.width - 1);
+    float hx1 = clamp01((tileMaxX - ctx.minX) / cfg.sizeX) * static_cast<float>(ctx.hm.width - 1);
+    float hz0 = clamp01((tileMinZ - ctx.minZ) / cfg.sizeZ) * static_cast<float>(ctx.hm.height - 1);
+    float hz1 = clamp01((tileMaxZ - ctx.minZ) / cfg.sizeZ) * static_cast<float>(ctx.hm.height - 1);
+    // Normal maps sample a texel and a half beyond the tile edge, and a mip
+    // pixel reaches up to its own width past the point sampled.
+    int pad = 1;
+    int meshMip = heightMipFor(ctx, spec, spec.size / static_cast<float>(cfg.gridResolution));
+    pad += (1 << meshMip) - 1;
+    if (meshMip > 0) {
+        fp.add(meshMip);
+    }
+    if (cfg.normalMapResolution > 0) {
+        float texel = spec.size / static_cast<float>(cfg.normalMapResolution);
+        int normalMip = heightMipFor(ctx, spec, texel);
+        pad = std::max(pad, 1 + static_cast<int>(std::ceil(1.5f * texel / std::max(demPixelMeters(ctx), 1e-3f))) +
+                                (1 << normalMip) - 1);
+        if (normalMip > 0) {
+            fp.add(normalMip);
+        }
+    }
+    fp.addRasterWindow(ctx.hm.raster,
+                       static_cast<int>(std::floor(hx0)) - pad, static_cast<int>(std::floor(hz0)) - pad,
+                       static_cast<int>(std::ceil(hx1)) + pad, static_cast<int>(std::ceil(hz1)) + pad);
+
+    for (int idx : runwayIndices) {
+        const auto& runway = ctx.runways[static_cast<size_t>(idx)];
+        for (const auto* v : {&runway.center, &runway.dir, &runway.perp}) {
+            fp.add(v->x);
+            fp.add(v->y);
+            fp.add(v->z);
+        }
+        fp.add(runway.halfLength);
+        fp.add(runway.halfWidth);
+        fp.add(runway.h0);
+        fp.add(runway.h1);
+    }
+
+    if (!tileWritesMask(ctx)) {
+        return fp;
+    }
+    if (spec.level > 0) {
+        for (int dy = 0; dy < 2; ++dy) {
+            for (int dx = 0; dx < 2; ++dx) {
+                TileSpec child = childTileSpec(ctx, spec, dx, dy);
+                std::string childFingerprint;
+                if (tileExists(ctx, child)) {
+                    readTileFingerprint(tilePath(ctx, child, ".fingerprint"), childFingerprint);
+                }
+                fp.addString(childFingerprint);
+            }
+        }
+        return fp;
+    }
+    if (ctx.useLandclass) {
+        addLandcoverWindow(fp, ctx, ctx.landclass, tileMinX, tileMinZ, spec.size);
+        return fp;
+    }
+    addLandcoverWindow(fp, ctx, ctx.landcover, tileMinX, tileMinZ, spec.size);
+    auto polyIt = ctx.polyBuckets.find(tileKey(tx, ty));
+    if (polyIt != ctx.polyBuckets.end()) {
+        for (int idx : polyIt->second) {
+            const auto& poly = ctx.allPolys[static_cast<size_t>(idx)];
+            fp.add(poly.classId);
+            fp.add(static_cast<std::uint64_t>(poly.ring.size()));
+            for (const auto& p : poly.ring) {
+                fp.add(p.x);
+                fp.add(p.y);
+            }
+        }
+    }
+    auto roadIt = ctx.roadBuckets.find(tileKey(tx, ty));
+    if (roadIt != ctx.roadBuckets.end()) {
+        for (int idx : roadIt->second) {
+            const auto& road = ctx.roadLines[static_cast<size_t>(idx)];
+            fp.add(road.valid);
+            fp.add(road.halfWidth);
+            fp.add(static_cast<std::uint64_t>(road.points.size()));
+            for (const auto& p : road.points) {
+                fp.add(p.x);
+                fp.add(p.y);
+            }
+        }
+    }
+    return fp;
+}
+
+bool readChildMask(const std::filesystem::path& path, std::vector<std::uint8_t>& out, size_t expected) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    out.resize(expected);
+    in.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(expected));
+    return in.gcount() == static_cast<std::streamsize>(expected);
+}
+
+// Coarse masks come from the four tiles one level down: each pixel takes the
+// most common class of the 2x2 child pixels under it, ties going to the
+// higher-priority class. Missing children leave their quadrant empty.
+bool downsampleChildMasks(const TileContext& ctx, const TileSpec& spec, TileScratch& scratch) {
+    int res = ctx.cfg.maskResolution;
+    size_t childSize = static_cast<size_t>(res * res);
+    int fineRes = res * 2;
+    auto& fine = scratch.childMask;
+    fine.assign(childSize * 4, 0);
+    std::vector<std::uint8_t> child;
+    for (int dy = 0; dy < 2; ++dy) {
+        for (int dx = 0; dx < 2; ++dx) {
+            TileSpec childSpec = childTileSpec(ctx, spec, dx, dy);
+            if (!tileExists(ctx, childSpec)) {
+                continue;
+            }
+            std::filesystem::path childPath = tilePath(ctx, childSpec, ".mask");
+            if (!readChildMask(childPath, child, childSize)) {
+                reportTileError("Failed to read child mask: ", childPath);
+                return false;
+            }
+            for (int z = 0; z < res; ++z) {
+                std::copy_n(child.begin() + z * res, res,
+                            fine.begin() + (dy * res + z) * fineRes + dx * res);
+            }
+        }
+    }
+
+    auto& mask = scratch.mask;
+    mask.assign(childSize, 0);
+    for (int z = 0; z < res; ++z) {
+        const std::uint8_t* row0 = fine.data() + (z * 2) * fineRes;
+        const std::uint8_t* row1 = row0 + fineRes;
+        for (int x = 0; x < res; ++x) {
+            std::uint8_t samples[4] = {row0[x * 2], row0[x * 2 + 1], row1[x * 2], row1[x * 2 + 1]};
+            std::uint8_t best = samples[0];
+            int bestCount = 0;
+            for (int i = 0; i < 4; ++i) {
+                int count = 0;
+                for (int j = 0; j < 4; ++j) {
+                    count += samples[j] == samples[i] ? 1 : 0;
                 }
+                if (count > bestCount ||
+                    (count == bestCount && classPriority(samples[i]) > classPriority(best))) {
+                    best = samples[i];
+                    bestCount = count;
+                }
+            }
+            mask[z * res + x] = best;
+        }
+    }
+    return true;
+}
+
+// Normal map baked from the DEM at texel spacing instead of the mesh grid, so
+// shading keeps its relief when the grid is coarse. RGB holds the unit normal
+// (xyz * 0.5 + 0.5); A holds signed curvature, the height Laplacian times
+// kCurvatureScaleMeters, clamped to [-1, 1] (128 = flat, higher = hollow).
+void bakeNormalMap(const TileContext& ctx, const TileSpec& spec, const std::vector<Runway>& runways,
+                   TileScratch& scratch) {
+    const Config& cfg = ctx.cfg;
+    int res = cfg.normalMapResolution;
+    int haloRes = res + 2;
+    float texel = spec.size / static_cast<float>(res);
+    auto& heights = scratch.normalHeights;
+    auto& sampleX = scratch.sampleX;
+    int mip = heightMipFor(ctx, spec, texel);
+    heights.resize(static_cast<size_t>(haloRes * haloRes));
+    sampleX.resize(static_cast<size_t>(haloRes));
+    for (int x = 0; x < haloRes; ++x) {
+        float worldX = spec.minX + (static_cast<float>(x - 1) + 0.5f) * texel;
+        sampleX[static_cast<size_t>(x)] = clamp01((worldX - ctx.minX) / cfg.sizeX) * static_cast<float>(ctx.hm.width - 1);
+    }
+    for (int z = 0; z < haloRes; ++z) {
+        float worldZ = spec.minZ + (static_cast<float>(z - 1) + 0.5f) * texel;
+        float hz = clamp01((worldZ - ctx.minZ) / cfg.sizeZ) * static_cast<float>(ctx.hm.height - 1);
+        float* row = &heights[static_cast<size_t>(z * haloRes)];
+        sampleTileHeightsRow(ctx, mip, sampleX.data(), hz, sampleX.size(), row);
+        if (!runways.empty()) {
+            for (int x = 0; x < haloRes; ++x) {
+                float worldX = spec.minX + (static_cast<float>(x - 1) + 0.5f) * texel;
+                row[x] = applyRunwayFlatten(worldX, worldZ, row[x], runways, cfg.runwayBlendMeters);
             }
         }
     }
+
+    auto& out = scratch.normalMap;
+    out.resize(static_cast<size_t>(res * res * 4));
+    auto encode = [](float v) {
+        return static_cast<std::uint8_t>(std::lround(std::clamp(v * 0.5f + 0.5f, 0.0f, 1.0f) * 255.0f));
+    };
+    for (int z = 0; z < res; ++z) {
+        for (int x = 0; x < res; ++x) {
+            size_t center = static_cast<size_t>((z + 1) * haloRes + (x + 1));
+            float h = heights[center];
+            float left = heights[center - 1];
+            float right = heights[center + 1];
+            float up = heights[center - static_cast<size_t>(haloRes)];
+            float down = heights[center + static_cast<size_t>(haloRes)];
+            nuage::Vec3 normal = nuage::Vec3(left - right, 2.0f * texel, up - down).normalized();
+            float laplacian = (left + right + up + down - 4.0f * h) / (texel * texel);
+            float curvature = laplacian * kCurvatureScaleMeters;
+            std::uint8_t* px = &out[static_cast<size_t>(z * res + x) * 4];
+            px[0] = encode(normal.x);
+            px[1] = encode(normal.y);
+            px[2] = encode(normal.z);
+            px[3] = encode(curvature);
+        }
+    }
+}
+
+std::uint64_t tileBytesWritten(std::initializer_list<const std::filesystem::path*> paths) {
+    std::uint64_t bytes = 0;
+    for (const auto* path : paths) {
+        std::error_code ec;
+        std::uintmax_t size = std::filesystem::file_size(*path, ec);
+        bytes += ec ? 0 : static_cast<std::uint64_t>(size);
+    }
+    return bytes;
+}
+
+// profile, when set, receives the time spent in each stage of this tile.
+bool compileTile(const TileContext& ctx, const TileSpec& spec, TileScratch& scratch, TileProfile* profile) {
+    const Config& cfg = ctx.cfg;
+    StageClock clock(profile);
+    int tx = spec.x;
+    int ty = spec.y;
+    float tileMinX = spec.minX;
+    float tileMinZ = spec.minZ;
+
+    std::filesystem::path meshPath = tilePath(ctx, spec, ".mesh");
+    std::filesystem::path metaPath = tilePath(ctx, spec, ".meta.json");
+    std::filesystem::path maskPath = tilePath(ctx, spec, ".mask");
+    std::filesystem::path fingerprintPath = tilePath(ctx, spec, ".fingerprint");
+    std::filesystem::path normalPath = tilePath(ctx, spec, ".nrm");
+    bool writesMask = tileWritesMask(ctx);
+    bool writesNormals = cfg.normalMapResolution > 0;
+
+    collectTileRunways(ctx, spec, scratch.runwayIndices);
+    std::string fingerprint = tileFingerprint(ctx, spec, scratch.runwayIndices).hex();
+    if (!cfg.force) {
+        std::string previous;
+        std::error_code ec;
+        if (readTileFingerprint(fingerprintPath, previous) && previous == fingerprint &&
+            std::filesystem::exists(meshPath, ec) && std::filesystem::exists(metaPath, ec) &&
+            (!writesMask || std::filesystem::exists(maskPath, ec)) &&
+            (!writesNormals || std::filesystem::exists(normalPath, ec))) {
+            ctx.stats.tilesReused += 1;
+            if (profile) {
+                profile->reused = true;
+                clock.mark(TileStage::Fingerprint);
+                clock.finish();
+            }
+            return true;
+        }
+    }
+    // Drop the old fingerprint first so an interrupted rewrite is never reused.
+    std::error_code removeError;
+    std::filesystem::remove(fingerprintPath, removeError);
+    clock.mark(TileStage::Fingerprint);
+
+    int cells = cfg.gridResolution;
+    int resX = cells + 1;
+    int resZ = cells + 1;
+
+    auto& positions = scratch.positions;
+    auto& normals = scratch.normals;
+    auto& verts = scratch.verts;
+    positions.resize(static_cast<size_t>(resX * resZ));
+    normals.assign(static_cast<size_t>(resX * resZ), nuage::Vec3(0, 1, 0));
+    verts.clear();
+    int stride = 9;
+    verts.reserve(static_cast<size_t>((resX - 1) * (resZ - 1) * 6 * stride));
+
+    // Only runways whose blend footprint reaches this tile.
+    auto& tileRunways = scratch.runways;
+    tileRunways.clear();
+    for (int idx : scratch.runwayIndices) {
+        tileRunways.push_back(ctx.runways[static_cast<size_t>(idx)]);
+    }
+
+    float localMinH = std::numeric_limits<float>::max();
+    float localMaxH = std::numeric_limits<float>::lowest();
+
+    auto& sampleX = scratch.sampleX;
+    auto& sampleHeights = scratch.sampleHeights;
+    int mip = heightMipFor(ctx, spec, spec.size / static_cast<float>(cells));
+    sampleX.resize(static_cast<size_t>(resX));
+    sampleHeights.resize(static_cast<size_t>(resX));
+    for (int x = 0; x < resX; ++x) {
+        float fx = (resX > 1) ? static_cast<float>(x) / (resX - 1) : 0.0f;
+        float u = clamp01((tileMinX + fx * spec.size - ctx.minX) / cfg.sizeX);
+        sampleX[static_cast<size_t>(x)] = u * static_cast<float>(ctx.hm.width - 1);
+    }
+
+    for (int z = 0; z < resZ; ++z) {
+        float fz = (resZ > 1) ? static_cast<float>(z) / (resZ - 1) : 0.0f;
+        float worldZ = tileMinZ + fz * spec.size;
+        float v = clamp01((worldZ - ctx.minZ) / cfg.sizeZ);
+        float hz = v * static_cast<float>(ctx.hm.height - 1);
+        sampleTileHeightsRow(ctx, mip, sampleX.data(), hz, sampleX.size(), sampleHeights.data());
+
+        if (!tileRunways.empty()) {
+            clock.mark(TileStage::Heights);
+            for (int x = 0; x < resX; ++x) {
+                float fx = (resX > 1) ? static_cast<float>(x) / (resX - 1) : 0.0f;
+                float worldX = tileMinX + fx * spec.size;
+                float& height = sampleHeights[static_cast<size_t>(x)];
+                height = applyRunwayFlatten(worldX, worldZ, height, tileRunways, cfg.runwayBlendMeters);
+            }
+            clock.mark(TileStage::Runways);
+        }
+
+        for (int x = 0; x < resX; ++x) {
+            float fx = (resX > 1) ? static_cast<float>(x) / (resX - 1) : 0.0f;
+            float worldX = tileMinX + fx * spec.size;
+            float height = sampleHeights[static_cast<size_t>(x)];
+
+            localMinH = std::min(localMinH, height);
+            localMaxH = std::max(localMaxH, height);
+
+            int idx = z * resX + x;
+            positions[idx] = nuage::Vec3(worldX, height, worldZ);
+        }
+    }
+    clock.mark(TileStage::Heights);
+
+    static_assert(sizeof(nuage::Vec3) == 3 * sizeof(float), "grid kernels read Vec3 arrays as packed floats");
+    nuage::gridNormals(&positions[0].x, resX, resZ, &normals[0].x);
+    clock.mark(TileStage::Normals);
+
+    auto appendVertex = [&](int idx) {
+        const auto& pos = positions[idx];
+        const auto& normal = normals[idx];
+        float t = (pos.y - cfg.heightMin) / ctx.heightRange;
+        nuage::Vec3 color = heightColor(t);
+        verts.insert(verts.end(), {
+            pos.x, pos.y, pos.z,
+            normal.x, normal.y, normal.z,
+            color.x, color.y, color.z
+        });
+    };
+
+    if (cfg.maxError > 0.0f) {
+        // Adaptive mesh: only the grid vertices the RTIN keeps, with normals
+        // still taken from the full grid so shading detail is preserved.
+        auto& heights = scratch.heights;
+        heights.resize(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            heights[i] = positions[i].y;
+        }
+        computeRtinErrors(heights, resX, scratch.errors);
+        auto& triangles = scratch.triangles;
+        triangles.clear();
+        extractRtinTriangles(scratch.errors, resX, cfg.maxError, triangles);
+
+        auto& remap = scratch.remap;
+        auto& indices = scratch.indices;
+        remap.assign(positions.size(), -1);
+        indices.clear();
+        indices.reserve(triangles.size());
+        std::uint32_t vertexCount = 0;
+        for (std::uint32_t gridIndex : triangles) {
+            if (remap[gridIndex] < 0) {
+                remap[gridIndex] = static_cast<std::int32_t>(vertexCount++);
+                appendVertex(static_cast<int>(gridIndex));
+            }
+            indices.push_back(static_cast<std::uint32_t>(remap[gridIndex]));
+        }
+        ctx.stats.adaptiveTriangles += static_cast<std::int64_t>(indices.size() / 3);
+        ctx.stats.gridTriangles += static_cast<std::int64_t>((resX - 1) * (resZ - 1) * 2);
+        clock.mark(TileStage::Mesh);
+
+        if (!writeIndexedMesh(meshPath, verts, indices)) {
+            reportTileError("Failed to write mesh: ", meshPath);
+            return false;
+        }
+    } else {
+        for (int z = 0; z < resZ - 1; ++z) {
+            for (int x = 0; x < resX - 1; ++x) {
+                int i00 = z * resX + x;
+                int i10 = i00 + 1;
+                int i01 = i00 + resX;
+                int i11 = i01 + 1;
+
+                appendVertex(i00);
+                appendVertex(i10);
+                appendVertex(i11);
+
+                appendVertex(i00);
+                appendVertex(i11);
+                appendVertex(i01);
+            }
+        }
+        clock.mark(TileStage::Mesh);
+
+        if (!writeMesh(meshPath, verts)) {
+            reportTileError("Failed to write mesh: ", meshPath);
+            return false;
+        }
+    }
+
+    writeTileMeta(metaPath, spec.level, tx, ty, localMinH, localMaxH, cfg.gridResolution);
+    clock.mark(TileStage::Write);
+
+    if (writesNormals) {
+        bakeNormalMap(ctx, spec, tileRunways, scratch);
+        clock.mark(TileStage::NormalMap);
+        if (!writeMask(normalPath, scratch.normalMap)) {
+            reportTileError("Failed to write normal map: ", normalPath);
+            return false;
+        }
+        clock.mark(TileStage::Write);
+    }
+
+    if (writesMask) {
+        auto& mask = scratch.mask;
+        mask.assign(static_cast<size_t>(cfg.maskResolution * cfg.maskResolution), 0);
+        if (spec.level > 0) {
+            if (!downsampleChildMasks(ctx, spec, scratch)) {
+                return false;
+            }
+        } else if (ctx.useLandclass) {
+            fillMaskFromLandclass(mask, cfg.maskResolution, tileMinX, tileMinZ,
+                                  cfg.tileSize, ctx.proj, ctx.landclass, ctx.landclassMap.enabled ? &ctx.landclassMap : nullptr);
+        } else {
+            if (ctx.landcover.valid) {
+                fillMaskFromLandcover(mask, cfg.maskResolution, tileMinX, tileMinZ,
+                                      cfg.tileSize, ctx.proj, ctx.landcover);
+            }
+            clock.mark(TileStage::MaskFill);
+            auto bucketIt = ctx.polyBuckets.find(tileKey(tx, ty));
+            if (bucketIt != ctx.polyBuckets.end()) {
+                auto polyStart = std::chrono::steady_clock::now();
+                rasterizePolygonsToMaskList(mask, cfg.maskResolution, tileMinX, tileMinZ,
+                                            cfg.tileSize, ctx.allPolys, bucketIt->second);
+                ctx.stats.polygonNanos += elapsedNanos(polyStart);
+                ctx.stats.polygonPasses += static_cast<std::int64_t>(bucketIt->second.size());
+                ctx.stats.polygonTiles += 1;
+                clock.mark(TileStage::Polygons);
+            }
+            if (cfg.maskSmooth > 0) {
+                smoothMask(mask, cfg.maskResolution, cfg.maskSmooth);
+                clock.mark(TileStage::Smoothing);
+            }
+            auto roadIt = ctx.roadBuckets.find(tileKey(tx, ty));
+            if (roadIt != ctx.roadBuckets.end()) {
+                auto roadStart = std::chrono::steady_clock::now();
+                rasterizeRoadsToMaskList(mask, cfg.maskResolution, tileMinX, tileMinZ,
+                                         cfg.tileSize, ctx.roadLines, roadIt->second, cfg.roadWidthBoost);
+                ctx.stats.roadNanos += elapsedNanos(roadStart);
+                ctx.stats.roadPasses += static_cast<std::int64_t>(roadIt->second.size());
+                ctx.stats.roadTiles += 1;
+                clock.mark(TileStage::Roads);
+            }
+            if (cfg.roadSmooth > 0) {
+                smoothMask(mask, cfg.maskResolution, cfg.roadSmooth);
+                clock.mark(TileStage::Smoothing);
+            }
+        }
+        clock.mark(TileStage::MaskFill);
+
+        if (!writeMask(maskPath, mask)) {
+            reportTileError("Failed to write mask: ", maskPath);
+            return false;
+        }
+    }
+
+    if (!writeTileFingerprint(fingerprintPath, fingerprint)) {
+        reportTileError("Failed to write fingerprint: ", fingerprintPath);
+        return false;
+    }
+    ctx.stats.tilesRebuilt += 1;
+    if (profile) {
+        clock.mark(TileStage::Write);
+        clock.finish();
+        profile->bytesWritten = tileBytesWritten({&meshPath, &metaPath, &fingerprintPath});
+        if (writesMask) {
+            profile->bytesWritten += tileBytesWritten({&maskPath});
+        }
+        if (writesNormals) {
+            profile->bytesWritten += tileBytesWritten({&normalPath});
+        }
+    }
+    return true;
+}
+
+// Tiles are independent, so workers pull the next index from a shared counter.
+// Output files depend only on the tile, which keeps results identical to a serial run.
+bool compileTiles(const TileContext& ctx, const std::vector<TileSpec>& tiles) {
+    int threadCount = ctx.cfg.threads;
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    threadCount = std::min(threadCount, static_cast<int>(std::max<size_t>(1, tiles.size())));
+
+    bool profiling = !ctx.cfg.profilePath.empty();
+    if (profiling && threadCount > ctx.stats.profileThreads) {
+        ctx.stats.profileThreads = threadCount;
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    auto worker = [&]() {
+        TileScratch scratch;
+        std::vector<TileProfile> profiles;
+        while (!failed.load(std::memory_order_relaxed)) {
+            size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= tiles.size()) {
+                break;
+            }
+            TileProfile* profile = nullptr;
+            if (profiling) {
+                profile = &profiles.emplace_back();
+                profile->level = tiles[i].level;
+                profile->x = tiles[i].x;
+                profile->y = tiles[i].y;
+            }
+            if (!compileTile(ctx, tiles[i], scratch, profile)) {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+        if (!profiles.empty()) {
+            std::lock_guard<std::mutex> lock(ctx.stats.profileMutex);
+            ctx.stats.profiles.insert(ctx.stats.profiles.end(), profiles.begin(), profiles.end());
+        }
+    };
+
+    if (threadCount == 1) {
+        worker();
+    } else {
+        std::cout << "[terrainc] compiling " << tiles.size() << " tiles on " << threadCount << " threads\n";
+        std::vector<std::thread> workers;
+        workers.reserve(static_cast<size_t>(threadCount));
+        for (int i = 0; i < threadCount; ++i) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+    }
+    return !failed.load();
 }
 
 } // namespace
 
 int main(int argc, char** argv) {
+    auto runStart = std::chrono::steady_clock::now();
     Config cfg;
     if (!parseArgs(argc, argv, cfg)) {
         printUsage();
         return 1;
     }
 
-    if (cfg.maskResolution > 0 && cfg.osmPath.empty()
+    if (cfg.maskResolution > 0 && !hasVectorInputs(cfg)
         && cfg.landcoverPath.empty() && cfg.landclassPath.empty()) {
-        std::cerr << "Mask resolution set but no OSM, landcover, or landclass file provided.\n";
+        std::cerr << "Mask resolution set but no OSM, GeoJSON, landcover, or landclass file provided.\n";
+        return 1;
+    }
+    if (cfg.maxError > 0.0f && !rtinGridSupported(cfg.gridResolution + 1)) {
+        std::cerr << "--max-error needs --grid to be a power of two (got " << cfg.gridResolution << ").\n";
+        return 1;
+    }
+    if (cfg.normalMapResolution < 0) {
+        std::cerr << "--normal-map-res must be positive (got " << cfg.normalMapResolution << ").\n";
         return 1;
     }
     if (!cfg.landcoverPath.empty() && cfg.maskResolution <= 0) {
@@ -1006,8 +2209,8 @@ int main(int argc, char** argv) {
         std::cerr << "Landclass provided but mask resolution not set.\n";
         return 1;
     }
-    if (!cfg.osmPath.empty() && !cfg.hasBbox) {
-        std::cerr << "OSM provided but bbox missing; use --xmin/--ymin/--xmax/--ymax.\n";
+    if (hasVectorInputs(cfg) && !cfg.hasBbox) {
+        std::cerr << "OSM/GeoJSON provided but bbox missing; use --xmin/--ymin/--xmax/--ymax.\n";
         return 1;
     }
     if (!cfg.landcoverPath.empty() && !cfg.hasBbox) {
@@ -1048,8 +2251,8 @@ int main(int argc, char** argv) {
     if (!cfg.landclassMapPath.empty() && !landclassMap.enabled) {
         std::cerr << "Landclass map provided but no valid mappings found.\n";
     }
-    if (useLandclass && (landcover.valid || !cfg.osmPath.empty())) {
-        std::cerr << "Landclass provided; ignoring landcover and OSM masks.\n";
+    if (useLandclass && (landcover.valid || hasVectorInputs(cfg))) {
+        std::cerr << "Landclass provided; ignoring landcover, OSM and GeoJSON masks.\n";
     }
 
     Heightmap hm;
@@ -1208,7 +2411,24 @@ int main(int argc, char** argv) {
     std::vector<Road> roadLines;
     std::unordered_map<std::int64_t, std::vector<int>> polyBuckets;
     std::unordered_map<std::int64_t, std::vector<int>> roadBuckets;
-    if (!cfg.osmPath.empty()) {
+    if (!cfg.osmPath.empty() && !cfg.useOsmium) {
+        OsmReadOptions osmOptions;
+        osmOptions.minLon = cfg.xmin;
+        osmOptions.minLat = cfg.ymin;
+        osmOptions.maxLon = cfg.xmax;
+        osmOptions.maxLat = cfg.ymax;
+        osmOptions.threads = cfg.threads;
+        auto osmStart = std::chrono::steady_clock::now();
+        OsmExtract extract;
+        if (!readOsmPbf(cfg.osmPath, osmOptions, classifyOsmFeature, extract)) {
+            std::cerr << "Failed to read OSM PBF: " << cfg.osmPath << "\n";
+            return 1;
+        }
+        appendOsmFeatures(extract, proj, landPolys, waterPolys, roadLines);
+        std::cout << "[terrainc] osm: " << extract.blocks << " blocks, " << extract.nodesInBounds
+                  << " nodes in bbox (+" << extract.nodesOutside << " outside), " << extract.ways << " ways, "
+                  << extract.relations << " multipolygons in " << (elapsedNanos(osmStart) / 1.0e6) << " ms\n";
+    } else if (!cfg.osmPath.empty()) {
         std::filesystem::path outDir(cfg.outDir);
         std::filesystem::path tmpDir = outDir / "osm_tmp";
         std::filesystem::create_directories(tmpDir);
@@ -1281,9 +2501,24 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        landPolys = loadPolygonsFromGeoJson(landGeo.string(), 0, proj, true);
-        waterPolys = loadPolygonsFromGeoJson(waterGeo.string(), 1, proj, false);
-        roadLines = loadRoadsFromGeoJson(roadGeo.string(), proj);
+        if (!loadPolygonsFromGeoJson(landGeo.string(), 0, proj, true, landPolys) ||
+            !loadPolygonsFromGeoJson(waterGeo.string(), 1, proj, false, waterPolys) ||
+            !loadRoadsFromGeoJson(roadGeo.string(), proj, roadLines)) {
+            return 1;
+        }
+    }
+    if (!cfg.landuseGeoJsonPath.empty() &&
+        !loadPolygonsFromGeoJson(cfg.landuseGeoJsonPath, 0, proj, true, landPolys)) {
+        return 1;
+    }
+    if (!cfg.waterGeoJsonPath.empty() &&
+        !loadPolygonsFromGeoJson(cfg.waterGeoJsonPath, 1, proj, false, waterPolys)) {
+        return 1;
+    }
+    if (!cfg.roadsGeoJsonPath.empty() && !loadRoadsFromGeoJson(cfg.roadsGeoJsonPath, proj, roadLines)) {
+        return 1;
+    }
+    if (hasVectorInputs(cfg)) {
         std::cout << "Loaded landuse polygons: " << landPolys.size() << "\n";
         std::cout << "Loaded water polygons: " << waterPolys.size() << "\n";
         std::cout << "Loaded road lines: " << roadLines.size() << "\n";
@@ -1339,6 +2574,36 @@ int main(int argc, char** argv) {
         }
     }
 
+    std::unordered_map<std::int64_t, std::vector<int>> runwayBuckets;
+    for (size_t i = 0; i < runways.size(); ++i) {
+        const auto& runway = runways[i];
+        // World-space bounds of the flatten box including the blend margin,
+        // padded a meter so vertices on the boundary are never missed.
+        float blend = std::max(cfg.runwayBlendMeters, 0.001f);
+        float along = runway.halfLength + blend;
+        float side = runway.halfWidth + blend;
+        float extentX = std::abs(runway.dir.x) * along + std::abs(runway.perp.x) * side + 1.0f;
+        float extentZ = std::abs(runway.dir.z) * along + std::abs(runway.perp.z) * side + 1.0f;
+        int minTx = static_cast<int>(std::floor((runway.center.x - extentX) / cfg.tileSize));
+        int maxTx = static_cast<int>(std::floor((runway.center.x + extentX) / cfg.tileSize));
+        int minTz = static_cast<int>(std::floor((runway.center.z - extentZ) / cfg.tileSize));
+        int maxTz = static_cast<int>(std::floor((runway.center.z + extentZ) / cfg.tileSize));
+
+        minTx = std::max(minTx, minTileX);
+        maxTx = std::min(maxTx, maxTileX);
+        minTz = std::max(minTz, minTileZ);
+        maxTz = std::min(maxTz, maxTileZ);
+
+        for (int ty = minTz; ty <= maxTz; ++ty) {
+            for (int tx = minTx; tx <= maxTx; ++tx) {
+                runwayBuckets[tileKey(tx, ty)].push_back(static_cast<int>(i));
+            }
+        }
+    }
+    if (!runways.empty()) {
+        std::cout << "[terrainc] runway flatten limited to " << runwayBuckets.size() << " tiles\n";
+    }
+
     for (int ty = minTileZ; ty <= maxTileZ; ++ty) {
         for (int tx = minTileX; tx <= maxTileX; ++tx) {
             float tileMinX = static_cast<float>(tx) * cfg.tileSize;
@@ -1349,136 +2614,171 @@ int main(int argc, char** argv) {
             if (tileMaxX <= minX || tileMinX >= maxX || tileMaxZ <= minZ || tileMinZ >= maxZ) {
                 continue;
             }
+            tileIndex.emplace_back(tx, ty);
+        }
+    }
 
-            int cells = cfg.gridResolution;
-            int resX = cells + 1;
-            int resZ = cells + 1;
-
-            std::vector<nuage::Vec3> positions(resX * resZ);
-            std::vector<nuage::Vec3> normals(resX * resZ, nuage::Vec3(0, 1, 0));
-            std::vector<float> verts;
-            int stride = 9;
-            verts.reserve((resX - 1) * (resZ - 1) * 6 * stride);
-
-            float localMinH = std::numeric_limits<float>::max();
-            float localMaxH = std::numeric_limits<float>::lowest();
-
-            for (int z = 0; z < resZ; ++z) {
-                for (int x = 0; x < resX; ++x) {
-                    float fx = (resX > 1) ? static_cast<float>(x) / (resX - 1) : 0.0f;
-                    float fz = (resZ > 1) ? static_cast<float>(z) / (resZ - 1) : 0.0f;
-
-                    float worldX = tileMinX + fx * cfg.tileSize;
-                    float worldZ = tileMinZ + fz * cfg.tileSize;
-
-                    float u = (worldX - minX) / cfg.sizeX;
-                    float v = (worldZ - minZ) / cfg.sizeZ;
-                    u = clamp01(u);
-                    v = clamp01(v);
-
-                    float hx = u * static_cast<float>(hm.width - 1);
-                    float hz = v * static_cast<float>(hm.height - 1);
-                    float raw = bilinearSample(hm, hx, hz) / 65535.0f;
-                    float height = cfg.heightMin + raw * heightRange;
-                    height = applyRunwayFlatten(worldX, worldZ, height, runways, cfg.runwayBlendMeters);
-
-                    localMinH = std::min(localMinH, height);
-                    localMaxH = std::max(localMaxH, height);
-
-                    int idx = z * resX + x;
-                    positions[idx] = nuage::Vec3(worldX, height, worldZ);
-                }
-            }
-
-            for (int z = 0; z < resZ; ++z) {
-                for (int x = 0; x < resX; ++x) {
-                    int idx = z * resX + x;
-                    int left = z * resX + std::max(x - 1, 0);
-                    int right = z * resX + std::min(x + 1, resX - 1);
-                    int up = std::max(z - 1, 0) * resX + x;
-                    int down = std::min(z + 1, resZ - 1) * resX + x;
-
-                    nuage::Vec3 tangentX = positions[right] - positions[left];
-                    nuage::Vec3 tangentZ = positions[down] - positions[up];
-                    nuage::Vec3 normal = tangentZ.cross(tangentX);
-                    normals[idx] = (normal.length() > 1e-6f) ? normal.normalized() : nuage::Vec3(0, 1, 0);
-                }
-            }
-
-            auto appendVertex = [&](int idx) {
-                const auto& pos = positions[idx];
-                const auto& normal = normals[idx];
-                float t = (pos.y - cfg.heightMin) / heightRange;
-                nuage::Vec3 color = heightColor(t);
-                verts.insert(verts.end(), {
-                    pos.x, pos.y, pos.z,
-                    normal.x, normal.y, normal.z,
-                    color.x, color.y, color.z
-                });
-            };
-
-            for (int z = 0; z < resZ - 1; ++z) {
-                for (int x = 0; x < resX - 1; ++x) {
-                    int i00 = z * resX + x;
-                    int i10 = i00 + 1;
-                    int i01 = i00 + resX;
-                    int i11 = i01 + 1;
-
-                    appendVertex(i00);
-                    appendVertex(i10);
-                    appendVertex(i11);
-
-                    appendVertex(i00);
-                    appendVertex(i11);
-                    appendVertex(i01);
-                }
-            }
+    CompileStats stats;
+    TileContext tileCtx{cfg, hm, tilesDir, minX, minZ, heightRange, runways, runwayBuckets, proj,
+                        landcover, landclass, landclassMap, useLandclass,
+                        allPolys, polyBuckets, roadLines, roadBuckets,
+                        computeConfigHash(cfg, hm, proj, landcover, landclass, landclassMap, useLandclass), stats};
+    tileCtx.lodOriginX = minTileX;
+    tileCtx.lodOriginZ = minTileZ;
+    tileCtx.levelTiles.emplace_back();
+    std::vector<TileSpec> baseSpecs;
+    baseSpecs.reserve(tileIndex.size());
+    for (const auto& tile : tileIndex) {
+        tileCtx.levelTiles[0].insert(tileKey(tile.first, tile.second));
+        baseSpecs.push_back(baseTileSpec(cfg, tile.first, tile.second));
+    }
+    auto compileStart = std::chrono::steady_clock::now();
+    double setupSeconds = std::chrono::duration<double>(compileStart - runStart).count();
+    if (!compileTiles(tileCtx, baseSpecs)) {
+        return 1;
+    }
 
-            std::filesystem::path meshPath = tilesDir / ("tile_" + std::to_string(tx) + "_" + std::to_string(ty) + ".mesh");
-            if (!writeMesh(meshPath, verts)) {
-                std::cerr << "Failed to write mesh: " << meshPath << "\n";
-                return 1;
-            }
-
-            std::filesystem::path metaPath = tilesDir / ("tile_" + std::to_string(tx) + "_" + std::to_string(ty) + ".meta.json");
-            writeTileMeta(metaPath, tx, ty, localMinH, localMaxH, cfg.gridResolution);
-
-            if (cfg.maskResolution > 0 && (useLandclass || landcover.valid || !allPolys.empty())) {
-                std::vector<std::uint8_t> mask(static_cast<size_t>(cfg.maskResolution * cfg.maskResolution), 0);
-                if (useLandclass) {
-                    fillMaskFromLandclass(mask, cfg.maskResolution, tileMinX, tileMinZ,
-                                          cfg.tileSize, proj, landclass, landclassMap.enabled ? &landclassMap : nullptr);
-                } else {
-                    if (landcover.valid) {
-                        fillMaskFromLandcover(mask, cfg.maskResolution, tileMinX, tileMinZ,
-                                              cfg.tileSize, proj, landcover);
-                    }
-                    auto bucketIt = polyBuckets.find(tileKey(tx, ty));
-                    if (bucketIt != polyBuckets.end()) {
-                        rasterizePolygonsToMaskList(mask, cfg.maskResolution, tileMinX, tileMinZ,
-                                                    cfg.tileSize, allPolys, bucketIt->second);
-                    }
-                    if (cfg.maskSmooth > 0) {
-                        smoothMask(mask, cfg.maskResolution, cfg.maskSmooth);
-                    }
-                    auto roadIt = roadBuckets.find(tileKey(tx, ty));
-                    if (roadIt != roadBuckets.end()) {
-                        rasterizeRoadsToMaskList(mask, cfg.maskResolution, tileMinX, tileMinZ,
-                                                 cfg.tileSize, roadLines, roadIt->second, cfg.roadWidthBoost);
-                    }
-                    if (cfg.roadSmooth > 0) {
-                        smoothMask(mask, cfg.maskResolution, cfg.roadSmooth);
-                    }
-                }
-
-                std::filesystem::path maskPath = tilesDir / ("tile_" + std::to_string(tx) + "_" + std::to_string(ty) + ".mask");
-                if (!writeMask(maskPath, mask)) {
-                    std::cerr << "Failed to write mask: " << maskPath << "\n";
-                    return 1;
-                }
+    // Far-field pyramid. Each level holds the parents of the level below at the
+    // same grid and mask size, so a level covers about a quarter of the area of
+    // the one under it. The budget, a third of the base level, is checked
+    // before a level is compiled, estimating its size from the average tile of
+    // the level below. Edge parents round up, so that estimate beats a flat
+    // quarter. A level is never built and then thrown away, which would drop
+    // its fingerprints and rebuild it on every incremental run.
+    auto levelBytes = [&](int level, const std::vector<std::pair<int, int>>& tiles) {
+        std::uintmax_t bytes = 0;
+        for (const auto& tile : tiles) {
+            TileSpec spec;
+            spec.level = level;
+            spec.x = tile.first;
+            spec.y = tile.second;
+            for (const char* extension : {".mesh", ".mask", ".nrm"}) {
+                std::error_code ec;
+                std::uintmax_t size = std::filesystem::file_size(tilePath(tileCtx, spec, extension), ec);
+                bytes += ec ? 0 : size;
             }
+        }
+        return bytes;
+    };
+    std::vector<std::vector<std::pair<int, int>>> lodIndex;
+    std::vector<std::uintmax_t> lodLevelBytes;
+    size_t lodTileTotal = 0;
+    std::uintmax_t lodBytes = 0;
+    std::uintmax_t baseBytes = cfg.lodLevels > 0 ? levelBytes(0, tileIndex) : 0;
+    if (cfg.lodLevels > 0) {
+        // Enough mips for the widest spacing sampled, the top level's grid
+        // or normal map texels, whichever is coarser.
+        int samples = cfg.gridResolution;
+        if (cfg.normalMapResolution > 0) {
+            samples = std::min(samples, cfg.normalMapResolution);
+        }
+        float spacing = cfg.tileSize * static_cast<float>(1 << cfg.lodLevels) / static_cast<float>(samples);
+        float ratio = spacing / std::max(demPixelMeters(tileCtx), 1e-3f);
+        if (ratio >= 2.0f) {
+            buildHeightMips(tileCtx, static_cast<int>(std::floor(std::log2(ratio))));
+        }
+    }
+    std::uintmax_t belowBytes = baseBytes;
+    std::vector<std::pair<int, int>> below;
+    below.reserve(tileIndex.size());
+    for (const auto& tile : tileIndex) {
+        below.emplace_back(tile.first - minTileX, tile.second - minTileZ);
+    }
+    for (int level = 1; level <= cfg.lodLevels && below.size() > 1; ++level) {
+        std::vector<std::pair<int, int>> parents;
+        parents.reserve(below.size() / 4 + 1);
+        for (const auto& tile : below) {
+            parents.emplace_back(tile.first / 2, tile.second / 2);
+        }
+        std::sort(parents.begin(), parents.end(), [](const auto& a, const auto& b) {
+            return a.second != b.second ? a.second < b.second : a.first < b.first;
+        });
+        parents.erase(std::unique(parents.begin(), parents.end()), parents.end());
+
+        std::uintmax_t estimate = belowBytes * parents.size() / below.size();
+        if ((lodBytes + estimate) * 3 > baseBytes) {
+            std::cout << "[terrainc] stopping at " << (level - 1) << " lod levels: level " << level
+                      << " (about " << (estimate / 1.0e6) << " MB) would push the pyramid past a third"
+                      << " of the base level size\n";
+            break;
+        }
 
-            tileIndex.emplace_back(tx, ty);
+        auto& levelTiles = tileCtx.levelTiles.emplace_back();
+        std::vector<TileSpec> specs;
+        specs.reserve(parents.size());
+        for (const auto& tile : parents) {
+            levelTiles.insert(tileKey(tile.first, tile.second));
+            specs.push_back(lodTileSpec(tileCtx, level, tile.first, tile.second));
+        }
+        std::filesystem::create_directories(levelDir(tileCtx, level));
+        if (!compileTiles(tileCtx, specs)) {
+            return 1;
+        }
+        std::uintmax_t bytes = levelBytes(level, parents);
+        belowBytes = bytes;
+        lodTileTotal += parents.size();
+        lodBytes += bytes;
+        lodLevelBytes.push_back(bytes);
+        below = parents;
+        lodIndex.push_back(std::move(parents));
+    }
+    // Levels left from an earlier run with more of them are not in the
+    // manifest; remove them rather than ship dead tiles.
+    std::vector<std::filesystem::path> staleLevels;
+    std::error_code dirEc;
+    for (const auto& entry : std::filesystem::directory_iterator(tilesDir, dirEc)) {
+        std::string name = entry.path().filename().string();
+        if (!entry.is_directory() || name.size() <= 3 || name.size() > 6 || name.compare(0, 3, "lod") != 0 ||
+            name.find_first_not_of("0123456789", 3) != std::string::npos) {
+            continue;
+        }
+        if (std::stoul(name.substr(3)) > lodIndex.size()) {
+            staleLevels.push_back(entry.path());
+        }
+    }
+    for (const auto& path : staleLevels) {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+        std::cout << "[terrainc] removed stale " << path.filename().string() << " from a previous build\n";
+    }
+    if (!lodIndex.empty()) {
+        for (size_t i = 0; i < lodIndex.size(); ++i) {
+            std::cout << "[terrainc] lod " << (i + 1) << ": " << lodIndex[i].size() << " tiles, "
+                      << (lodLevelBytes[i] / 1.0e6) << " MB\n";
+        }
+        std::cout << "[terrainc] lod pyramid: " << lodTileTotal << " tiles, " << (lodBytes / 1.0e6) << " MB ("
+                  << (baseBytes > 0 ? 100.0 * static_cast<double>(lodBytes) / static_cast<double>(baseBytes) : 0.0)
+                  << "% of base level)\n";
+    }
+    double compileSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - compileStart).count();
+    std::cout << "[terrainc] tiles rebuilt: " << stats.tilesRebuilt << ", reused: " << stats.tilesReused << "\n";
+    if (stats.adaptiveTriangles > 0) {
+        std::cout << "[terrainc] adaptive meshes: " << stats.adaptiveTriangles << " triangles vs "
+                  << stats.gridTriangles << " on the uniform grid ("
+                  << static_cast<double>(stats.gridTriangles) / static_cast<double>(stats.adaptiveTriangles)
+                  << "x fewer)\n";
+    }
+    if (stats.polygonTiles > 0) {
+        std::cout << "[terrainc] polygon masks: " << stats.polygonPasses << " polygons over "
+                  << stats.polygonTiles << " tiles in " << (stats.polygonNanos / 1.0e6) << " ms\n";
+    }
+    if (stats.roadTiles > 0) {
+        double roadSeconds = stats.roadNanos / 1.0e9;
+        std::cout << "[terrainc] road masks: " << stats.roadPasses << " roads over "
+                  << stats.roadTiles << " tiles in " << (roadSeconds * 1000.0) << " ms";
+        if (roadSeconds > 0.0) {
+            std::cout << " (" << static_cast<std::int64_t>(stats.roadPasses / roadSeconds) << " roads/s)";
+        }
+        std::cout << "\n";
+    }
+    if (!cfg.profilePath.empty()) {
+        ProfileRun run;
+        run.threads = stats.profileThreads;
+        run.setupSeconds = setupSeconds;
+        run.compileSeconds = compileSeconds;
+        run.slowestCount = cfg.profileSlowest;
+        if (!writeProfileReport(cfg.profilePath, std::move(stats.profiles), run)) {
+            return 1;
         }
     }
 
@@ -1500,14 +2800,20 @@ int main(int argc, char** argv) {
     manifest << "  \"enuBasis\": [\"east\", \"up\", \"north\"],\n";
     manifest << "  \"tileSizeMeters\": " << cfg.tileSize << ",\n";
     manifest << "  \"gridResolution\": " << cfg.gridResolution << ",\n";
+    if (cfg.maxError > 0.0f) {
+        manifest << "  \"meshMaxErrorMeters\": " << cfg.maxError << ",\n";
+    }
     manifest << "  \"heightScaleMeters\": 1.0,\n";
     manifest << "  \"boundsENU\": [" << minX << ", " << minZ << ", " << maxX << ", " << maxZ << "],\n";
-    if (cfg.maskResolution > 0 && (useLandclass || !cfg.osmPath.empty() || landcover.valid)) {
+    if (cfg.maskResolution > 0 && (useLandclass || hasVectorInputs(cfg) || landcover.valid)) {
         manifest << "  \"maskResolution\": " << cfg.maskResolution << ",\n";
         manifest << "  \"maskType\": \"" << (useLandclass ? "landclass" : "landuse") << "\",\n";
-        manifest << "  \"availableLayers\": [\"height\", \"mask\"],\n";
+        manifest << "  \"availableLayers\": [\"height\", \"mask\"" << (cfg.normalMapResolution > 0 ? ", \"normal\"" : "") << "],\n";
     } else {
-        manifest << "  \"availableLayers\": [\"height\"],\n";
+        manifest << "  \"availableLayers\": [\"height\"" << (cfg.normalMapResolution > 0 ? ", \"normal\"" : "") << "],\n";
+    }
+    if (cfg.normalMapResolution > 0) {
+        manifest << "  \"normalMapResolution\": " << cfg.normalMapResolution << ",\n";
     }
     manifest << "  \"tileCount\": " << tileIndex.size() << ",\n";
     manifest << "  \"tileIndex\": [\n";
@@ -1516,6 +2822,24 @@ int main(int argc, char** argv) {
         manifest << (i + 1 < tileIndex.size() ? ",\n" : "\n");
     }
     manifest << "  ],\n";
+    if (!lodIndex.empty()) {
+        manifest << "  \"lodOriginTile\": [" << minTileX << ", " << minTileZ << "],\n";
+        manifest << "  \"lodLevels\": [\n";
+        for (size_t level = 0; level < lodIndex.size(); ++level) {
+            const auto& tiles = lodIndex[level];
+            manifest << "    {\n";
+            manifest << "      \"level\": " << (level + 1) << ",\n";
+            manifest << "      \"tileSizeMeters\": " << cfg.tileSize * static_cast<float>(1 << (level + 1)) << ",\n";
+            manifest << "      \"path\": \"tiles/lod" << (level + 1) << "\",\n";
+            manifest << "      \"tileIndex\": [";
+            for (size_t i = 0; i < tiles.size(); ++i) {
+                manifest << (i > 0 ? ", " : "") << "[" << tiles[i].first << ", " << tiles[i].second << "]";
+            }
+            manifest << "]\n";
+            manifest << "    }" << (level + 1 < lodIndex.size() ? ",\n" : "\n");
+        }
+        manifest << "  ],\n";
+    }
     manifest << "  \"compilerInfo\": {\"name\": \"terrainc\"}\n";
     manifest << "}\n";
 
@@ -0,0 +1,144 @@
+#include "tools/terrainc/compile_profile.hpp"
+#include "utils/json.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+const char* tileStageName(TileStage stage) {
+    switch (stage) {
+        case TileStage::Fingerprint: return "fingerprint";
+        case TileStage::Heights: return "heights";
+        case TileStage::Runways: return "runways";
+        case TileStage::Normals: return "normals";
+        case TileStage::Mesh: return "mesh";
+        case TileStage::NormalMap: return "normalMap";
+        case TileStage::MaskFill: return "maskFill";
+        case TileStage::Polygons: return "polygons";
+        case TileStage::Roads: return "roads";
+        case TileStage::Smoothing: return "smoothing";
+        case TileStage::Write: return "write";
+        default: return "unknown";
+    }
+}
+
+namespace {
+double seconds(std::int64_t nanos) {
+    return static_cast<double>(nanos) / 1.0e9;
+}
+
+// Run totals list every stage so reports share one layout; tiles skip the
+// stages they never reached.
+nlohmann::ordered_json stageObject(const std::array<std::int64_t, kTileStageCount>& stageNanos, bool allStages) {
+    nlohmann::ordered_json stages = nlohmann::ordered_json::object();
+    for (size_t i = 0; i < kTileStageCount; ++i) {
+        if (allStages || stageNanos[i] > 0) {
+            stages[tileStageName(static_cast<TileStage>(i))] = seconds(stageNanos[i]);
+        }
+    }
+    return stages;
+}
+} // namespace
+
+bool writeProfileReport(const std::string& reportPath, std::vector<TileProfile> tiles, const ProfileRun& run) {
+    std::sort(tiles.begin(), tiles.end(), [](const TileProfile& a, const TileProfile& b) {
+        if (a.level != b.level) return a.level < b.level;
+        if (a.y != b.y) return a.y < b.y;
+        return a.x < b.x;
+    });
+
+    std::array<std::int64_t, kTileStageCount> stageTotals{};
+    std::int64_t tileNanos = 0;
+    std::uint64_t bytesWritten = 0;
+    size_t rebuilt = 0;
+    for (const auto& tile : tiles) {
+        for (size_t i = 0; i < kTileStageCount; ++i) {
+            stageTotals[i] += tile.stageNanos[i];
+        }
+        tileNanos += tile.totalNanos;
+        bytesWritten += tile.bytesWritten;
+        rebuilt += tile.reused ? 0 : 1;
+    }
+
+    std::vector<const TileProfile*> slowest;
+    for (const auto& tile : tiles) {
+        if (!tile.reused) {
+            slowest.push_back(&tile);
+        }
+    }
+    size_t slowestCount = std::min(slowest.size(), static_cast<size_t>(std::max(0, run.slowestCount)));
+    std::partial_sort(slowest.begin(), slowest.begin() + static_cast<std::ptrdiff_t>(slowestCount), slowest.end(),
+                      [](const TileProfile* a, const TileProfile* b) { return a->totalNanos > b->totalNanos; });
+    slowest.resize(slowestCount);
+
+    double tilesPerSecond = run.compileSeconds > 0.0 ? static_cast<double>(tiles.size()) / run.compileSeconds : 0.0;
+    double megabytes = static_cast<double>(bytesWritten) / 1.0e6;
+
+    std::cout << "[terrainc] profile: " << tiles.size() << " tiles (" << rebuilt << " rebuilt) in "
+              << run.compileSeconds << " s on " << run.threads << " threads, " << tilesPerSecond
+              << " tiles/s, " << megabytes << " MB written, setup " << run.setupSeconds << " s\n";
+    for (size_t i = 0; i < kTileStageCount; ++i) {
+        if (stageTotals[i] == 0) {
+            continue;
+        }
+        double share = tileNanos > 0 ? 100.0 * static_cast<double>(stageTotals[i]) / static_cast<double>(tileNanos) : 0.0;
+        std::cout << "[terrainc]   " << tileStageName(static_cast<TileStage>(i)) << ": "
+                  << seconds(stageTotals[i]) << " s (" << share << "%)\n";
+    }
+    for (const auto* tile : slowest) {
+        std::cout << "[terrainc]   slow tile";
+        if (tile->level > 0) {
+            std::cout << " lod" << tile->level;
+        }
+        std::cout << " " << tile->x << "," << tile->y << ": " << (seconds(tile->totalNanos) * 1000.0) << " ms\n";
+    }
+
+    nlohmann::ordered_json report;
+    report["version"] = 1;
+    report["threads"] = run.threads;
+    report["setupSeconds"] = run.setupSeconds;
+    report["compileSeconds"] = run.compileSeconds;
+    report["tiles"] = tiles.size();
+    report["tilesRebuilt"] = rebuilt;
+    report["tilesReused"] = tiles.size() - rebuilt;
+    report["tilesPerSecond"] = tilesPerSecond;
+    report["bytesWritten"] = bytesWritten;
+    report["megabytesWritten"] = megabytes;
+    report["tileSeconds"] = seconds(tileNanos);
+    report["stageSeconds"] = stageObject(stageTotals, true);
+
+    nlohmann::ordered_json slowJson = nlohmann::ordered_json::array();
+    for (const auto* tile : slowest) {
+        slowJson.push_back({
+            {"level", tile->level},
+            {"x", tile->x},
+            {"y", tile->y},
+            {"seconds", seconds(tile->totalNanos)},
+            {"bytesWritten", tile->bytesWritten},
+            {"stages", stageObject(tile->stageNanos, false)},
+        });
+    }
+    report["slowestTiles"] = std::move(slowJson);
+
+    nlohmann::ordered_json tileJson = nlohmann::ordered_json::array();
+    for (const auto& tile : tiles) {
+        tileJson.push_back({
+            {"level", tile.level},
+            {"x", tile.x},
+            {"y", tile.y},
+            {"reused", tile.reused},
+            {"seconds", seconds(tile.totalNanos)},
+            {"bytesWritten", tile.bytesWritten},
+            {"stages", stageObject(tile.stageNanos, false)},
+        });
+    }
+    report["tileTimes"] = std::move(tileJson);
+
+    std::ofstream out(reportPath);
+    if (!out.is_open()) {
+        std::cerr << "Failed to write profile report: " << reportPath << "\n";
+        return false;
+    }
+    out << report.dump(2) << "\n";
+    std::cout << "[terrainc] profile report: " << reportPath << "\n";
+    return true;
+}
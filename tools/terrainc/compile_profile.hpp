@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Per-tile stage timing for terrainc --profile.
+enum class TileStage : int {
+    Fingerprint = 0,
+    Heights,
+    Runways,
+    Normals,
+    Mesh,
+    NormalMap,
+    MaskFill,
+    Polygons,
+    Roads,
+    Smoothing,
+    Write,
+    Count,
+};
+
+constexpr size_t kTileStageCount = static_cast<size_t>(TileStage::Count);
+
+const char* tileStageName(TileStage stage);
+
+struct TileProfile {
+    int level = 0;
+    int x = 0;
+    int y = 0;
+    bool reused = false;
+    std::int64_t totalNanos = 0;
+    std::uint64_t bytesWritten = 0;
+    std::array<std::int64_t, kTileStageCount> stageNanos{};
+};
+
+// Lap timer: mark(stage) charges the time since the previous mark to stage.
+// With a null profile every call is a no-op, so unprofiled runs skip the
+// clock reads entirely.
+class StageClock {
+public:
+    explicit StageClock(TileProfile* profile) : m_profile(profile) {
+        if (m_profile) {
+            m_start = m_last = std::chrono::steady_clock::now();
+        }
+    }
+
+    void mark(TileStage stage) {
+        if (!m_profile) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        m_profile->stageNanos[static_cast<size_t>(stage)] +=
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_last).count();
+        m_last = now;
+    }
+
+    // Stamps the tile's total time since construction.
+    void finish() {
+        if (m_profile) {
+            m_profile->totalNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_start).count();
+        }
+    }
+
+private:
+    TileProfile* m_profile;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_last;
+};
+
+struct ProfileRun {
+    int threads = 1;
+    double setupSeconds = 0.0;
+    double compileSeconds = 0.0;
+    int slowestCount = 10;
+};
+
+// Prints stage totals, throughput and the slowest tiles, and writes the same
+// data as JSON to reportPath. Tiles are sorted so reports diff cleanly.
+bool writeProfileReport(const std::string& reportPath, std::vector<TileProfile> tiles, const ProfileRun& run);
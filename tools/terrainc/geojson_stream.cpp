@@ -0,0 +1,226 @@
+#include "tools/terrainc/geojson_stream.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+constexpr size_t kReadChunkBytes = 1 << 20;
+
+// Tracks JSON structure one character at a time. Text of each element of the
+// top-level "features" array is copied into its own buffer and parsed on
+// its own; the rest of the top-level object is kept (with the array emptied)
+// so a bare Feature can still be recognised once it closes.
+class FeatureScanner {
+public:
+    FeatureScanner(const std::string& path, const GeoJsonFeatureVisitor& visit)
+        : m_path(path), m_visit(visit) {}
+
+    bool feed(const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            if (!step(data[i])) {
+                return false;
+            }
+            ++m_offset;
+        }
+        return true;
+    }
+
+    bool finish() {
+        if (m_inString || !m_stack.empty()) {
+            std::cerr << "Truncated GeoJSON: " << m_path << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    const GeoJsonStreamStats& stats() const { return m_stats; }
+
+private:
+    bool fail(const char* message) {
+        std::cerr << "Invalid GeoJSON (" << message << " at byte " << m_offset << "): " << m_path << "\n";
+        return false;
+    }
+
+    void sink(char c) {
+        if (m_capturing) {
+            m_feature.push_back(c);
+        } else if (!m_featuresOpen) {
+            m_top.push_back(c);
+        }
+    }
+
+    bool emit(const std::string& text) {
+        nlohmann::json feature = nlohmann::json::parse(text, nullptr, false);
+        if (feature.is_discarded()) {
+            return fail("malformed feature");
+        }
+        ++m_stats.features;
+        m_stats.largestFeatureBytes = std::max(m_stats.largestFeatureBytes, text.size());
+        m_visit(feature);
+        return true;
+    }
+
+    bool step(char c) {
+        if (m_inString) {
+            sink(c);
+            if (m_escape) {
+                m_escape = false;
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                m_inString = false;
+                if (m_keyActive) {
+                    m_keyActive = false;
+                    m_lastKey = m_key;
+                }
+                return true;
+            }
+            if (m_keyActive) {
+                m_key.push_back(c);
+            }
+            return true;
+        }
+
+        size_t depth = m_stack.size();
+        switch (c) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case '\x1e':
+            return true;
+        case '"':
+            if (depth == 0) {
+                return fail("unexpected string");
+            }
+            if (depth == 1 && m_stack[0] == '{' && m_expectKey) {
+                m_keyActive = true;
+                m_key.clear();
+            }
+            m_inString = true;
+            sink(c);
+            return true;
+        case '{':
+        case '[':
+            if (depth == 0) {
+                if (c != '{') {
+                    return fail("top-level value is not an object");
+                }
+                m_top.clear();
+                m_sawFeatures = false;
+            }
+            if (depth == 1 && c == '[' && m_stack[0] == '{' && !m_expectKey && m_lastKey == "features") {
+                m_top.push_back('[');
+                m_featuresOpen = true;
+                m_sawFeatures = true;
+                m_stack.push_back(c);
+                return true;
+            }
+            if (m_featuresOpen && depth == 2 && c == '{') {
+                m_capturing = true;
+                m_feature.clear();
+            }
+            sink(c);
+            m_stack.push_back(c);
+            if (m_stack.size() == 1) {
+                m_expectKey = true;
+            }
+            return true;
+        case '}':
+        case ']':
+            if (depth == 0 || m_stack.back() != (c == '}' ? '{' : '[')) {
+                return fail("mismatched bracket");
+            }
+            sink(c);
+            m_stack.pop_back();
+            if (m_capturing && m_stack.size() == 2) {
+                m_capturing = false;
+                if (!emit(m_feature)) {
+                    return false;
+                }
+                std::string().swap(m_feature);
+            } else if (m_featuresOpen && m_stack.size() == 1) {
+                m_featuresOpen = false;
+                m_top.push_back(']');
+            }
+            if (m_stack.empty() && !m_sawFeatures) {
+                nlohmann::json top = nlohmann::json::parse(m_top, nullptr, false);
+                if (top.is_discarded()) {
+                    return fail("malformed object");
+                }
+                if (top.is_object() && top.value("type", "") == "Feature" && !emit(m_top)) {
+                    return false;
+                }
+            }
+            return true;
+        case ':':
+            if (depth == 1) {
+                m_expectKey = false;
+            }
+            sink(c);
+            return true;
+        case ',':
+            if (depth == 1 && m_stack[0] == '{') {
+                m_expectKey = true;
+            }
+            sink(c);
+            return true;
+        default:
+            if (depth == 0) {
+                return fail("unexpected character");
+            }
+            sink(c);
+            return true;
+        }
+    }
+
+    const std::string& m_path;
+    const GeoJsonFeatureVisitor& m_visit;
+    GeoJsonStreamStats m_stats;
+    size_t m_offset = 0;
+
+    std::vector<char> m_stack;
+    bool m_inString = false;
+    bool m_escape = false;
+    bool m_expectKey = false;
+    bool m_keyActive = false;
+    std::string m_key;
+    std::string m_lastKey;
+
+    bool m_featuresOpen = false;
+    bool m_sawFeatures = false;
+    bool m_capturing = false;
+    std::string m_top;
+    std::string m_feature;
+};
+} // namespace
+
+bool forEachGeoJsonFeature(const std::string& path, const GeoJsonFeatureVisitor& visit,
+                           GeoJsonStreamStats* stats) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open GeoJSON: " << path << "\n";
+        return false;
+    }
+
+    FeatureScanner scanner(path, visit);
+    std::vector<char> buffer(kReadChunkBytes);
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize got = in.gcount();
+        if (got <= 0) {
+            break;
+        }
+        if (!scanner.feed(buffer.data(), static_cast<size_t>(got))) {
+            return false;
+        }
+    }
+    if (!scanner.finish()) {
+        return false;
+    }
+    if (stats) {
+        *stats = scanner.stats();
+    }
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "utils/json.hpp"
+#include <cstddef>
+#include <functional>
+#include <string>
+
+struct GeoJsonStreamStats {
+    size_t features = 0;
+    size_t largestFeatureBytes = 0;
+};
+
+using GeoJsonFeatureVisitor = std::function<void(const nlohmann::json& feature)>;
+
+// Reads a FeatureCollection, a lone Feature, or a newline/RS-delimited feature
+// sequence in fixed-size chunks and hands each feature to visit as soon as it
+// is complete. Only one feature is held in memory at a time, so peak memory
+// is bounded by the largest feature rather than the file.
+bool forEachGeoJsonFeature(const std::string& path, const GeoJsonFeatureVisitor& visit,
+                           GeoJsonStreamStats* stats = nullptr);
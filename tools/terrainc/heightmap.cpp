@@ -1,4 +1,5 @@
 #include "tools/terrainc/heightmap.hpp"
+#include "utils/raster_kernels.hpp"
 #include "utils/stb_image.h"
 #include <algorithm>
 #include <cmath>
@@ -6,31 +7,13 @@
 
 bool loadHeightmap(const std::string& path, Heightmap& out) {
     stbi_set_flip_vertically_on_load(0);
-    int width = 0;
-    int height = 0;
-    int channels = 0;
-
-    std::uint16_t* data16 = stbi_load_16(path.c_str(), &width, &height, &channels, 1);
-    if (data16) {
-        out.width = width;
-        out.height = height;
-        out.pixels.assign(data16, data16 + (width * height));
-        stbi_image_free(data16);
-        return true;
-    }
-
-    unsigned char* data8 = stbi_load(path.c_str(), &width, &height, &channels, 1);
-    if (!data8) {
+    if (!out.raster.open(path)) {
         std::cerr << "Failed to load heightmap: " << path << "\n";
         return false;
     }
-    out.width = width;
-    out.height = height;
-    out.pixels.resize(width * height);
-    for (int i = 0; i < width * height; ++i) {
-        out.pixels[i] = static_cast<std::uint16_t>(data8[i]) * 257;
-    }
-    stbi_image_free(data8);
+    out.width = out.raster.width();
+    out.height = out.raster.height();
+    out.metric = out.raster.sampleType() == RasterSampleType::S16;
     return true;
 }
 
@@ -50,8 +33,10 @@ float bilinearSample(const Heightmap& hm, float x, float y) {
     float tx = fx - static_cast<float>(x0);
     float ty = fy - static_cast<float>(y0);
 
+    // 8-bit sources are widened to the 16-bit range the height scale expects.
+    float scale = hm.raster.sampleType() == RasterSampleType::U8 ? 257.0f : 1.0f;
     auto at = [&](int px, int py) -> float {
-        return static_cast<float>(hm.pixels[py * hm.width + px]);
+        return static_cast<float>(hm.raster.at(px, py)) * scale;
     };
 
     float v00 = at(x0, y0);
@@ -63,3 +48,50 @@ float bilinearSample(const Heightmap& hm, float x, float y) {
     float v1 = v01 + (v11 - v01) * tx;
     return v0 + (v1 - v0) * ty;
 }
+
+float sampleHeightMeters(const Heightmap& hm, float x, float y, float heightMin, float heightRange) {
+    float sample = bilinearSample(hm, x, y);
+    if (hm.metric) {
+        return sample;
+    }
+    float raw = sample / 65535.0f;
+    return heightMin + raw * heightRange;
+}
+
+void sampleHeightMetersRow(const Heightmap& hm, const float* xs, float y, size_t count,
+                           float heightMin, float heightRange, float* out) {
+    constexpr size_t kChunk = 256;
+    float c00[kChunk];
+    float c10[kChunk];
+    float c01[kChunk];
+    float c11[kChunk];
+    float tx[kChunk];
+
+    float fy = std::clamp(y, 0.0f, static_cast<float>(hm.height - 1));
+    int y0 = static_cast<int>(std::floor(fy));
+    int y1 = std::min(y0 + 1, hm.height - 1);
+    float ty = fy - static_cast<float>(y0);
+    float scale = hm.raster.sampleType() == RasterSampleType::U8 ? 257.0f : 1.0f;
+
+    for (size_t begin = 0; begin < count; begin += kChunk) {
+        size_t n = std::min(kChunk, count - begin);
+        for (size_t i = 0; i < n; ++i) {
+            float fx = std::clamp(xs[begin + i], 0.0f, static_cast<float>(hm.width - 1));
+            int x0 = static_cast<int>(std::floor(fx));
+            int x1 = std::min(x0 + 1, hm.width - 1);
+            tx[i] = fx - static_cast<float>(x0);
+            c00[i] = static_cast<float>(hm.raster.at(x0, y0)) * scale;
+            c10[i] = static_cast<float>(hm.raster.at(x1, y0)) * scale;
+            c01[i] = static_cast<float>(hm.raster.at(x0, y1)) * scale;
+            c11[i] = static_cast<float>(hm.raster.at(x1, y1)) * scale;
+        }
+        float* dst = out + begin;
+        nuage::bilinearBlendRow(c00, c10, c01, c11, tx, ty, dst, n);
+        if (!hm.metric) {
+            for (size_t i = 0; i < n; ++i) {
+                float raw = dst[i] / 65535.0f;
+                dst[i] = heightMin + raw * heightRange;
+            }
+        }
+    }
+}
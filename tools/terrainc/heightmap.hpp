@@ -1,15 +1,23 @@
 #pragma once
 
-#include <cstdint>
+#include "tools/terrainc/raster.hpp"
+#include <cstddef>
 #include <string>
-#include <vector>
 
 struct Heightmap {
     int width = 0;
     int height = 0;
-    std::vector<std::uint16_t> pixels;
+    // Signed rasters (.hgt, signed BIL) hold meters; everything else is
+    // 0..65535 spread over --height-min..--height-max.
+    bool metric = false;
+    Raster raster;
 };
 
 bool loadHeightmap(const std::string& path, Heightmap& out);
 float clamp01(float v);
 float bilinearSample(const Heightmap& hm, float x, float y);
+float sampleHeightMeters(const Heightmap& hm, float x, float y, float heightMin, float heightRange);
+// sampleHeightMeters for a row of points sharing one y, with the blend done
+// by the vectorized kernel; results match the per-point call exactly.
+void sampleHeightMetersRow(const Heightmap& hm, const float* xs, float y, size_t count,
+                           float heightMin, float heightRange, float* out);
@@ -0,0 +1,1046 @@
+#include "tools/terrainc/osm_pbf.hpp"
+#include "utils/stb_image.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+// Limits from the OSM PBF specification.
+constexpr size_t kMaxBlobHeaderBytes = 64 * 1024;
+constexpr size_t kMaxBlobBytes = 32 * 1024 * 1024;
+
+constexpr unsigned kBlockHasNodes = 1u << 0;
+constexpr unsigned kBlockHasWays = 1u << 1;
+constexpr unsigned kBlockHasRelations = 1u << 2;
+
+// Minimal protobuf wire-format reader over a byte range.
+class ProtoReader {
+public:
+    ProtoReader() = default;
+    explicit ProtoReader(std::string_view bytes)
+        : m_pos(reinterpret_cast<const unsigned char*>(bytes.data())),
+          m_end(m_pos + bytes.size()) {}
+
+    // Advances to the next field; false at the end of the message or on malformed input.
+    bool next() {
+        if (m_error || m_pos >= m_end) {
+            return false;
+        }
+        std::uint64_t key = varint();
+        m_field = static_cast<std::uint32_t>(key >> 3);
+        m_wire = static_cast<int>(key & 7);
+        return !m_error;
+    }
+
+    std::uint32_t field() const { return m_field; }
+    int wire() const { return m_wire; }
+    bool atEnd() const { return m_pos >= m_end; }
+    bool failed() const { return m_error; }
+    void fail() { m_error = true; }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (m_pos >= m_end) {
+                m_error = true;
+                return 0;
+            }
+            unsigned char byte = *m_pos++;
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        m_error = true;
+        return 0;
+    }
+
+    std::int64_t svarint() {
+        std::uint64_t v = varint();
+        return static_cast<std::int64_t>((v >> 1) ^ (0 - (v & 1)));
+    }
+
+    std::string_view bytes() {
+        if (m_wire != 2) {
+            m_error = true;
+            return {};
+        }
+        std::uint64_t length = varint();
+        if (m_error || length > static_cast<std::uint64_t>(m_end - m_pos)) {
+            m_error = true;
+            return {};
+        }
+        std::string_view out(reinterpret_cast<const char*>(m_pos), static_cast<size_t>(length));
+        m_pos += length;
+        return out;
+    }
+
+    void skip() {
+        switch (m_wire) {
+        case 0:
+            varint();
+            break;
+        case 1:
+            advance(8);
+            break;
+        case 2:
+            bytes();
+            break;
+        case 5:
+            advance(4);
+            break;
+        default:
+            m_error = true;
+            break;
+        }
+    }
+
+private:
+    void advance(size_t count) {
+        if (count > static_cast<size_t>(m_end - m_pos)) {
+            m_error = true;
+            return;
+        }
+        m_pos += count;
+    }
+
+    const unsigned char* m_pos = nullptr;
+    const unsigned char* m_end = nullptr;
+    std::uint32_t m_field = 0;
+    int m_wire = 0;
+    bool m_error = false;
+};
+
+// Repeated scalars are normally packed, but proto2 writers may emit one varint per field.
+template<typename Fn>
+void readPacked(ProtoReader& reader, Fn&& fn) {
+    if (reader.wire() == 0) {
+        fn(reader.varint());
+        return;
+    }
+    ProtoReader packed(reader.bytes());
+    while (!packed.atEnd() && !packed.failed()) {
+        fn(packed.varint());
+    }
+    if (packed.failed()) {
+        reader.fail();
+    }
+}
+
+std::int64_t zigzag(std::uint64_t v) {
+    return static_cast<std::int64_t>((v >> 1) ^ (0 - (v & 1)));
+}
+
+struct BlockRef {
+    size_t offset = 0;
+    size_t size = 0;
+};
+
+struct PrimitiveBlock {
+    std::vector<std::string_view> strings;
+    std::vector<std::string_view> groups;
+    std::int64_t granularity = 100;
+    std::int64_t latOffset = 0;
+    std::int64_t lonOffset = 0;
+};
+
+// Node position in 1e-7 degree units, the native OSM precision.
+struct NodeCoord {
+    std::int64_t id = 0;
+    std::int32_t lon = 0;
+    std::int32_t lat = 0;
+};
+
+struct WayRecord {
+    std::int64_t id = 0;
+    std::vector<std::int64_t> refs;
+    std::vector<OsmFeatureKind> kinds;
+    bool touchesBounds = false;
+};
+
+struct RelationRecord {
+    std::vector<std::int64_t> outerWays;
+    std::vector<OsmFeatureKind> kinds;
+};
+
+struct BlockResult {
+    unsigned contents = 0;
+    std::vector<NodeCoord> nodes;
+    std::vector<WayRecord> ways;
+    std::vector<RelationRecord> relations;
+    std::string error;
+};
+
+struct DecodeScratch {
+    std::vector<unsigned char> inflated;
+    PrimitiveBlock block;
+    OsmTags tags;
+    std::vector<OsmFeatureKind> kinds;
+    std::vector<std::uint32_t> keys;
+    std::vector<std::uint32_t> vals;
+    std::vector<std::uint32_t> roles;
+    std::vector<std::uint32_t> types;
+};
+
+struct NanoBounds {
+    std::int64_t minLon = 0;
+    std::int64_t minLat = 0;
+    std::int64_t maxLon = 0;
+    std::int64_t maxLat = 0;
+};
+
+bool containsId(const std::vector<std::int64_t>& sorted, std::int64_t id) {
+    return std::binary_search(sorted.begin(), sorted.end(), id);
+}
+
+const NodeCoord* findNode(const std::vector<NodeCoord>& sorted, std::int64_t id) {
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), id,
+        [](const NodeCoord& node, std::int64_t value) { return node.id < value; });
+    if (it == sorted.end() || it->id != id) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+bool inflateBlob(std::string_view blob, std::vector<unsigned char>& buffer, std::string_view& out,
+                 std::string& error) {
+    ProtoReader reader(blob);
+    std::string_view raw;
+    std::string_view zlib;
+    std::int64_t rawSize = -1;
+    bool hasRaw = false;
+    bool unsupported = false;
+    while (reader.next()) {
+        switch (reader.field()) {
+        case 1:
+            raw = reader.bytes();
+            hasRaw = true;
+            break;
+        case 2:
+            rawSize = static_cast<std::int64_t>(reader.varint());
+            break;
+        case 3:
+            zlib = reader.bytes();
+            break;
+        case 4:
+        case 5:
+        case 6:
+        case 7:
+            unsupported = true;
+            reader.skip();
+            break;
+        default:
+            reader.skip();
+            break;
+        }
+    }
+    if (reader.failed()) {
+        error = "malformed blob";
+        return false;
+    }
+    if (hasRaw) {
+        out = raw;
+        return true;
+    }
+    if (zlib.empty()) {
+        error = unsupported ? "unsupported block compression (only zlib and raw are handled)"
+                            : "blob has no data";
+        return false;
+    }
+    if (rawSize <= 0 || static_cast<size_t>(rawSize) > kMaxBlobBytes) {
+        error = "invalid uncompressed block size";
+        return false;
+    }
+    buffer.resize(static_cast<size_t>(rawSize));
+    int written = stbi_zlib_decode_buffer(reinterpret_cast<char*>(buffer.data()), static_cast<int>(rawSize),
+                                          zlib.data(), static_cast<int>(zlib.size()));
+    if (written != rawSize) {
+        error = "zlib inflate failed";
+        return false;
+    }
+    out = std::string_view(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    return true;
+}
+
+bool parsePrimitiveBlock(std::string_view data, PrimitiveBlock& block) {
+    block.strings.clear();
+    block.groups.clear();
+    block.granularity = 100;
+    block.latOffset = 0;
+    block.lonOffset = 0;
+
+    ProtoReader reader(data);
+    while (reader.next()) {
+        switch (reader.field()) {
+        case 1: {
+            ProtoReader table(reader.bytes());
+            while (table.next()) {
+                if (table.field() == 1) {
+                    block.strings.push_back(table.bytes());
+                } else {
+                    table.skip();
+                }
+            }
+            if (table.failed()) {
+                return false;
+            }
+            break;
+        }
+        case 2:
+            block.groups.push_back(reader.bytes());
+            break;
+        case 17:
+            block.granularity = static_cast<std::int64_t>(reader.varint());
+            break;
+        case 19:
+            block.latOffset = static_cast<std::int64_t>(reader.varint());
+            break;
+        case 20:
+            block.lonOffset = static_cast<std::int64_t>(reader.varint());
+            break;
+        default:
+            reader.skip();
+            break;
+        }
+    }
+    return !reader.failed();
+}
+
+bool buildTags(const PrimitiveBlock& block, const std::vector<std::uint32_t>& keys,
+               const std::vector<std::uint32_t>& vals, OsmTags& tags) {
+    tags.clear();
+    if (keys.size() != vals.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] >= block.strings.size() || vals[i] >= block.strings.size()) {
+            return false;
+        }
+        tags.add(block.strings[keys[i]], block.strings[vals[i]]);
+    }
+    return true;
+}
+
+// Which objects a pass is collecting. Each pass only decodes the groups it needs.
+enum class Pass {
+    RelationsAndBoundedNodes,
+    Ways,
+    MissingNodes
+};
+
+struct PassInputs {
+    NanoBounds bounds;
+    const std::vector<NodeCoord>* boundedNodes = nullptr;
+    const std::vector<std::int64_t>* relationWays = nullptr;
+    const std::vector<std::int64_t>* missingNodes = nullptr;
+};
+
+class BlockDecoder {
+public:
+    BlockDecoder(Pass pass, const PassInputs& inputs, const OsmClassifier& classify)
+        : m_pass(pass), m_inputs(inputs), m_classify(classify) {}
+
+    bool decode(std::string_view blob, DecodeScratch& scratch, BlockResult& result) const {
+        std::string_view data;
+        if (!inflateBlob(blob, scratch.inflated, data, result.error)) {
+            return false;
+        }
+        if (!parsePrimitiveBlock(data, scratch.block)) {
+            result.error = "malformed primitive block";
+            return false;
+        }
+        for (std::string_view group : scratch.block.groups) {
+            ProtoReader reader(group);
+            while (reader.next()) {
+                bool ok = true;
+                switch (reader.field()) {
+                case 1:
+                    result.contents |= kBlockHasNodes;
+                    ok = wantsNodes() ? decodeNode(reader.bytes(), scratch, result) : (reader.skip(), true);
+                    break;
+                case 2:
+                    result.contents |= kBlockHasNodes;
+                    ok = wantsNodes() ? decodeDenseNodes(reader.bytes(), scratch, result) : (reader.skip(), true);
+                    break;
+                case 3:
+                    result.contents |= kBlockHasWays;
+                    ok = m_pass == Pass::Ways ? decodeWay(reader.bytes(), scratch, result) : (reader.skip(), true);
+                    break;
+                case 4:
+                    result.contents |= kBlockHasRelations;
+                    ok = m_pass == Pass::RelationsAndBoundedNodes ? decodeRelation(reader.bytes(), scratch, result)
+                                                                  : (reader.skip(), true);
+                    break;
+                default:
+                    reader.skip();
+                    break;
+                }
+                if (!ok) {
+                    reader.fail();
+                }
+            }
+            if (reader.failed()) {
+                if (result.error.empty()) {
+                    result.error = "malformed primitive group";
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    bool wantsNodes() const { return m_pass != Pass::Ways; }
+
+    void acceptNode(const PrimitiveBlock& block, std::int64_t id, std::int64_t lat, std::int64_t lon,
+                    BlockResult& result) const {
+        std::int64_t latNano = block.latOffset + block.granularity * lat;
+        std::int64_t lonNano = block.lonOffset + block.granularity * lon;
+        if (m_pass == Pass::RelationsAndBoundedNodes) {
+            const NanoBounds& b = m_inputs.bounds;
+            if (latNano < b.minLat || latNano > b.maxLat || lonNano < b.minLon || lonNano > b.maxLon) {
+                return;
+            }
+        } else if (!containsId(*m_inputs.missingNodes, id)) {
+            return;
+        }
+        NodeCoord node;
+        node.id = id;
+        node.lon = static_cast<std::int32_t>(lonNano / 100);
+        node.lat = static_cast<std::int32_t>(latNano / 100);
+        result.nodes.push_back(node);
+    }
+
+    bool decodeNode(std::string_view data, DecodeScratch& scratch, BlockResult& result) const {
+        ProtoReader reader(data);
+        std::int64_t id = 0;
+        std::int64_t lat = 0;
+        std::int64_t lon = 0;
+        while (reader.next()) {
+            switch (reader.field()) {
+            case 1:
+                id = reader.svarint();
+                break;
+            case 8:
+                lat = reader.svarint();
+                break;
+            case 9:
+                lon = reader.svarint();
+                break;
+            default:
+                reader.skip();
+                break;
+            }
+        }
+        if (reader.failed()) {
+            return false;
+        }
+        acceptNode(scratch.block, id, lat, lon, result);
+        return true;
+    }
+
+    bool decodeDenseNodes(std::string_view data, DecodeScratch& scratch, BlockResult& result) const {
+        ProtoReader reader(data);
+        std::string_view ids;
+        std::string_view lats;
+        std::string_view lons;
+        while (reader.next()) {
+            switch (reader.field()) {
+            case 1:
+                ids = reader.bytes();
+                break;
+            case 8:
+                lats = reader.bytes();
+                break;
+            case 9:
+                lons = reader.bytes();
+                break;
+            default:
+                reader.skip();
+                break;
+            }
+        }
+        if (reader.failed()) {
+            return false;
+        }
+        ProtoReader idReader(ids);
+        ProtoReader latReader(lats);
+        ProtoReader lonReader(lons);
+        std::int64_t id = 0;
+        std::int64_t lat = 0;
+        std::int64_t lon = 0;
+        while (!idReader.atEnd()) {
+            id += zigzag(idReader.varint());
+            lat += zigzag(latReader.varint());
+            lon += zigzag(lonReader.varint());
+            if (idReader.failed() || latReader.failed() || lonReader.failed()) {
+                return false;
+            }
+            acceptNode(scratch.block, id, lat, lon, result);
+        }
+        return true;
+    }
+
+    bool decodeWay(std::string_view data, DecodeScratch& scratch, BlockResult& result) const {
+        ProtoReader reader(data);
+        std::int64_t id = 0;
+        std::string_view refs;
+        scratch.keys.clear();
+        scratch.vals.clear();
+        while (reader.next()) {
+            switch (reader.field()) {
+            case 1:
+                id = static_cast<std::int64_t>(reader.varint());
+                break;
+            case 2:
+                readPacked(reader, [&](std::uint64_t v) { scratch.keys.push_back(static_cast<std::uint32_t>(v)); });
+                break;
+            case 3:
+                readPacked(reader, [&](std::uint64_t v) { scratch.vals.push_back(static_cast<std::uint32_t>(v)); });
+                break;
+            case 8:
+                refs = reader.bytes();
+                break;
+            default:
+                reader.skip();
+                break;
+            }
+        }
+        if (reader.failed() || !buildTags(scratch.block, scratch.keys, scratch.vals, scratch.tags)) {
+            return false;
+        }
+
+        scratch.kinds.clear();
+        if (!scratch.tags.empty()) {
+            m_classify(scratch.tags, scratch.kinds);
+        }
+        bool relationMember = containsId(*m_inputs.relationWays, id);
+        if (scratch.kinds.empty() && !relationMember) {
+            return true;
+        }
+
+        WayRecord way;
+        way.id = id;
+        ProtoReader refReader(refs);
+        std::int64_t ref = 0;
+        while (!refReader.atEnd()) {
+            ref += zigzag(refReader.varint());
+            if (refReader.failed()) {
+                return false;
+            }
+            way.refs.push_back(ref);
+            if (!way.touchesBounds && findNode(*m_inputs.boundedNodes, ref)) {
+                way.touchesBounds = true;
+            }
+        }
+        if (!way.touchesBounds && !relationMember) {
+            return true;
+        }
+        if (way.touchesBounds) {
+            way.kinds = scratch.kinds;
+        }
+        result.ways.push_back(std::move(way));
+        return true;
+    }
+
+    bool decodeRelation(std::string_view data, DecodeScratch& scratch, BlockResult& result) const {
+        ProtoReader reader(data);
+        std::string_view memids;
+        scratch.keys.clear();
+        scratch.vals.clear();
+        scratch.roles.clear();
+        scratch.types.clear();
+        while (reader.next()) {
+            switch (reader.field()) {
+            case 2:
+                readPacked(reader, [&](std::uint64_t v) { scratch.keys.push_back(static_cast<std::uint32_t>(v)); });
+                break;
+            case 3:
+                readPacked(reader, [&](std::uint64_t v) { scratch.vals.push_back(static_cast<std::uint32_t>(v)); });
+                break;
+            case 8:
+                readPacked(reader, [&](std::uint64_t v) { scratch.roles.push_back(static_cast<std::uint32_t>(v)); });
+                break;
+            case 9:
+                memids = reader.bytes();
+                break;
+            case 10:
+                readPacked(reader, [&](std::uint64_t v) { scratch.types.push_back(static_cast<std::uint32_t>(v)); });
+                break;
+            default:
+                reader.skip();
+                break;
+            }
+        }
+        if (reader.failed() || !buildTags(scratch.block, scratch.keys, scratch.vals, scratch.tags)) {
+            return false;
+        }
+        std::string_view type = scratch.tags.get("type");
+        if (type != "multipolygon" && type != "boundary") {
+            return true;
+        }
+
+        scratch.kinds.clear();
+        m_classify(scratch.tags, scratch.kinds);
+        scratch.kinds.erase(std::remove_if(scratch.kinds.begin(), scratch.kinds.end(),
+                                           [](const OsmFeatureKind& kind) { return !kind.area; }),
+                            scratch.kinds.end());
+        if (scratch.kinds.empty()) {
+            return true;
+        }
+
+        RelationRecord relation;
+        relation.kinds = scratch.kinds;
+        ProtoReader idReader(memids);
+        std::int64_t memberId = 0;
+        for (size_t i = 0; !idReader.atEnd(); ++i) {
+            memberId += zigzag(idReader.varint());
+            if (idReader.failed() || i >= scratch.roles.size() || i >= scratch.types.size()) {
+                return false;
+            }
+            if (scratch.types[i] != 1 || scratch.roles[i] >= scratch.block.strings.size()) {
+                continue;
+            }
+            std::string_view role = scratch.block.strings[scratch.roles[i]];
+            if (role == "outer" || role.empty()) {
+                relation.outerWays.push_back(memberId);
+            }
+        }
+        if (!relation.outerWays.empty()) {
+            result.relations.push_back(std::move(relation));
+        }
+        return true;
+    }
+
+    Pass m_pass;
+    const PassInputs& m_inputs;
+    const OsmClassifier& m_classify;
+};
+
+class MappedFile {
+public:
+    ~MappedFile() {
+        if (m_data) {
+            munmap(const_cast<unsigned char*>(m_data), m_size);
+        }
+    }
+
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Failed to open OSM PBF: " << path << "\n";
+            return false;
+        }
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            std::cerr << "Failed to stat OSM PBF: " << path << "\n";
+            return false;
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Failed to map OSM PBF: " << path << "\n";
+            return false;
+        }
+        m_data = static_cast<const unsigned char*>(mapped);
+        m_size = size;
+        return true;
+    }
+
+    std::string_view view(size_t offset, size_t size) const {
+        return std::string_view(reinterpret_cast<const char*>(m_data) + offset, size);
+    }
+    const unsigned char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+bool checkHeaderBlock(std::string_view blob, const std::string& path) {
+    std::vector<unsigned char> buffer;
+    std::string_view data;
+    std::string error;
+    if (!inflateBlob(blob, buffer, data, error)) {
+        std::cerr << "Failed to read OSM header block (" << error << "): " << path << "\n";
+        return false;
+    }
+    ProtoReader reader(data);
+    while (reader.next()) {
+        if (reader.field() != 4) {
+            reader.skip();
+            continue;
+        }
+        std::string_view feature = reader.bytes();
+        if (feature != "OsmSchema-V0.6" && feature != "DenseNodes") {
+            std::cerr << "OSM PBF requires unsupported feature " << feature << ": " << path << "\n";
+            return false;
+        }
+    }
+    if (reader.failed()) {
+        std::cerr << "Malformed OSM header block: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Walks the BlobHeader/Blob framing without inflating anything.
+bool indexBlocks(const MappedFile& file, const std::string& path, std::vector<BlockRef>& blocks) {
+    const unsigned char* data = file.data();
+    size_t size = file.size();
+    size_t pos = 0;
+    while (pos < size) {
+        if (size - pos < 4) {
+            std::cerr << "Truncated OSM PBF: " << path << "\n";
+            return false;
+        }
+        size_t headerSize = (static_cast<size_t>(data[pos]) << 24) | (static_cast<size_t>(data[pos + 1]) << 16) |
+                            (static_cast<size_t>(data[pos + 2]) << 8) | static_cast<size_t>(data[pos + 3]);
+        pos += 4;
+        if (headerSize > kMaxBlobHeaderBytes || headerSize > size - pos) {
+            std::cerr << "Invalid OSM blob header at offset " << pos << ": " << path << "\n";
+            return false;
+        }
+        ProtoReader header(file.view(pos, headerSize));
+        std::string_view type;
+        size_t dataSize = 0;
+        while (header.next()) {
+            if (header.field() == 1) {
+                type = header.bytes();
+            } else if (header.field() == 3) {
+                dataSize = static_cast<size_t>(header.varint());
+            } else {
+                header.skip();
+            }
+        }
+        pos += headerSize;
+        if (header.failed() || dataSize > kMaxBlobBytes || dataSize > size - pos) {
+            std::cerr << "Invalid OSM blob at offset " << pos << ": " << path << "\n";
+            return false;
+        }
+        if (type == "OSMHeader") {
+            if (!checkHeaderBlock(file.view(pos, dataSize), path)) {
+                return false;
+            }
+        } else if (type == "OSMData") {
+            blocks.push_back({pos, dataSize});
+        }
+        pos += dataSize;
+    }
+    return true;
+}
+
+int resolveThreads(int requested, size_t work) {
+    int threads = requested;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    return std::max(1, std::min(threads, static_cast<int>(std::max<size_t>(1, work))));
+}
+
+// Decodes the listed blocks on a worker pool. Results land in per-block slots,
+// so the merged output does not depend on scheduling.
+bool runPass(const MappedFile& file, const std::vector<BlockRef>& blocks, const std::vector<size_t>& selection,
+             int threads, const BlockDecoder& decoder, std::vector<BlockResult>& results,
+             const std::string& path) {
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    auto worker = [&]() {
+        DecodeScratch scratch;
+        while (!failed.load(std::memory_order_relaxed)) {
+            size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= selection.size()) {
+                break;
+            }
+            size_t index = selection[i];
+            const BlockRef& block = blocks[index];
+            if (!decoder.decode(file.view(block.offset, block.size), scratch, results[index])) {
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    int threadCount = resolveThreads(threads, selection.size());
+    if (threadCount == 1) {
+        worker();
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(static_cast<size_t>(threadCount));
+        for (int i = 0; i < threadCount; ++i) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+    }
+
+    for (size_t index : selection) {
+        if (!results[index].error.empty()) {
+            std::cerr << "Failed to decode OSM block at offset " << blocks[index].offset << " ("
+                      << results[index].error << "): " << path << "\n";
+            return false;
+        }
+    }
+    return !failed.load();
+}
+
+std::vector<NodeCoord> takeSortedNodes(std::vector<BlockResult>& results) {
+    std::vector<NodeCoord> nodes;
+    size_t count = 0;
+    for (const auto& result : results) {
+        count += result.nodes.size();
+    }
+    nodes.reserve(count);
+    for (auto& result : results) {
+        nodes.insert(nodes.end(), result.nodes.begin(), result.nodes.end());
+        std::vector<NodeCoord>().swap(result.nodes);
+    }
+    auto byId = [](const NodeCoord& a, const NodeCoord& b) { return a.id < b.id; };
+    if (!std::is_sorted(nodes.begin(), nodes.end(), byId)) {
+        std::sort(nodes.begin(), nodes.end(), byId);
+    }
+    return nodes;
+}
+
+void sortUnique(std::vector<std::int64_t>& ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+// Joins member ways end to end into closed rings; open chains are dropped.
+void assembleRings(const std::vector<const WayRecord*>& members, std::vector<std::vector<std::int64_t>>& rings) {
+    std::unordered_multimap<std::int64_t, size_t> endpoints;
+    std::vector<bool> used(members.size(), false);
+    for (size_t i = 0; i < members.size(); ++i) {
+        const auto& refs = members[i]->refs;
+        if (refs.size() < 2) {
+            used[i] = true;
+            continue;
+        }
+        endpoints.emplace(refs.front(), i);
+        endpoints.emplace(refs.back(), i);
+    }
+
+    auto takeAt = [&](std::int64_t node) -> size_t {
+        auto range = endpoints.equal_range(node);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (!used[it->second]) {
+                return it->second;
+            }
+        }
+        return members.size();
+    };
+
+    for (size_t start = 0; start < members.size(); ++start) {
+        if (used[start]) {
+            continue;
+        }
+        used[start] = true;
+        std::vector<std::int64_t> ring = members[start]->refs;
+        while (ring.front() != ring.back()) {
+            size_t nextIndex = takeAt(ring.back());
+            if (nextIndex == members.size()) {
+                break;
+            }
+            used[nextIndex] = true;
+            const auto& refs = members[nextIndex]->refs;
+            if (refs.front() == ring.back()) {
+                ring.insert(ring.end(), refs.begin() + 1, refs.end());
+            } else {
+                ring.insert(ring.end(), refs.rbegin() + 1, refs.rend());
+            }
+        }
+        if (ring.size() >= 4 && ring.front() == ring.back()) {
+            rings.push_back(std::move(ring));
+        }
+    }
+}
+} // namespace
+
+bool readOsmPbf(const std::string& path, const OsmReadOptions& options,
+                const OsmClassifier& classify, OsmExtract& out) {
+    out = OsmExtract{};
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    std::vector<BlockRef> blocks;
+    if (!indexBlocks(file, path, blocks)) {
+        return false;
+    }
+    out.blocks = blocks.size();
+
+    PassInputs inputs;
+    inputs.bounds.minLon = std::llround(options.minLon * 1e9);
+    inputs.bounds.minLat = std::llround(options.minLat * 1e9);
+    inputs.bounds.maxLon = std::llround(options.maxLon * 1e9);
+    inputs.bounds.maxLat = std::llround(options.maxLat * 1e9);
+
+    // Pass 1: every block once, keeping nodes inside the bounds and the
+    // multipolygon relations we classify, and noting which object types each
+    // block holds so the later passes can skip blocks outright.
+    std::vector<BlockResult> results(blocks.size());
+    std::vector<size_t> allBlocks(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        allBlocks[i] = i;
+    }
+    if (!runPass(file, blocks, allBlocks, options.threads,
+                 BlockDecoder(Pass::RelationsAndBoundedNodes, inputs, classify), results, path)) {
+        return false;
+    }
+    std::vector<NodeCoord> boundedNodes = takeSortedNodes(results);
+    std::vector<RelationRecord> relations;
+    std::vector<std::int64_t> relationWays;
+    std::vector<size_t> wayBlocks;
+    std::vector<size_t> nodeBlocks;
+    for (size_t i = 0; i < results.size(); ++i) {
+        for (auto& relation : results[i].relations) {
+            relationWays.insert(relationWays.end(), relation.outerWays.begin(), relation.outerWays.end());
+            relations.push_back(std::move(relation));
+        }
+        if (results[i].contents & kBlockHasWays) {
+            wayBlocks.push_back(i);
+        }
+        if (results[i].contents & kBlockHasNodes) {
+            nodeBlocks.push_back(i);
+        }
+        results[i] = BlockResult{};
+    }
+    sortUnique(relationWays);
+    inputs.boundedNodes = &boundedNodes;
+    inputs.relationWays = &relationWays;
+
+    // Pass 2: ways that are classified and touch the bounds, plus every outer
+    // member of a candidate relation.
+    if (!runPass(file, blocks, wayBlocks, options.threads, BlockDecoder(Pass::Ways, inputs, classify),
+                 results, path)) {
+        return false;
+    }
+    std::vector<WayRecord> ways;
+    for (size_t index : wayBlocks) {
+        for (auto& way : results[index].ways) {
+            ways.push_back(std::move(way));
+        }
+        results[index] = BlockResult{};
+    }
+    std::unordered_map<std::int64_t, size_t> wayById;
+    wayById.reserve(ways.size());
+    for (size_t i = 0; i < ways.size(); ++i) {
+        wayById.emplace(ways[i].id, i);
+    }
+
+    std::vector<const RelationRecord*> keptRelations;
+    for (const auto& relation : relations) {
+        for (std::int64_t wayId : relation.outerWays) {
+            auto it = wayById.find(wayId);
+            if (it != wayById.end() && ways[it->second].touchesBounds) {
+                keptRelations.push_back(&relation);
+                break;
+            }
+        }
+    }
+
+    // Pass 3: coordinates of the nodes those ways reference outside the bounds.
+    std::vector<std::int64_t> missing;
+    auto collectMissing = [&](const WayRecord& way) {
+        for (std::int64_t ref : way.refs) {
+            if (!findNode(boundedNodes, ref)) {
+                missing.push_back(ref);
+            }
+        }
+    };
+    for (const auto& way : ways) {
+        if (!way.kinds.empty()) {
+            collectMissing(way);
+        }
+    }
+    for (const RelationRecord* relation : keptRelations) {
+        for (std::int64_t wayId : relation->outerWays) {
+            auto it = wayById.find(wayId);
+            if (it != wayById.end() && ways[it->second].kinds.empty()) {
+                collectMissing(ways[it->second]);
+            }
+        }
+    }
+    sortUnique(missing);
+    std::vector<NodeCoord> outsideNodes;
+    if (!missing.empty()) {
+        inputs.missingNodes = &missing;
+        if (!runPass(file, blocks, nodeBlocks, options.threads, BlockDecoder(Pass::MissingNodes, inputs, classify),
+                     results, path)) {
+            return false;
+        }
+        outsideNodes = takeSortedNodes(results);
+    }
+    out.nodesInBounds = boundedNodes.size();
+    out.nodesOutside = outsideNodes.size();
+
+    auto lookup = [&](std::int64_t id) -> const NodeCoord* {
+        const NodeCoord* node = findNode(boundedNodes, id);
+        return node ? node : findNode(outsideNodes, id);
+    };
+    auto emit = [&](const OsmFeatureKind& kind, const std::vector<std::int64_t>& refs) {
+        OsmFeature feature;
+        feature.kind = kind;
+        feature.points.reserve(refs.size());
+        for (std::int64_t ref : refs) {
+            const NodeCoord* node = lookup(ref);
+            if (!node) {
+                continue;
+            }
+            feature.points.push_back({node->lon * 1e-7, node->lat * 1e-7});
+        }
+        size_t minPoints = kind.area ? 4 : 2;
+        if (feature.points.size() >= minPoints) {
+            out.features.push_back(std::move(feature));
+        }
+    };
+
+    for (const auto& way : ways) {
+        if (way.kinds.empty()) {
+            continue;
+        }
+        ++out.ways;
+        bool closed = way.refs.size() >= 4 && way.refs.front() == way.refs.back();
+        for (const auto& kind : way.kinds) {
+            if (!kind.area || closed) {
+                emit(kind, way.refs);
+            }
+        }
+    }
+
+    std::vector<const WayRecord*> members;
+    std::vector<std::vector<std::int64_t>> rings;
+    for (const RelationRecord* relation : keptRelations) {
+        members.clear();
+        rings.clear();
+        for (std::int64_t wayId : relation->outerWays) {
+            auto it = wayById.find(wayId);
+            if (it != wayById.end()) {
+                members.push_back(&ways[it->second]);
+            }
+        }
+        assembleRings(members, rings);
+        if (rings.empty()) {
+            continue;
+        }
+        ++out.relations;
+        for (const auto& kind : relation->kinds) {
+            for (const auto& ring : rings) {
+                emit(kind, ring);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Tags of one OSM object. The views point into the decoded block and are only
+// valid for the duration of the classifier call.
+class OsmTags {
+public:
+    std::string_view get(std::string_view key) const {
+        for (const auto& tag : m_tags) {
+            if (tag.first == key) {
+                return tag.second;
+            }
+        }
+        return {};
+    }
+    bool has(std::string_view key) const {
+        for (const auto& tag : m_tags) {
+            if (tag.first == key) {
+                return true;
+            }
+        }
+        return false;
+    }
+    bool empty() const { return m_tags.empty(); }
+    void clear() { m_tags.clear(); }
+    void add(std::string_view key, std::string_view value) { m_tags.emplace_back(key, value); }
+
+private:
+    std::vector<std::pair<std::string_view, std::string_view>> m_tags;
+};
+
+// What a way or relation contributes to the output. An object may produce
+// several features, e.g. a closed way tagged both landuse and water.
+struct OsmFeatureKind {
+    int classId = 0;
+    bool area = false;  // closed outer rings instead of a polyline
+    float width = 0.0f;
+};
+
+struct OsmLonLat {
+    double lon = 0.0;
+    double lat = 0.0;
+};
+
+struct OsmFeature {
+    OsmFeatureKind kind;
+    std::vector<OsmLonLat> points;  // polyline, or a closed ring whose last point repeats the first
+};
+
+struct OsmReadOptions {
+    double minLon = 0.0;
+    double minLat = 0.0;
+    double maxLon = 0.0;
+    double maxLat = 0.0;
+    int threads = 1;  // 0 = all hardware threads
+};
+
+struct OsmExtract {
+    std::vector<OsmFeature> features;
+    size_t blocks = 0;
+    size_t nodesInBounds = 0;
+    size_t nodesOutside = 0;
+    size_t ways = 0;
+    size_t relations = 0;
+};
+
+// Appends the features an object's tags produce. Called concurrently from the
+// decode threads, so it must not touch shared mutable state.
+using OsmClassifier = std::function<void(const OsmTags& tags, std::vector<OsmFeatureKind>& out)>;
+
+// Streams an OSM PBF file (zlib or raw blocks) and returns every classified
+// feature touching the bounds. Ways are kept whole when any of their nodes is
+// inside; areas come from closed ways and from the outer rings of
+// multipolygon/boundary relations. Inner rings are not emitted.
+bool readOsmPbf(const std::string& path, const OsmReadOptions& options,
+                const OsmClassifier& classify, OsmExtract& out);
@@ -0,0 +1,363 @@
+#include "tools/terrainc/raster.hpp"
+#include "utils/stb_image.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr char kTiledMagic[4] = {'N', 'T', 'R', '1'};
+constexpr size_t kTiledHeaderBytes = 4096;
+
+std::string lowerExtension(const std::string& path) {
+    std::string ext = std::filesystem::path(path).extension().string();
+    for (char& c : ext) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return ext;
+}
+
+size_t bytesPerSample(RasterSampleType type) {
+    return type == RasterSampleType::U8 ? 1 : 2;
+}
+
+std::uint32_t readU32(const unsigned char* p) {
+    return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+           (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+void writeU32(unsigned char* p, std::uint32_t v) {
+    p[0] = static_cast<unsigned char>(v & 0xff);
+    p[1] = static_cast<unsigned char>((v >> 8) & 0xff);
+    p[2] = static_cast<unsigned char>((v >> 16) & 0xff);
+    p[3] = static_cast<unsigned char>((v >> 24) & 0xff);
+}
+
+bool readHdr(const std::string& path, std::unordered_map<std::string, std::string>& out) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream ss(line);
+        std::string key;
+        std::string value;
+        if (!(ss >> key >> value)) {
+            continue;
+        }
+        for (char& c : key) {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        for (char& c : value) {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        out[key] = value;
+    }
+    return true;
+}
+}
+
+Raster::~Raster() {
+    release();
+}
+
+Raster::Raster(Raster&& other) noexcept {
+    *this = std::move(other);
+}
+
+Raster& Raster::operator=(Raster&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    release();
+    m_width = other.m_width;
+    m_height = other.m_height;
+    m_type = other.m_type;
+    m_bigEndian = other.m_bigEndian;
+    m_tileSize = other.m_tileSize;
+    m_tilesX = other.m_tilesX;
+    m_mapped = other.m_mapped;
+    m_mappedSize = other.m_mappedSize;
+    m_owned = std::move(other.m_owned);
+    m_hasGeo = other.m_hasGeo;
+    std::copy(other.m_geo, other.m_geo + 6, m_geo);
+    if (m_mapped) {
+        m_data = other.m_data;
+    } else {
+        m_data = m_owned.empty() ? nullptr : m_owned.data();
+    }
+    other.m_data = nullptr;
+    other.m_mapped = nullptr;
+    other.m_mappedSize = 0;
+    other.m_width = 0;
+    other.m_height = 0;
+    return *this;
+}
+
+void Raster::release() {
+    if (m_mapped) {
+        munmap(m_mapped, m_mappedSize);
+    }
+    m_mapped = nullptr;
+    m_mappedSize = 0;
+    m_owned.clear();
+    m_data = nullptr;
+}
+
+bool Raster::open(const std::string& path) {
+    release();
+    m_width = 0;
+    m_height = 0;
+    m_type = RasterSampleType::U16;
+    m_bigEndian = false;
+    m_tileSize = 0;
+    m_tilesX = 0;
+    m_hasGeo = false;
+
+    std::string ext = lowerExtension(path);
+    bool ok = false;
+    if (ext == ".hgt") {
+        ok = openHgt(path);
+    } else if (ext == ".bil" || ext == ".raw") {
+        ok = openBil(path);
+    } else if (ext == ".ntr") {
+        ok = openTiled(path);
+    } else {
+        ok = openDecoded(path);
+    }
+    if (!ok) {
+        release();
+    }
+    return ok;
+}
+
+bool Raster::headerGeoTransform(double out[6]) const {
+    if (!m_hasGeo) {
+        return false;
+    }
+    std::copy(m_geo, m_geo + 6, out);
+    return true;
+}
+
+bool Raster::mapFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open raster: " << path << "\n";
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        std::cerr << "Failed to stat raster: " << path << "\n";
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Failed to map raster: " << path << "\n";
+        return false;
+    }
+    m_mapped = mapped;
+    m_mappedSize = size;
+    m_data = static_cast<const unsigned char*>(mapped);
+    return true;
+}
+
+bool Raster::openHgt(const std::string& path) {
+    if (!mapFile(path)) {
+        return false;
+    }
+    size_t samples = m_mappedSize / 2;
+    int side = static_cast<int>(std::lround(std::sqrt(static_cast<double>(samples))));
+    if (side <= 1 || static_cast<size_t>(side) * static_cast<size_t>(side) * 2 != m_mappedSize) {
+        std::cerr << "Unexpected .hgt size: " << path << "\n";
+        return false;
+    }
+    m_width = side;
+    m_height = side;
+    m_type = RasterSampleType::S16;
+    m_bigEndian = true;
+    return true;
+}
+
+bool Raster::openBil(const std::string& path) {
+    std::string hdrPath = std::filesystem::path(path).replace_extension(".hdr").string();
+    std::unordered_map<std::string, std::string> hdr;
+    if (!readHdr(hdrPath, hdr)) {
+        std::cerr << "Raw raster requires a header: " << hdrPath << "\n";
+        return false;
+    }
+    auto number = [&](const char* key, double fallback) {
+        auto it = hdr.find(key);
+        if (it == hdr.end()) return fallback;
+        try {
+            return std::stod(it->second);
+        } catch (...) {
+            return fallback;
+        }
+    };
+
+    int cols = static_cast<int>(number("NCOLS", 0.0));
+    int rows = static_cast<int>(number("NROWS", 0.0));
+    int bits = static_cast<int>(number("NBITS", 8.0));
+    int bands = static_cast<int>(number("NBANDS", 1.0));
+    size_t skip = static_cast<size_t>(number("SKIPBYTES", 0.0));
+    std::string pixelType = hdr.count("PIXELTYPE") ? hdr["PIXELTYPE"] : "UNSIGNEDINT";
+    std::string byteOrder = hdr.count("BYTEORDER") ? hdr["BYTEORDER"] : "I";
+    if (cols <= 0 || rows <= 0 || bands != 1 || (bits != 8 && bits != 16)) {
+        std::cerr << "Unsupported raw raster layout in " << hdrPath
+                  << " (need one 8- or 16-bit band)\n";
+        return false;
+    }
+    if (bits == 8) {
+        m_type = RasterSampleType::U8;
+    } else {
+        m_type = pixelType == "SIGNEDINT" ? RasterSampleType::S16 : RasterSampleType::U16;
+    }
+    m_bigEndian = (byteOrder == "M" || byteOrder == "MOTOROLA");
+    m_width = cols;
+    m_height = rows;
+
+    if (hdr.count("ULXMAP") && hdr.count("ULYMAP")) {
+        double xdim = number("XDIM", 1.0);
+        double ydim = number("YDIM", 1.0);
+        // ULXMAP/ULYMAP name the center of the upper-left pixel.
+        m_geo[0] = number("ULXMAP", 0.0) - xdim * 0.5;
+        m_geo[1] = xdim;
+        m_geo[2] = 0.0;
+        m_geo[3] = number("ULYMAP", 0.0) + ydim * 0.5;
+        m_geo[4] = 0.0;
+        m_geo[5] = -ydim;
+        m_hasGeo = true;
+    }
+
+    if (!mapFile(path)) {
+        return false;
+    }
+    size_t needed = skip + static_cast<size_t>(cols) * static_cast<size_t>(rows) * bytesPerSample(m_type);
+    if (m_mappedSize < needed) {
+        std::cerr << "Raw raster is smaller than its header describes: " << path << "\n";
+        return false;
+    }
+    m_data += skip;
+    return true;
+}
+
+bool Raster::openTiled(const std::string& path) {
+    if (!mapFile(path)) {
+        return false;
+    }
+    if (m_mappedSize < kTiledHeaderBytes || std::memcmp(m_data, kTiledMagic, 4) != 0) {
+        std::cerr << "Not a tiled raster: " << path << "\n";
+        return false;
+    }
+    m_width = static_cast<int>(readU32(m_data + 4));
+    m_height = static_cast<int>(readU32(m_data + 8));
+    m_tileSize = readU32(m_data + 12);
+    std::uint32_t type = readU32(m_data + 16);
+    if (m_width <= 0 || m_height <= 0 || m_tileSize == 0 || type > 2) {
+        std::cerr << "Invalid tiled raster header: " << path << "\n";
+        return false;
+    }
+    m_type = static_cast<RasterSampleType>(type);
+    m_tilesX = (static_cast<size_t>(m_width) + m_tileSize - 1) / m_tileSize;
+    size_t tilesY = (static_cast<size_t>(m_height) + m_tileSize - 1) / m_tileSize;
+    size_t needed = kTiledHeaderBytes +
+        m_tilesX * tilesY * m_tileSize * m_tileSize * bytesPerSample(m_type);
+    if (m_mappedSize < needed) {
+        std::cerr << "Tiled raster is truncated: " << path << "\n";
+        return false;
+    }
+    m_data += kTiledHeaderBytes;
+    // Tiles are visited roughly in terrain-tile order, not file order.
+    madvise(m_mapped, m_mappedSize, MADV_RANDOM);
+    return true;
+}
+
+bool Raster::openDecoded(const std::string& path) {
+    int w = 0;
+    int h = 0;
+    int ch = 0;
+    if (stbi_is_16_bit(path.c_str())) {
+        std::uint16_t* data = stbi_load_16(path.c_str(), &w, &h, &ch, 1);
+        if (!data) {
+            return false;
+        }
+        size_t count = static_cast<size_t>(w) * static_cast<size_t>(h);
+        m_owned.resize(count * 2);
+        for (size_t i = 0; i < count; ++i) {
+            m_owned[i * 2] = static_cast<unsigned char>(data[i] & 0xff);
+            m_owned[i * 2 + 1] = static_cast<unsigned char>(data[i] >> 8);
+        }
+        stbi_image_free(data);
+        m_type = RasterSampleType::U16;
+    } else {
+        unsigned char* data = stbi_load(path.c_str(), &w, &h, &ch, 1);
+        if (!data) {
+            return false;
+        }
+        m_owned.assign(data, data + static_cast<size_t>(w) * static_cast<size_t>(h));
+        stbi_image_free(data);
+        m_type = RasterSampleType::U8;
+    }
+    m_width = w;
+    m_height = h;
+    m_data = m_owned.data();
+    return true;
+}
+
+bool writeTiledRaster(const Raster& raster, const std::string& path, int tileSize) {
+    if (!raster.valid() || tileSize <= 0) {
+        return false;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    std::vector<unsigned char> header(kTiledHeaderBytes, 0);
+    std::memcpy(header.data(), kTiledMagic, 4);
+    writeU32(header.data() + 4, static_cast<std::uint32_t>(raster.width()));
+    writeU32(header.data() + 8, static_cast<std::uint32_t>(raster.height()));
+    writeU32(header.data() + 12, static_cast<std::uint32_t>(tileSize));
+    writeU32(header.data() + 16, static_cast<std::uint32_t>(raster.sampleType()));
+    out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+
+    size_t bps = bytesPerSample(raster.sampleType());
+    int tilesX = (raster.width() + tileSize - 1) / tileSize;
+    int tilesY = (raster.height() + tileSize - 1) / tileSize;
+    std::vector<unsigned char> tile(static_cast<size_t>(tileSize) * static_cast<size_t>(tileSize) * bps);
+    for (int ty = 0; ty < tilesY; ++ty) {
+        for (int tx = 0; tx < tilesX; ++tx) {
+            std::fill(tile.begin(), tile.end(), 0);
+            for (int ly = 0; ly < tileSize; ++ly) {
+                int y = ty * tileSize + ly;
+                if (y >= raster.height()) break;
+                for (int lx = 0; lx < tileSize; ++lx) {
+                    int x = tx * tileSize + lx;
+                    if (x >= raster.width()) break;
+                    std::uint32_t v = static_cast<std::uint32_t>(raster.at(x, y));
+                    unsigned char* p = tile.data() + (static_cast<size_t>(ly) * tileSize + lx) * bps;
+                    p[0] = static_cast<unsigned char>(v & 0xff);
+                    if (bps == 2) {
+                        p[1] = static_cast<unsigned char>((v >> 8) & 0xff);
+                    }
+                }
+            }
+            out.write(reinterpret_cast<const char*>(tile.data()), static_cast<std::streamsize>(tile.size()));
+        }
+    }
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class RasterSampleType : std::uint32_t {
+    U8 = 0,
+    U16 = 1,
+    S16 = 2
+};
+
+// Single-band raster that resolves pixels on demand. File-backed formats are
+// memory-mapped, so sampling a window only faults in the pages it touches:
+//   .hgt        SRTM tile, big-endian int16 meters, square
+//   .bil/.raw   headerless samples described by an ESRI .hdr sidecar
+//   .ntr        tiled layout written by writeTiledRaster
+// Anything else (PNG, PGM, ...) is decoded into memory through stb_image.
+class Raster {
+public:
+    Raster() = default;
+    ~Raster();
+    Raster(const Raster&) = delete;
+    Raster& operator=(const Raster&) = delete;
+    Raster(Raster&& other) noexcept;
+    Raster& operator=(Raster&& other) noexcept;
+
+    bool open(const std::string& path);
+
+    bool valid() const { return m_data != nullptr; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    RasterSampleType sampleType() const { return m_type; }
+    bool isMapped() const { return m_mapped != nullptr; }
+
+    // Pixel-edge geotransform (GDAL order) read from a .hdr sidecar, if present.
+    bool headerGeoTransform(double out[6]) const;
+
+    std::int32_t at(int x, int y) const {
+        size_t index;
+        if (m_tileSize > 0) {
+            size_t tx = static_cast<size_t>(x) / m_tileSize;
+            size_t ty = static_cast<size_t>(y) / m_tileSize;
+            size_t lx = static_cast<size_t>(x) % m_tileSize;
+            size_t ly = static_cast<size_t>(y) % m_tileSize;
+            index = (ty * m_tilesX + tx) * m_tileSize * m_tileSize + ly * m_tileSize + lx;
+        } else {
+            index = static_cast<size_t>(y) * static_cast<size_t>(m_width) + static_cast<size_t>(x);
+        }
+        switch (m_type) {
+        case RasterSampleType::U8:
+            return m_data[index];
+        case RasterSampleType::U16:
+            return static_cast<std::uint16_t>(read16(index));
+        case RasterSampleType::S16:
+            return static_cast<std::int16_t>(read16(index));
+        }
+        return 0;
+    }
+
+private:
+    std::uint16_t read16(size_t index) const {
+        const unsigned char* p = m_data + index * 2;
+        if (m_bigEndian) {
+            return static_cast<std::uint16_t>((p[0] << 8) | p[1]);
+        }
+        return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    bool openHgt(const std::string& path);
+    bool openBil(const std::string& path);
+    bool openTiled(const std::string& path);
+    bool openDecoded(const std::string& path);
+    bool mapFile(const std::string& path);
+    void release();
+
+    int m_width = 0;
+    int m_height = 0;
+    RasterSampleType m_type = RasterSampleType::U16;
+    bool m_bigEndian = false;
+    size_t m_tileSize = 0;
+    size_t m_tilesX = 0;
+    const unsigned char* m_data = nullptr;
+
+    void* m_mapped = nullptr;
+    size_t m_mappedSize = 0;
+    std::vector<unsigned char> m_owned;
+
+    bool m_hasGeo = false;
+    double m_geo[6] = {0.0, 1.0, 0.0, 0.0, 0.0, -1.0};
+};
+
+// Rewrites a raster as .ntr: square tiles stored contiguously so a window
+// read touches a handful of pages instead of one page per scanline.
+bool writeTiledRaster(const Raster& raster, const std::string& path, int tileSize);
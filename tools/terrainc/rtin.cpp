@@ -0,0 +1,151 @@
+#include "tools/terrainc/rtin.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+bool rtinGridSupported(int size) {
+    int cells = size - 1;
+    return cells >= 1 && (cells & (cells - 1)) == 0;
+}
+
+namespace {
+// Largest vertical distance between the samples covered by a triangle and the
+// plane through its corners.
+float triangleError(const std::vector<float>& heights, int size,
+                    int ax, int ay, int bx, int by, int cx, int cy) {
+    long area = static_cast<long>(bx - ax) * (cy - ay) - static_cast<long>(by - ay) * (cx - ax);
+    if (area == 0) {
+        return 0.0f;
+    }
+    float sign = area < 0 ? -1.0f : 1.0f;
+    float invArea = 1.0f / static_cast<float>(area);
+    float ha = heights[static_cast<size_t>(ay) * size + ax];
+    float hb = heights[static_cast<size_t>(by) * size + bx];
+    float hc = heights[static_cast<size_t>(cy) * size + cx];
+    auto edge = [](int x0, int y0, int x1, int y1, int x, int y) {
+        return static_cast<long>(x1 - x0) * (y - y0) - static_cast<long>(y1 - y0) * (x - x0);
+    };
+    float worst = 0.0f;
+    for (int y = std::min({ay, by, cy}); y <= std::max({ay, by, cy}); ++y) {
+        for (int x = std::min({ax, bx, cx}); x <= std::max({ax, bx, cx}); ++x) {
+            long wa = edge(bx, by, cx, cy, x, y);
+            long wb = edge(cx, cy, ax, ay, x, y);
+            long wc = edge(ax, ay, bx, by, x, y);
+            if (sign * wa < 0 || sign * wb < 0 || sign * wc < 0) {
+                continue;
+            }
+            float h = (static_cast<float>(wa) * ha + static_cast<float>(wb) * hb +
+                       static_cast<float>(wc) * hc) * invArea;
+            worst = std::max(worst, std::abs(h - heights[static_cast<size_t>(y) * size + x]));
+        }
+    }
+    return worst;
+}
+} // namespace
+
+// Triangles are numbered as an implicit binary tree: ids 2 and 3 are the two
+// halves of the tile, and the children of id are 2 * id and 2 * id + 1.
+// Walking from the smallest triangles up lets every parent fold in the errors
+// of its children before its own split point is used. A split point carries
+// the worst plane error of both triangles sharing that hypotenuse, so keeping
+// a triangle whole bounds the error of every sample under it.
+void computeRtinErrors(const std::vector<float>& heights, int size, std::vector<float>& errors) {
+    int cells = size - 1;
+    errors.assign(static_cast<size_t>(size) * static_cast<size_t>(size), 0.0f);
+    if (cells < 2) {
+        return;
+    }
+    const float kBorderError = std::numeric_limits<float>::infinity();
+    std::int64_t smallest = static_cast<std::int64_t>(cells) * cells;
+    std::int64_t triangles = smallest * 2 - 2;
+    std::int64_t lastLevel = triangles - smallest;
+
+    for (std::int64_t i = triangles - 1; i >= 0; --i) {
+        std::int64_t id = i + 2;
+        int ax = 0;
+        int ay = 0;
+        int bx = 0;
+        int by = 0;
+        int cx = 0;
+        int cy = 0;
+        if (id & 1) {
+            bx = by = cx = cells;
+        } else {
+            ax = ay = cy = cells;
+        }
+        while ((id >>= 1) > 1) {
+            int mx = (ax + bx) >> 1;
+            int my = (ay + by) >> 1;
+            if (id & 1) {
+                bx = ax;
+                by = ay;
+                ax = cx;
+                ay = cy;
+            } else {
+                ax = bx;
+                ay = by;
+                bx = cx;
+                by = cy;
+            }
+            cx = mx;
+            cy = my;
+        }
+
+        int mx = (ax + bx) >> 1;
+        int my = (ay + by) >> 1;
+        size_t middle = static_cast<size_t>(my) * size + mx;
+        bool border = mx == 0 || my == 0 || mx == cells || my == cells;
+        float error = border ? kBorderError : triangleError(heights, size, ax, ay, bx, by, cx, cy);
+        errors[middle] = std::max(errors[middle], error);
+        if (i < lastLevel) {
+            size_t left = static_cast<size_t>((ay + cy) >> 1) * size + ((ax + cx) >> 1);
+            size_t right = static_cast<size_t>((by + cy) >> 1) * size + ((bx + cx) >> 1);
+            errors[middle] = std::max({errors[middle], errors[left], errors[right]});
+        }
+    }
+}
+
+namespace {
+struct RtinExtractor {
+    const std::vector<float>& errors;
+    int size;
+    float maxError;
+    std::vector<std::uint32_t>& out;
+
+    void emit(int ax, int ay, int bx, int by, int cx, int cy) {
+        // Grid rows run along +z; keep (x, z) counter-clockwise like the uniform grid.
+        long cross = static_cast<long>(bx - ax) * (cy - ay) - static_cast<long>(by - ay) * (cx - ax);
+        if (cross < 0) {
+            std::swap(bx, cx);
+            std::swap(by, cy);
+        }
+        out.push_back(static_cast<std::uint32_t>(ay * size + ax));
+        out.push_back(static_cast<std::uint32_t>(by * size + bx));
+        out.push_back(static_cast<std::uint32_t>(cy * size + cx));
+    }
+
+    // a-b is the hypotenuse, c the right angle.
+    void visit(int ax, int ay, int bx, int by, int cx, int cy) {
+        int mx = (ax + bx) >> 1;
+        int my = (ay + by) >> 1;
+        if (std::abs(ax - cx) + std::abs(ay - cy) > 1 &&
+            errors[static_cast<size_t>(my) * size + mx] > maxError) {
+            visit(cx, cy, ax, ay, mx, my);
+            visit(bx, by, cx, cy, mx, my);
+        } else {
+            emit(ax, ay, bx, by, cx, cy);
+        }
+    }
+};
+} // namespace
+
+void extractRtinTriangles(const std::vector<float>& errors, int size, float maxError,
+                          std::vector<std::uint32_t>& out) {
+    int cells = size - 1;
+    if (cells < 1) {
+        return;
+    }
+    RtinExtractor extractor{errors, size, maxError, out};
+    extractor.visit(0, 0, cells, cells, cells, 0);
+    extractor.visit(cells, cells, 0, 0, 0, cells);
+}
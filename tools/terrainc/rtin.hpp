@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Right-triangulated irregular network over a square height grid of
+// (2^k + 1) x (2^k + 1) samples, stored row-major.
+bool rtinGridSupported(int size);
+
+// Per-vertex error of not splitting at each point: the worst deviation of any
+// sample from the triangles that would be kept, propagated so a vertex's error
+// is never below that of the splits beneath it. Border vertices get an
+// infinite error so every tile keeps its full edge and neighbours line up.
+void computeRtinErrors(const std::vector<float>& heights, int size, std::vector<float>& errors);
+
+// Appends triangles (three grid indices each, same winding as the uniform
+// grid) of the coarsest mesh whose vertical error stays within maxError.
+void extractRtinTriangles(const std::vector<float>& errors, int size, float maxError,
+                          std::vector<std::uint32_t>& out);
@@ -0,0 +1,66 @@
+#include "tools/terrainc/tile_fingerprint.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+void TileFingerprint::addBytes(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t hash = m_hash;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    m_hash = hash;
+}
+
+void TileFingerprint::addString(const std::string& value) {
+    add(static_cast<std::uint64_t>(value.size()));
+    addBytes(value.data(), value.size());
+}
+
+void TileFingerprint::addRasterWindow(const Raster& raster, int x0, int y0, int x1, int y1) {
+    if (!raster.valid()) {
+        add(static_cast<std::int32_t>(-1));
+        return;
+    }
+    x0 = std::clamp(x0, 0, raster.width() - 1);
+    x1 = std::clamp(x1, 0, raster.width() - 1);
+    y0 = std::clamp(y0, 0, raster.height() - 1);
+    y1 = std::clamp(y1, 0, raster.height() - 1);
+    add(static_cast<std::int32_t>(x0));
+    add(static_cast<std::int32_t>(y0));
+    add(static_cast<std::int32_t>(x1));
+    add(static_cast<std::int32_t>(y1));
+
+    std::vector<std::int32_t> row(static_cast<size_t>(x1 - x0 + 1));
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            row[static_cast<size_t>(x - x0)] = raster.at(x, y);
+        }
+        addBytes(row.data(), row.size() * sizeof(std::int32_t));
+    }
+}
+
+std::string TileFingerprint::hex() const {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(m_hash));
+    return std::string(buffer);
+}
+
+bool readTileFingerprint(const std::filesystem::path& path, std::string& out) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return false;
+    }
+    return static_cast<bool>(in >> out);
+}
+
+bool writeTileFingerprint(const std::filesystem::path& path, const std::string& hex) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << hex << "\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "tools/terrainc/raster.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+
+// Incremental FNV-1a 64-bit hash over everything a compiled tile depends on.
+class TileFingerprint {
+public:
+    TileFingerprint() = default;
+    explicit TileFingerprint(std::uint64_t seed) : m_hash(seed) {}
+
+    void addBytes(const void* data, size_t size);
+
+    template<typename T>
+    void add(const T& value) {
+        static_assert(std::is_arithmetic_v<T>, "hash fields explicitly to avoid padding bytes");
+        addBytes(&value, sizeof(T));
+    }
+
+    void addString(const std::string& value);
+
+    // Hashes the samples in [x0, x1] x [y0, y1], clamped to the raster.
+    void addRasterWindow(const Raster& raster, int x0, int y0, int x1, int y1);
+
+    std::uint64_t value() const { return m_hash; }
+    std::string hex() const;
+
+private:
+    std::uint64_t m_hash = 14695981039346656037ULL;
+};
+
+bool readTileFingerprint(const std::filesystem::path& path, std::string& out);
+bool writeTileFingerprint(const std::filesystem::path& path, const std::string& hex);
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "graphics/renderers/terrain/material_fields.hpp"
+#include "utils/xml.hpp"
+
+namespace {
+
+struct SourceFile {
+    std::string path;
+    std::string content;
+};
+
+size_t countNodes(const nuage::XmlNode& node) {
+    size_t count = 1;
+    for (const auto& child : node.children) {
+        count += countNodes(child);
+    }
+    return count;
+}
+
+class CountingHandler : public nuage::XmlSaxHandler {
+public:
+    void startElement(std::string_view, const nuage::XmlAttributeView*, size_t count) override {
+        ++elements;
+        attributes += count;
+    }
+    void text(std::string_view text) override { textBytes += text.size(); }
+
+    size_t elements = 0;
+    size_t attributes = 0;
+    size_t textBytes = 0;
+};
+
+// MaterialLibrary reads material include files through SAX and the rest of
+// the tree through XmlDocument, so both must yield the same fields.
+bool sameMaterialFields(const std::string& content) {
+    nuage::XmlDocument doc;
+    nuage::Material fromTree;
+    if (!doc.parse(content)) {
+        return false;
+    }
+    nuage::collect_material_fields(doc.root(), fromTree);
+
+    nuage::Material streamed;
+    nuage::MaterialFieldCollector collector(streamed);
+    if (!nuage::parseXmlSax(content, collector)) {
+        return false;
+    }
+    return fromTree.names == streamed.names && fromTree.textures == streamed.textures &&
+           fromTree.effect == streamed.effect && fromTree.xsize == streamed.xsize &&
+           fromTree.ysize == streamed.ysize;
+}
+
+// Field text split by a comment and a CDATA section, which the tree joins.
+const char* const kSplitFieldText =
+    "<material><name>grass<!-- x -->land</name><xsize>1<!-- x -->2</xsize>"
+    "<ysize><![CDATA[3]]>4</ysize></material>";
+
+struct Result {
+    double bestMs = 0.0;
+    size_t elements = 0;
+    size_t failures = 0;
+};
+
+template<typename Fn>
+Result runBench(const std::vector<SourceFile>& files, int iterations, Fn&& parseOne) {
+    Result result;
+    result.bestMs = 1e30;
+    for (int it = 0; it < iterations; ++it) {
+        size_t elements = 0;
+        size_t failures = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& file : files) {
+            size_t count = parseOne(file.content);
+            if (count == 0) {
+                ++failures;
+            }
+            elements += count;
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        result.bestMs = std::min(result.bestMs, ms);
+        result.elements = elements;
+        result.failures = failures;
+    }
+    return result;
+}
+
+void printResult(const char* label, const Result& result, const Result& baseline) {
+    std::cout << "  " << label << ": " << result.bestMs << " ms, "
+              << result.elements << " elements";
+    if (result.failures > 0) {
+        std::cout << ", " << result.failures << " failed";
+    }
+    if (&result != &baseline && result.bestMs > 0.0) {
+        std::cout << " (" << (baseline.bestMs / result.bestMs) << "x)";
+    }
+    std::cout << "\n";
+}
+
+void printUsage() {
+    std::cout << "Usage: xml_bench [--root <dir>] [--iterations <n>]\n"
+              << "  Parses every .xml file under root (default assets/terrain/core/Materials)\n"
+              << "  with the DOM, arena and SAX parsers and reports the best time of n runs,\n"
+              << "  then checks that SAX and XmlDocument read the same material fields.\n";
+}
+}
+
+int main(int argc, char** argv) {
+    std::string root = "assets/terrain/core/Materials";
+    int iterations = 20;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&](std::string& out) -> bool {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        if (arg == "--root") {
+            if (!next(root)) return 1;
+        } else if (arg == "--iterations") {
+            std::string v;
+            if (!next(v)) return 1;
+            iterations = std::max(1, std::atoi(v.c_str()));
+        } else {
+            std::cerr << "Unknown arg: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::vector<SourceFile> files;
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file() || it->path().extension() != ".xml") {
+            continue;
+        }
+        std::ifstream in(it->path(), std::ios::binary);
+        if (!in.is_open()) {
+            continue;
+        }
+        SourceFile file;
+        file.path = it->path().string();
+        file.content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        files.push_back(std::move(file));
+    }
+    if (files.empty()) {
+        std::cerr << "No XML files found under " << root << "\n";
+        return 1;
+    }
+    std::sort(files.begin(), files.end(),
+        [](const SourceFile& a, const SourceFile& b) { return a.path < b.path; });
+
+    size_t totalBytes = 0;
+    for (const auto& file : files) {
+        totalBytes += file.content.size();
+    }
+    std::cout << "[xml_bench] " << files.size() << " files, " << totalBytes << " bytes, best of "
+              << iterations << " runs\n";
+
+    Result dom = runBench(files, iterations, [](const std::string& content) -> size_t {
+        auto node = nuage::parseXml(content);
+        return node ? countNodes(*node) : 0;
+    });
+    Result arena = runBench(files, iterations, [](const std::string& content) -> size_t {
+        nuage::XmlDocument doc;
+        return doc.parse(content) ? doc.elementCount() : 0;
+    });
+    Result sax = runBench(files, iterations, [](const std::string& content) -> size_t {
+        CountingHandler handler;
+        return nuage::parseXmlSax(content, handler) ? handler.elements : 0;
+    });
+
+    printResult("XmlNode DOM  ", dom, dom);
+    printResult("XmlDocument  ", arena, dom);
+    printResult("SAX          ", sax, dom);
+
+    if (dom.elements != arena.elements || dom.elements != sax.elements) {
+        std::cerr << "[xml_bench] element counts differ between parsers\n";
+        return 1;
+    }
+
+    bool fieldsMatch = sameMaterialFields(kSplitFieldText);
+    if (!fieldsMatch) {
+        std::cerr << "[xml_bench] material fields differ for split field text\n";
+    }
+    for (const auto& file : files) {
+        if (!sameMaterialFields(file.content)) {
+            std::cerr << "[xml_bench] material fields differ between SAX and XmlDocument: " << file.path << "\n";
+            fieldsMatch = false;
+        }
+    }
+    if (!fieldsMatch) {
+        return 1;
+    }
+    std::cout << "  material fields match between SAX and XmlDocument\n";
+    return 0;
+}